@@ -0,0 +1,167 @@
+/**
+ * @file        ao_adaptive_timeout.c
+ * @brief       Per-transaction lockup timeout from transfer size and observed latency
+ * @details     Every call is constant time: one histogram bin per sample, and a
+ *              walk over AO_ADAPTIVE_TIMEOUT_BINS bins per timeout.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ao_adaptive_timeout.h"
+
+// Bits on the wire: start, stop and ACKs included
+#define AO_ADAPTIVE_TIMEOUT_BITS_PER_BYTE   9u
+#define AO_ADAPTIVE_TIMEOUT_FRAMING_BITS    2u
+
+#define AO_ADAPTIVE_TIMEOUT_US_PER_SEC      1000000u
+#define AO_ADAPTIVE_TIMEOUT_US_PER_MS       1000u
+
+// Private functions
+static uint32_t ao_adaptive_timeout_p99_us(ao_adaptive_timeout_t const * const me);
+
+/**
+*   @brief      Upper bound of the bin holding the 99th percentile of the overhead
+*/
+static uint32_t ao_adaptive_timeout_p99_us(ao_adaptive_timeout_t const * const me)
+{
+    // Samples allowed above the percentile
+    uint32_t const above = me->n_samples / 100u;
+    uint32_t seen = 0u;
+
+    for (uint32_t b = AO_ADAPTIVE_TIMEOUT_BINS; b-- > 0u; )
+    {
+        seen += me->histogram[b];
+
+        if (seen > above)
+        {
+            return (2u << b) - 1u;
+        }
+    }
+
+    return 0u;
+}
+
+/**
+*   @brief      Reset the statistics and set the bus parameters
+*   @param[in]  me          - timeout state
+*   @param[in]  bus_hz      - I2C clock
+*   @param[in]  min_ms      - shortest timeout
+*   @param[in]  max_ms      - longest timeout, used until the statistics are ready
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_adaptive_timeout_init(ao_adaptive_timeout_t * const me, uint32_t bus_hz, uint32_t min_ms, uint32_t max_ms)
+{
+    memset(me, 0, sizeof(*me));
+
+    me->bus_hz = bus_hz;
+    me->min_ms = min_ms;
+    me->max_ms = max_ms;
+}
+
+/**
+*   @brief      Time a transfer takes on the wire
+*   @param[in]  me          - timeout state
+*   @param[in]  reg_addr    - a register address byte follows the device address
+*   @param[in]  send_len    - bytes written
+*   @param[in]  rec_len     - bytes read, after a repeated start
+*   @param[out] nothing
+*   @return     uint32_t    - wire time, us
+*/
+uint32_t ao_adaptive_timeout_wire_us(ao_adaptive_timeout_t const * const me, bool reg_addr,
+                                     uint32_t send_len, uint32_t rec_len)
+{
+    uint32_t bits = AO_ADAPTIVE_TIMEOUT_FRAMING_BITS + AO_ADAPTIVE_TIMEOUT_BITS_PER_BYTE;
+
+    if (reg_addr)
+    {
+        bits += AO_ADAPTIVE_TIMEOUT_BITS_PER_BYTE;
+    }
+    if (rec_len > 0u)
+    {
+        // Repeated start and address for the read phase
+        bits += 1u + AO_ADAPTIVE_TIMEOUT_BITS_PER_BYTE;
+    }
+
+    bits += (send_len + rec_len) * AO_ADAPTIVE_TIMEOUT_BITS_PER_BYTE;
+
+    return (uint32_t)((((uint64_t)bits * AO_ADAPTIVE_TIMEOUT_US_PER_SEC) + me->bus_hz - 1u) / me->bus_hz);
+}
+
+/**
+*   @brief      Account for one completed transfer
+*   @param[in]  me          - timeout state
+*   @param[in]  wire_us     - wire time of the transfer
+*   @param[in]  elapsed_us  - request to completion
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_adaptive_timeout_observe(ao_adaptive_timeout_t * const me, uint32_t wire_us, uint32_t elapsed_us)
+{
+    uint32_t const overhead = (elapsed_us > wire_us) ? (elapsed_us - wire_us) : 0u;
+    uint32_t bin = 0u;
+
+    while (((overhead >> (bin + 1u)) != 0u) && (bin < (AO_ADAPTIVE_TIMEOUT_BINS - 1u)))
+    {
+        bin++;
+    }
+
+    if (me->n_samples >= AO_ADAPTIVE_TIMEOUT_WINDOW)
+    {
+        me->n_samples = 0u;
+
+        for (uint32_t b = 0u; b < AO_ADAPTIVE_TIMEOUT_BINS; b++)
+        {
+            me->histogram[b] /= 2u;
+            me->n_samples    += me->histogram[b];
+        }
+    }
+
+    me->histogram[bin]++;
+    me->n_samples++;
+}
+
+/**
+*   @brief      Lockup timeout for one attempt of a transfer
+*   @param[in]  me          - timeout state
+*   @param[in]  wire_us     - wire time of the transfer
+*   @param[out] nothing
+*   @return     uint32_t    - timeout, ms
+*/
+uint32_t ao_adaptive_timeout_ms(ao_adaptive_timeout_t const * const me, uint32_t wire_us)
+{
+    // One extra ms for the phase of the tick the timer is armed in
+    uint32_t const wire_ms = ((AO_ADAPTIVE_TIMEOUT_MARGIN * wire_us) + AO_ADAPTIVE_TIMEOUT_US_PER_MS - 1u) /
+                             AO_ADAPTIVE_TIMEOUT_US_PER_MS + 1u;
+    uint32_t ms = me->max_ms;
+
+    if (me->n_samples >= AO_ADAPTIVE_TIMEOUT_MIN_SAMPLES)
+    {
+        uint32_t const expected_us = wire_us + ao_adaptive_timeout_p99_us(me);
+
+        ms = ((AO_ADAPTIVE_TIMEOUT_MARGIN * expected_us) + AO_ADAPTIVE_TIMEOUT_US_PER_MS - 1u) /
+             AO_ADAPTIVE_TIMEOUT_US_PER_MS + 1u;
+    }
+
+    // A long transfer gets the time it needs on the wire even beyond max_ms
+    if (ms > me->max_ms)
+    {
+        ms = (wire_ms > me->max_ms) ? wire_ms : me->max_ms;
+    }
+    if (ms < wire_ms)
+    {
+        ms = wire_ms;
+    }
+    if (ms < me->min_ms)
+    {
+        ms = me->min_ms;
+    }
+
+    return ms;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file        ao_adaptive_timeout.h
+ * @brief       Per-transaction lockup timeout from transfer size and observed latency
+ * @details     The timeout of a transfer is its wire time at the configured bus
+ *              speed plus the 99th percentile of the overhead seen on recent
+ *              completions (driver, queueing and ISR latency on top of the wire
+ *              time), both times AO_ADAPTIVE_TIMEOUT_MARGIN. The overhead is kept
+ *              in a log2 histogram that is halved every AO_ADAPTIVE_TIMEOUT_WINDOW
+ *              samples, so it follows changes of the bus.
+ *
+ *              Until AO_ADAPTIVE_TIMEOUT_MIN_SAMPLES completions have been seen
+ *              the maximum timeout is used.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_ADAPTIVE_TIMEOUT_H
+#define AO_ADAPTIVE_TIMEOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Overhead histogram bins, bin b counts overheads in [2^b, 2^(b+1)) us
+#define AO_ADAPTIVE_TIMEOUT_BINS            16u
+
+// Samples between two halvings of the histogram
+#define AO_ADAPTIVE_TIMEOUT_WINDOW          128u
+
+// Completions needed before the timeout adapts
+#define AO_ADAPTIVE_TIMEOUT_MIN_SAMPLES     16u
+
+// Safety factor on the expected completion time
+#define AO_ADAPTIVE_TIMEOUT_MARGIN          2u
+
+/*! @struct ao_adaptive_timeout_t
+*   @brief  Bus parameters and overhead statistics of one device
+*/
+typedef struct
+{
+    uint32_t                bus_hz;                             /**< I2C clock >*/
+    uint32_t                min_ms;                             /**< Shortest timeout >*/
+    uint32_t                max_ms;                             /**< Longest timeout, unless the wire time needs more >*/
+    uint16_t                n_samples;                          /**< Samples in the histogram >*/
+    uint16_t                histogram[AO_ADAPTIVE_TIMEOUT_BINS];
+} ao_adaptive_timeout_t;
+
+void ao_adaptive_timeout_init(ao_adaptive_timeout_t * const me, uint32_t bus_hz, uint32_t min_ms, uint32_t max_ms);
+
+uint32_t ao_adaptive_timeout_wire_us(ao_adaptive_timeout_t const * const me, bool reg_addr,
+                                     uint32_t send_len, uint32_t rec_len);
+
+void ao_adaptive_timeout_observe(ao_adaptive_timeout_t * const me, uint32_t wire_us, uint32_t elapsed_us);
+
+uint32_t ao_adaptive_timeout_ms(ao_adaptive_timeout_t const * const me, uint32_t wire_us);
+
+#endif
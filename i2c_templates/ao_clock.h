@@ -0,0 +1,42 @@
+/**
+ * @file        ao_clock.h
+ * @brief       Monotonic timestamp source for driver instrumentation
+ * @details     All of the driver telemetry (duty cycle, dwell times, latency
+ *              statistics) is timestamped through AO_CLOCK_NOW() so that a host
+ *              build can substitute a virtual clock for the hardware timer.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_CLOCK_H
+#define AO_CLOCK_H
+
+// Needed for timer_count_t and timer_get_count()
+#include "timer.h"
+
+/**
+    @brief Current time in timer counts.
+    Counts are assumed to be monotonic and to wrap around, so durations must
+    always be computed with unsigned subtraction.
+*/
+#ifndef AO_CLOCK_NOW
+#define AO_CLOCK_NOW()                  timer_get_count()
+#endif
+
+/**
+    @brief Number of timer counts in one millisecond.
+    Used to convert durations into milliseconds for histograms and windows.
+*/
+#ifndef AO_CLOCK_COUNTS_PER_MS
+#define AO_CLOCK_COUNTS_PER_MS          1u
+#endif
+
+#define AO_CLOCK_MS_TO_COUNTS(ms)       ((timer_count_t)((ms) * AO_CLOCK_COUNTS_PER_MS))
+#define AO_CLOCK_COUNTS_TO_MS(counts)   ((uint32_t)((counts) / AO_CLOCK_COUNTS_PER_MS))
+#define AO_CLOCK_COUNTS_TO_US(counts)   ((uint32_t)(((uint64_t)(counts) * 1000u) / AO_CLOCK_COUNTS_PER_MS))
+
+#endif
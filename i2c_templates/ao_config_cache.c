@@ -0,0 +1,95 @@
+/**
+ * @file        ao_config_cache.c
+ * @brief       Copy of the configuration written to a device
+ * @details     Entries keep the order of the first write to their register, so a
+ *              replay sets the device up in the order the driver did.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ao_config_cache.h"
+
+/**
+*   @brief      Empty the cache
+*   @param[in]  cache       - pointer to the cache
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_config_cache_init(ao_config_cache_t * const cache)
+{
+    memset(cache, 0, sizeof(*cache));
+}
+
+/**
+*   @brief      Remember a completed configuration write
+*   @param[in]  cache       - pointer to the cache
+*   @param[in]  reg         - register written
+*   @param[in]  data        - bytes written, copied
+*   @param[in]  length      - number of bytes
+*   @param[out] nothing
+*   @return     bool        - false if the write could not be cached
+*/
+bool ao_config_cache_store(ao_config_cache_t * const cache, uint16_t reg, uint8_t const * const data,
+                           uint16_t length)
+{
+    ao_config_cache_entry_t * entry = NULL;
+
+    if ((length == 0u) || (length > AO_CONFIG_CACHE_MAX_LEN) || (data == NULL))
+    {
+        cache->skipped++;
+        return false;
+    }
+
+    for (uint8_t i = 0u; i < cache->count; i++)
+    {
+        if (cache->entries[i].reg == reg)
+        {
+            entry = &cache->entries[i];
+            break;
+        }
+    }
+
+    if (entry == NULL)
+    {
+        if (cache->count >= AO_CONFIG_CACHE_ENTRIES)
+        {
+            cache->skipped++;
+            return false;
+        }
+
+        entry = &cache->entries[cache->count++];
+        entry->reg = reg;
+    }
+
+    entry->length = length;
+    memcpy(entry->data, data, length);
+
+    return true;
+}
+
+/**
+*   @brief      Entry by position, in the order registers were first written
+*   @param[in]  cache       - pointer to the cache
+*   @param[in]  index       - position
+*   @param[out] nothing
+*   @return     ao_config_cache_entry_t const * - entry, NULL past the end
+*/
+ao_config_cache_entry_t const * ao_config_cache_get(ao_config_cache_t const * const cache, uint8_t index)
+{
+    return (index < cache->count) ? &cache->entries[index] : NULL;
+}
+
+/**
+*   @brief      True if data read back from the device equals the cached value
+*   @details    data holds entry->length bytes.
+*/
+bool ao_config_cache_matches(ao_config_cache_entry_t const * const entry, uint8_t const * const data)
+{
+    return memcmp(entry->data, data, entry->length) == 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file        ao_config_cache.h
+ * @brief       Copy of the configuration written to a device
+ * @details     A driver stores every configuration write that completed. After a
+ *              warm restart the device may have lost its registers; the driver
+ *              reads back the first cached register and, if it differs from the
+ *              copy, writes the cached entries again in the order they were first
+ *              written.
+ *
+ *              Writes longer than AO_CONFIG_CACHE_MAX_LEN bytes are not cached,
+ *              and writes to a new register once the cache is full are dropped.
+ *              Both are counted in skipped, a replay then cannot restore them.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_CONFIG_CACHE_H
+#define AO_CONFIG_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Registers remembered
+#ifndef AO_CONFIG_CACHE_ENTRIES
+#define AO_CONFIG_CACHE_ENTRIES         8u
+#endif
+
+// Longest cached write
+#define AO_CONFIG_CACHE_MAX_LEN         4u
+
+/*! @struct ao_config_cache_entry_t
+*   @brief  Last value written to one register
+*/
+typedef struct
+{
+    uint16_t                reg;
+    uint16_t                length;
+    uint8_t                 data[AO_CONFIG_CACHE_MAX_LEN];
+} ao_config_cache_entry_t;
+
+/*! @struct ao_config_cache_t
+*   @brief  Per-device configuration cache
+*/
+typedef struct
+{
+    ao_config_cache_entry_t entries[AO_CONFIG_CACHE_ENTRIES];
+    uint8_t                 count;                              /**< Entries in use >*/
+    uint32_t                skipped;                            /**< Writes that could not be cached >*/
+} ao_config_cache_t;
+
+void ao_config_cache_init(ao_config_cache_t * const cache);
+
+bool ao_config_cache_store(ao_config_cache_t * const cache, uint16_t reg, uint8_t const * const data,
+                           uint16_t length);
+
+ao_config_cache_entry_t const * ao_config_cache_get(ao_config_cache_t const * const cache, uint8_t index);
+
+bool ao_config_cache_matches(ao_config_cache_entry_t const * const entry, uint8_t const * const data);
+
+#endif
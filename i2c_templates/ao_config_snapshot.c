@@ -0,0 +1,73 @@
+/**
+ * @file        ao_config_snapshot.c
+ * @brief       Configuration of a device packed for a one burst restore
+ * @details     Runs are only merged in write order, a restore never reorders
+ *              the configuration.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ao_config_snapshot.h"
+
+/**
+*   @brief      Pack the cached configuration into write runs
+*   @param[in]  snapshot        - pointer to the snapshot, overwritten
+*   @param[in]  cache           - configuration cache of the driver
+*   @param[in]  auto_increment  - the device advances the register address on
+*                                 each byte, so adjacent registers can share a run
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_config_snapshot_take(ao_config_snapshot_t * const snapshot, ao_config_cache_t const * const cache,
+                             bool auto_increment)
+{
+    uint8_t used = 0u;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    for (uint8_t i = 0u; i < cache->count; i++)
+    {
+        ao_config_cache_entry_t const * const entry = ao_config_cache_get(cache, i);
+        ao_config_snapshot_run_t * run = NULL;
+
+        if (snapshot->n_runs > 0u)
+        {
+            ao_config_snapshot_run_t * const last = &snapshot->runs[snapshot->n_runs - 1u];
+
+            if (auto_increment && (entry->reg == (uint16_t)(last->reg + last->length)))
+            {
+                run = last;
+            }
+        }
+
+        if (run == NULL)
+        {
+            run = &snapshot->runs[snapshot->n_runs++];
+            run->reg = entry->reg;
+            run->offset = used;
+        }
+
+        memcpy(&snapshot->data[used], entry->data, entry->length);
+        run->length = (uint8_t)(run->length + entry->length);
+        used = (uint8_t)(used + entry->length);
+        snapshot->n_registers++;
+    }
+}
+
+/**
+*   @brief      Run by position, in restore order
+*   @param[in]  snapshot    - pointer to the snapshot
+*   @param[in]  index       - position
+*   @param[out] nothing
+*   @return     ao_config_snapshot_run_t const * - run, NULL past the end
+*/
+ao_config_snapshot_run_t const * ao_config_snapshot_get(ao_config_snapshot_t const * const snapshot, uint8_t index)
+{
+    return (index < snapshot->n_runs) ? &snapshot->runs[index] : NULL;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file        ao_config_snapshot.h
+ * @brief       Configuration of a device packed for a one burst restore
+ * @details     Taken from ao_config_cache.h when a driver suspends, so the work
+ *              is done before the device sleeps and not on the wake-up path.
+ *              Cache entries are kept in the order they were first written;
+ *              when the device auto-increments its register address, an entry
+ *              that starts where the previous one ended is appended to it, and
+ *              the pair is written as one transfer.
+ *
+ *              Each run is one write transfer: reg, then length bytes at
+ *              data + offset.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_CONFIG_SNAPSHOT_H
+#define AO_CONFIG_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ao_config_cache.h"
+
+// Every cached byte fits, whatever the runs
+#define AO_CONFIG_SNAPSHOT_BYTES        (AO_CONFIG_CACHE_ENTRIES * AO_CONFIG_CACHE_MAX_LEN)
+
+/*! @struct ao_config_snapshot_run_t
+*   @brief  Registers restored by one write transfer
+*/
+typedef struct
+{
+    uint16_t                reg;                                /**< First register of the run >*/
+    uint8_t                 offset;                             /**< Start of the run in data >*/
+    uint8_t                 length;
+} ao_config_snapshot_run_t;
+
+/*! @struct ao_config_snapshot_t
+*   @brief  Packed copy of a configuration cache
+*/
+typedef struct
+{
+    ao_config_snapshot_run_t    runs[AO_CONFIG_CACHE_ENTRIES];
+    uint8_t                     data[AO_CONFIG_SNAPSHOT_BYTES];
+    uint8_t                     n_runs;
+    uint8_t                     n_registers;                    /**< Cache entries packed into the runs >*/
+} ao_config_snapshot_t;
+
+void ao_config_snapshot_take(ao_config_snapshot_t * const snapshot, ao_config_cache_t const * const cache,
+                             bool auto_increment);
+
+ao_config_snapshot_run_t const * ao_config_snapshot_get(ao_config_snapshot_t const * const snapshot, uint8_t index);
+
+#endif
@@ -0,0 +1,311 @@
+/**
+ * @file        ao_duty_cycle.c
+ * @brief       Duty cycle instrumentation layered on top of ao_timings
+ * @details     All functions that modify the duty cycle state must be called
+ *              from the context of the owning active object. The read-only
+ *              queries may be called from any context; they report the sliding
+ *              windows as of the last busy/idle transition or update.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_duty_cycle.h"
+#include "driver_qs_records.h"
+
+// Private functions
+static void ao_duty_cycle_window_init(ao_duty_cycle_window_t * const w, timer_count_t * const busy,
+                                      uint8_t n_slots, uint32_t slot_ms, timer_count_t now);
+
+static void ao_duty_cycle_window_advance(ao_duty_cycle_window_t * const w, timer_count_t from,
+                                         timer_count_t now, bool busy);
+
+static uint16_t ao_duty_cycle_window_permille(ao_duty_cycle_window_t const * const w,
+                                              timer_count_t now);
+
+static uint8_t ao_duty_cycle_hist_bin(timer_count_t period);
+
+/**
+*   @brief      Reset the duty cycle state
+*   @param[in]  dc          - pointer to the duty cycle state
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_duty_cycle_init(ao_duty_cycle_t * const dc)
+{
+    timer_count_t now = AO_CLOCK_NOW();
+
+    memset(dc, 0, sizeof(*dc));
+
+    dc->last_update = now;
+    ao_duty_cycle_window_init(&dc->short_window, dc->short_busy, AO_DUTY_CYCLE_SHORT_SLOTS,
+                              AO_DUTY_CYCLE_SHORT_SLOT_MS, now);
+    ao_duty_cycle_window_init(&dc->long_window, dc->long_busy, AO_DUTY_CYCLE_LONG_SLOTS,
+                              AO_DUTY_CYCLE_LONG_SLOT_MS, now);
+}
+
+/**
+*   @brief      Mark the AO busy
+*   @details    Forwards to ao_set_busy() and opens a busy period. Repeated calls
+*               while already busy are ignored, so nested busy states are counted
+*               as a single period.
+*   @param[in]  dc          - pointer to the duty cycle state
+*   @param[in]  timings     - pointer to the AO timing data
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_duty_cycle_set_busy(ao_duty_cycle_t * const dc, ao_timings_t * const timings)
+{
+    ao_set_busy(timings);
+
+    if (!dc->busy)
+    {
+        ao_duty_cycle_update(dc);
+
+        dc->busy       = true;
+        dc->busy_start = dc->last_update;
+    }
+}
+
+/**
+*   @brief      Mark the AO idle
+*   @details    Forwards to ao_set_idle() and closes the current busy period, if any.
+*   @param[in]  dc          - pointer to the duty cycle state
+*   @param[in]  timings     - pointer to the AO timing data
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_duty_cycle_set_idle(ao_duty_cycle_t * const dc, ao_timings_t * const timings)
+{
+    ao_set_idle(timings);
+
+    if (dc->busy)
+    {
+        ao_duty_cycle_update(dc);
+
+        timer_count_t period = dc->last_update - dc->busy_start;
+
+        dc->busy        = false;
+        dc->busy_total += period;
+        dc->n_busy_periods++;
+        dc->histogram[ao_duty_cycle_hist_bin(period)]++;
+
+        if (period > dc->longest_busy)
+        {
+            dc->longest_busy = period;
+        }
+    }
+}
+
+/**
+*   @brief      Bring the sliding windows up to the current time
+*   @param[in]  dc          - pointer to the duty cycle state
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_duty_cycle_update(ao_duty_cycle_t * const dc)
+{
+    timer_count_t now = AO_CLOCK_NOW();
+
+    ao_duty_cycle_window_advance(&dc->short_window, dc->last_update, now, dc->busy);
+    ao_duty_cycle_window_advance(&dc->long_window, dc->last_update, now, dc->busy);
+
+    dc->last_update = now;
+}
+
+/**
+*   @brief      Returns true while the AO is in a busy period
+*/
+bool ao_duty_cycle_is_busy(ao_duty_cycle_t const * const dc)
+{
+    return dc->busy;
+}
+
+/**
+*   @brief      Total busy time in timer counts, including the current busy period
+*/
+timer_count_t ao_duty_cycle_get_active_counts(ao_duty_cycle_t const * const dc)
+{
+    uint64_t total = dc->busy_total;
+
+    if (dc->busy)
+    {
+        total += (timer_count_t)(AO_CLOCK_NOW() - dc->busy_start);
+    }
+
+    return (timer_count_t)total;
+}
+
+/**
+*   @brief      Fill in a snapshot of the duty cycle state
+*   @param[in]  dc          - pointer to the duty cycle state
+*   @param[out] report      - snapshot to fill in
+*   @return     nothing
+*/
+void ao_duty_cycle_get_report(ao_duty_cycle_t const * const dc, ao_duty_cycle_report_t * const report)
+{
+    timer_count_t now = AO_CLOCK_NOW();
+
+    report->busy            = dc->busy;
+    report->current_busy    = dc->busy ? (timer_count_t)(now - dc->busy_start) : 0u;
+    report->busy_total      = dc->busy_total + report->current_busy;
+    report->longest_busy    = (report->current_busy > dc->longest_busy) ? report->current_busy : dc->longest_busy;
+    report->n_busy_periods  = dc->n_busy_periods;
+    report->short_permille  = ao_duty_cycle_window_permille(&dc->short_window, dc->last_update);
+    report->long_permille   = ao_duty_cycle_window_permille(&dc->long_window, dc->last_update);
+
+    memcpy(report->histogram, dc->histogram, sizeof(report->histogram));
+}
+
+/**
+*   @brief      Export the duty cycle state through QS user records
+*   @param[in]  dc          - pointer to the duty cycle state
+*   @param[in]  qs_id       - QS id (AO priority) the records are attributed to
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_duty_cycle_qs_dump(ao_duty_cycle_t * const dc, uint8_t qs_id)
+{
+    ao_duty_cycle_report_t report;
+
+    (void)qs_id;    // unused when QS is disabled
+
+    ao_duty_cycle_update(dc);
+    ao_duty_cycle_get_report(dc, &report);
+
+    QS_BEGIN_ID(DRIVER_QS_DUTY_CYCLE, qs_id)
+        QS_U8(0, report.busy);
+        QS_U32(0, AO_CLOCK_COUNTS_TO_MS(report.busy_total));
+        QS_U32(0, AO_CLOCK_COUNTS_TO_MS(report.longest_busy));
+        QS_U32(0, report.n_busy_periods);
+        QS_U16(0, report.short_permille);
+        QS_U16(0, report.long_permille);
+    QS_END()
+
+    for (uint8_t bin = 0u; bin < AO_DUTY_CYCLE_HIST_BINS; bin++)
+    {
+        QS_BEGIN_ID(DRIVER_QS_DUTY_CYCLE_HIST, qs_id)
+            QS_U8(0, bin);
+            QS_U32(0, report.histogram[bin]);
+        QS_END()
+    }
+}
+
+/**
+*   @brief      Reset a sliding window
+*   @param[in]  busy        - storage for n_slots slots
+*/
+static void ao_duty_cycle_window_init(ao_duty_cycle_window_t * const w, timer_count_t * const busy,
+                                      uint8_t n_slots, uint32_t slot_ms, timer_count_t now)
+{
+    memset(w, 0, sizeof(*w));
+    memset(busy, 0, n_slots * sizeof(busy[0]));
+
+    w->busy       = busy;
+    w->slot_len   = AO_CLOCK_MS_TO_COUNTS(slot_ms);
+    w->head_start = now;
+    w->n_slots    = n_slots;
+}
+
+/**
+*   @brief      Attribute the interval [from, now) to the window slots
+*   @details    The cost is bounded by the number of slots: if the window has rolled
+*               over completely, every slot is filled in one pass.
+*   @param[in]  w           - pointer to the window
+*   @param[in]  from        - start of the interval, never before the head slot start
+*   @param[in]  now         - end of the interval
+*   @param[in]  busy        - whether the AO was busy for the whole interval
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void ao_duty_cycle_window_advance(ao_duty_cycle_window_t * const w, timer_count_t from,
+                                         timer_count_t now, bool busy)
+{
+    uint32_t elapsed_slots = (uint32_t)((timer_count_t)(now - w->head_start) / w->slot_len);
+
+    if (elapsed_slots > w->n_slots)
+    {
+        // The whole window has rolled over without a state change
+        for (uint8_t i = 0u; i < w->n_slots; i++)
+        {
+            w->busy[i] = busy ? w->slot_len : 0u;
+        }
+
+        w->head_start += (timer_count_t)(elapsed_slots * w->slot_len);
+        w->head        = (uint8_t)((w->head + elapsed_slots) % w->n_slots);
+        w->busy[w->head] = 0u;
+
+        from          = w->head_start;
+        elapsed_slots = 0u;
+    }
+
+    for (; elapsed_slots > 0u; elapsed_slots--)
+    {
+        timer_count_t slot_end = w->head_start + w->slot_len;
+
+        if (busy)
+        {
+            w->busy[w->head] += (timer_count_t)(slot_end - from);
+        }
+
+        from          = slot_end;
+        w->head_start = slot_end;
+        w->head       = (uint8_t)((w->head + 1u) % w->n_slots);
+        w->busy[w->head] = 0u;
+    }
+
+    if (busy)
+    {
+        w->busy[w->head] += (timer_count_t)(now - from);
+    }
+}
+
+/**
+*   @brief      Utilization of a window in permille
+*   @param[in]  w           - pointer to the window
+*   @param[in]  now         - time the window was last advanced to
+*   @return     uint16_t    - busy time over window length, 0..1000
+*/
+static uint16_t ao_duty_cycle_window_permille(ao_duty_cycle_window_t const * const w,
+                                              timer_count_t now)
+{
+    uint64_t busy   = 0u;
+    uint64_t length = ((uint64_t)(w->n_slots - 1u) * w->slot_len) + (timer_count_t)(now - w->head_start);
+
+    for (uint8_t i = 0u; i < w->n_slots; i++)
+    {
+        busy += w->busy[i];
+    }
+
+    if (length == 0u)
+    {
+        return 0u;
+    }
+
+    return (uint16_t)((busy * 1000u) / length);
+}
+
+/**
+*   @brief      Histogram bin for a busy period
+*   @param[in]  period      - busy period length in timer counts
+*   @return     uint8_t     - bin index, see AO_DUTY_CYCLE_HIST_BINS
+*/
+static uint8_t ao_duty_cycle_hist_bin(timer_count_t period)
+{
+    uint32_t period_ms = AO_CLOCK_COUNTS_TO_MS(period);
+    uint8_t  bin       = 0u;
+
+    while ((period_ms > 0u) && (bin < (AO_DUTY_CYCLE_HIST_BINS - 1u)))
+    {
+        period_ms >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file        ao_duty_cycle.h
+ * @brief       Duty cycle instrumentation layered on top of ao_timings
+ * @details     Every call to ao_set_busy()/ao_set_idle() in a driver is routed
+ *              through ao_duty_cycle_set_busy()/ao_duty_cycle_set_idle(), which
+ *              additionally track:
+ *
+ *              - accumulated busy time
+ *              - a histogram of busy period lengths
+ *              - the longest busy stretch
+ *              - utilization over a short and a long sliding window
+ *
+ *              This is what tells us which driver keeps the MCU awake.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_DUTY_CYCLE_H
+#define AO_DUTY_CYCLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ao_timings.h"
+#include "ao_clock.h"
+
+/**
+    @brief Number of busy period histogram bins.
+    Bin 0 holds periods shorter than 1ms, bin n holds periods in [2^(n-1), 2^n) ms
+    and the last bin holds everything longer.
+*/
+#define AO_DUTY_CYCLE_HIST_BINS         12u
+
+// Short sliding window: 10 slots of 100ms
+#define AO_DUTY_CYCLE_SHORT_SLOTS       10u
+#define AO_DUTY_CYCLE_SHORT_SLOT_MS     100u
+
+// Long sliding window: 60 slots of 1s
+#define AO_DUTY_CYCLE_LONG_SLOTS        60u
+#define AO_DUTY_CYCLE_LONG_SLOT_MS      1000u
+
+/*! @struct ao_duty_cycle_window_t
+*   @brief  Ring of fixed length time slots holding busy time per slot
+*   @details The slots are stored in ao_duty_cycle_t, sized for each window.
+*/
+typedef struct
+{
+    timer_count_t           slot_len;                           /**< Slot length in timer counts >*/
+    timer_count_t           head_start;                         /**< Start time of the current slot >*/
+    uint8_t                 n_slots;                            /**< Number of slots in use >*/
+    uint8_t                 head;                               /**< Index of the current slot >*/
+    timer_count_t *         busy;                               /**< Busy counts per slot, n_slots of them >*/
+} ao_duty_cycle_window_t;
+
+/*! @struct ao_duty_cycle_t
+*   @brief  Duty cycle state for one active object
+*/
+typedef struct
+{
+    bool                    busy;                               /**< Currently in a busy period >*/
+    timer_count_t           busy_start;                         /**< Start of the current busy period >*/
+    timer_count_t           last_update;                        /**< Time the windows were last advanced >*/
+    uint64_t                busy_total;                         /**< Busy counts of all completed periods >*/
+    timer_count_t           longest_busy;                       /**< Longest completed busy period >*/
+    uint32_t                n_busy_periods;                     /**< Number of completed busy periods >*/
+    uint32_t                histogram[AO_DUTY_CYCLE_HIST_BINS]; /**< Busy period length histogram >*/
+    ao_duty_cycle_window_t  short_window;                       /**< Short utilization window >*/
+    ao_duty_cycle_window_t  long_window;                        /**< Long utilization window >*/
+    timer_count_t           short_busy[AO_DUTY_CYCLE_SHORT_SLOTS];  /**< Slots of the short window >*/
+    timer_count_t           long_busy[AO_DUTY_CYCLE_LONG_SLOTS];    /**< Slots of the long window >*/
+} ao_duty_cycle_t;
+
+/*! @struct ao_duty_cycle_report_t
+*   @brief  Exported snapshot of the duty cycle state
+*/
+typedef struct
+{
+    bool                    busy;                               /**< Currently in a busy period >*/
+    uint64_t                busy_total;                         /**< Busy counts, including the current period >*/
+    timer_count_t           current_busy;                       /**< Length of the current busy period >*/
+    timer_count_t           longest_busy;                       /**< Longest busy period, including the current one >*/
+    uint32_t                n_busy_periods;                     /**< Number of completed busy periods >*/
+    uint16_t                short_permille;                     /**< Utilization over the short window >*/
+    uint16_t                long_permille;                      /**< Utilization over the long window >*/
+    uint32_t                histogram[AO_DUTY_CYCLE_HIST_BINS]; /**< Busy period length histogram >*/
+} ao_duty_cycle_report_t;
+
+void ao_duty_cycle_init(ao_duty_cycle_t * const dc);
+
+void ao_duty_cycle_set_busy(ao_duty_cycle_t * const dc, ao_timings_t * const timings);
+
+void ao_duty_cycle_set_idle(ao_duty_cycle_t * const dc, ao_timings_t * const timings);
+
+void ao_duty_cycle_update(ao_duty_cycle_t * const dc);
+
+bool ao_duty_cycle_is_busy(ao_duty_cycle_t const * const dc);
+
+timer_count_t ao_duty_cycle_get_active_counts(ao_duty_cycle_t const * const dc);
+
+void ao_duty_cycle_get_report(ao_duty_cycle_t const * const dc, ao_duty_cycle_report_t * const report);
+
+void ao_duty_cycle_qs_dump(ao_duty_cycle_t * const dc, uint8_t qs_id);
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file        ao_error_agg.c
+ * @brief       Aggregation of repeated error reports
+ * @details     Windows are timestamped with AO_CLOCK_NOW(); the owner's timer only
+ *              decides when closed windows are collected.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_error_agg.h"
+
+// Private functions
+static bool ao_error_agg_is_open(ao_error_agg_slot_t const * const slot, timer_count_t now);
+
+static whoop_error_severity_t ao_error_agg_severity(ao_error_agg_slot_t const * const slot);
+
+/**
+*   @brief      True while the window of a slot is running
+*/
+static bool ao_error_agg_is_open(ao_error_agg_slot_t const * const slot, timer_count_t now)
+{
+    return (slot->count > 0u) &&
+           ((timer_count_t)(now - slot->window_start) < AO_CLOCK_MS_TO_COUNTS(AO_ERROR_AGG_WINDOW_MS));
+}
+
+/**
+*   @brief      Severity of a slot's reports, escalated once the code is storming
+*/
+static whoop_error_severity_t ao_error_agg_severity(ao_error_agg_slot_t const * const slot)
+{
+    if ((slot->count >= AO_ERROR_AGG_ESCALATE) && (slot->error_severity == E_S_WHOOP_WARNING))
+    {
+        return E_S_WHOOP_ERROR;
+    }
+
+    return slot->error_severity;
+}
+
+/**
+*   @brief      Reset the aggregator
+*   @param[in]  agg         - pointer to the aggregator
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_error_agg_init(ao_error_agg_t * const agg)
+{
+    memset(agg, 0, sizeof(*agg));
+}
+
+/**
+*   @brief      Account for one error report
+*   @param[in]  agg             - pointer to the aggregator
+*   @param[in]  error_code      - error code
+*   @param[in]  error_severity  - severity as reported
+*   @param[out] report          - what to publish, filled for AO_ERROR_AGG_PUBLISH
+*   @return     ao_error_agg_result_t - whether to publish now or the report was held
+*/
+ao_error_agg_result_t ao_error_agg_add(ao_error_agg_t * const agg, int32_t error_code,
+                                       whoop_error_severity_t error_severity,
+                                       ao_error_agg_report_t * const report)
+{
+    timer_count_t const now = AO_CLOCK_NOW();
+    ao_error_agg_slot_t * slot = NULL;
+    ao_error_agg_slot_t * free_slot = NULL;
+
+    for (uint8_t i = 0u; i < AO_ERROR_AGG_MAX_CODES; i++)
+    {
+        ao_error_agg_slot_t * const s = &agg->slots[i];
+        bool const open = ao_error_agg_is_open(s, now);
+
+        if (open && (s->error_code == error_code))
+        {
+            slot = s;
+            break;
+        }
+
+        // A closed window still holding a summary is not free until collected
+        if (!open && (s->merged == 0u) && (free_slot == NULL))
+        {
+            free_slot = s;
+        }
+    }
+
+    report->error_code     = error_code;
+    report->error_severity = error_severity;
+    report->count          = 1u;
+    report->first          = now;
+    report->last           = now;
+
+    if (slot == NULL)
+    {
+        // Too many codes at once: publish untracked rather than lose the report
+        if (free_slot != NULL)
+        {
+            memset(free_slot, 0, sizeof(*free_slot));
+
+            free_slot->error_code     = error_code;
+            free_slot->error_severity = error_severity;
+            free_slot->count          = 1u;
+            free_slot->window_start   = now;
+            free_slot->last           = now;
+        }
+
+        agg->published++;
+        return AO_ERROR_AGG_PUBLISH;
+    }
+
+    if (slot->count < UINT16_MAX)
+    {
+        slot->count++;
+    }
+    slot->last = now;
+
+    if (slot->count <= AO_ERROR_AGG_BURST)
+    {
+        report->error_severity = ao_error_agg_severity(slot);
+        agg->published++;
+        return AO_ERROR_AGG_PUBLISH;
+    }
+
+    bool const was_pending = ao_error_agg_is_pending(agg);
+
+    if (slot->merged == 0u)
+    {
+        slot->first_merged = now;
+    }
+    if (slot->merged < UINT16_MAX)
+    {
+        slot->merged++;
+    }
+    agg->merged++;
+
+    return was_pending ? AO_ERROR_AGG_HELD : AO_ERROR_AGG_HELD_FIRST;
+}
+
+/**
+*   @brief      Collect the summary of one closed window
+*   @details    Call until it returns false.
+*   @param[in]  agg         - pointer to the aggregator
+*   @param[out] report      - summary to publish
+*   @return     bool        - false once no closed window holds a summary
+*/
+bool ao_error_agg_next_report(ao_error_agg_t * const agg, ao_error_agg_report_t * const report)
+{
+    timer_count_t const now = AO_CLOCK_NOW();
+
+    for (uint8_t i = 0u; i < AO_ERROR_AGG_MAX_CODES; i++)
+    {
+        ao_error_agg_slot_t * const s = &agg->slots[i];
+
+        if ((s->merged == 0u) || ao_error_agg_is_open(s, now))
+        {
+            continue;
+        }
+
+        report->error_code     = s->error_code;
+        report->error_severity = ao_error_agg_severity(s);
+        report->count          = s->merged;
+        report->first          = s->first_merged;
+        report->last           = s->last;
+
+        s->merged = 0u;
+        s->count  = 0u;
+
+        agg->published++;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+*   @brief      True while any window holds reports for a summary
+*/
+bool ao_error_agg_is_pending(ao_error_agg_t const * const agg)
+{
+    for (uint8_t i = 0u; i < AO_ERROR_AGG_MAX_CODES; i++)
+    {
+        if (agg->slots[i].merged > 0u)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+*   @brief      Copy a report into its event
+*   @details    The name, subsystem and extra info are left to the owner.
+*/
+void ao_error_agg_fill(ao_error_agg_event_t * const evt, ao_error_agg_report_t const * const report)
+{
+    evt->super.error_code     = report->error_code;
+    evt->super.error_severity = report->error_severity;
+
+    evt->count = report->count;
+    evt->first = report->first;
+    evt->last  = report->last;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file        ao_error_agg.h
+ * @brief       Aggregation of repeated error reports
+ * @details     Drivers publish GENERIC_ERROR_REPORT_SIG to every subscriber, so
+ *              a flapping bus can flood the system with identical reports. The
+ *              aggregator keeps a window per error code: the first
+ *              AO_ERROR_AGG_BURST reports of a code in a window are published as
+ *              they happen, later ones are merged and published as one summary
+ *              when the window closes. A code reported AO_ERROR_AGG_ESCALATE
+ *              times in one window is escalated from warning to error.
+ *
+ *              The owner publishes what ao_error_agg_add() lets through, and runs
+ *              a timer of AO_ERROR_AGG_WINDOW_MS to collect the summaries with
+ *              ao_error_agg_next_report(), see device_level.c.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_ERROR_AGG_H
+#define AO_ERROR_AGG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "common.h"
+#include "events.h"
+#include "ao_clock.h"
+
+// Length of an aggregation window
+#ifndef AO_ERROR_AGG_WINDOW_MS
+#define AO_ERROR_AGG_WINDOW_MS          1000u
+#endif
+
+// Reports of one code published individually per window
+#ifndef AO_ERROR_AGG_BURST
+#define AO_ERROR_AGG_BURST              3u
+#endif
+
+// Reports of one code per window from which a warning counts as an error
+#ifndef AO_ERROR_AGG_ESCALATE
+#define AO_ERROR_AGG_ESCALATE           20u
+#endif
+
+// Error codes aggregated at the same time, further codes are published as they come
+#define AO_ERROR_AGG_MAX_CODES          4u
+
+/**
+    @brief Error report published by an aggregating driver.
+    Extends generic_error_signal_t, so subscribers that only know the generic
+    event keep working. count is 1 for a report published as it happened.
+*/
+typedef struct
+{
+    generic_error_signal_t  super;                              /**< Extend generic_error_signal_t >*/
+    uint16_t                count;                              /**< Occurrences covered by this report >*/
+    timer_count_t           first;                              /**< AO clock time of the first occurrence >*/
+    timer_count_t           last;                               /**< AO clock time of the last occurrence >*/
+} ao_error_agg_event_t;
+
+/*! @struct ao_error_agg_report_t
+*   @brief  What to publish
+*/
+typedef struct
+{
+    int32_t                 error_code;
+    whoop_error_severity_t  error_severity;                     /**< Escalated if the code is storming >*/
+    uint16_t                count;
+    timer_count_t           first;
+    timer_count_t           last;
+} ao_error_agg_report_t;
+
+/*! @struct ao_error_agg_slot_t
+*   @brief  Window of one error code
+*/
+typedef struct
+{
+    int32_t                 error_code;
+    whoop_error_severity_t  error_severity;                     /**< As reported, before escalation >*/
+    uint16_t                count;                              /**< Reports in the window, 0 when unused >*/
+    uint16_t                merged;                             /**< Reports held for the summary >*/
+    timer_count_t           window_start;
+    timer_count_t           first_merged;
+    timer_count_t           last;
+} ao_error_agg_slot_t;
+
+/*! @struct ao_error_agg_t
+*   @brief  Per-AO aggregator
+*/
+typedef struct
+{
+    ao_error_agg_slot_t     slots[AO_ERROR_AGG_MAX_CODES];
+    uint32_t                published;                          /**< Events published, summaries included >*/
+    uint32_t                merged;                             /**< Reports folded into summaries >*/
+} ao_error_agg_t;
+
+typedef enum
+{
+    AO_ERROR_AGG_PUBLISH,                                       /**< Publish the report now >*/
+    AO_ERROR_AGG_HELD,                                          /**< Merged into a pending summary >*/
+    AO_ERROR_AGG_HELD_FIRST,                                    /**< Merged, nothing was pending before: start the timer >*/
+} ao_error_agg_result_t;
+
+void ao_error_agg_init(ao_error_agg_t * const agg);
+
+ao_error_agg_result_t ao_error_agg_add(ao_error_agg_t * const agg, int32_t error_code,
+                                       whoop_error_severity_t error_severity,
+                                       ao_error_agg_report_t * const report);
+
+bool ao_error_agg_next_report(ao_error_agg_t * const agg, ao_error_agg_report_t * const report);
+
+bool ao_error_agg_is_pending(ao_error_agg_t const * const agg);
+
+void ao_error_agg_fill(ao_error_agg_event_t * const evt, ao_error_agg_report_t const * const report);
+
+#endif
@@ -0,0 +1,296 @@
+/**
+ * @file        ao_fast_path.c
+ * @brief       Table-driven dispatch of hot (state, signal) pairs
+ * @details     Transition paths are worked out the way QEP does it, by asking
+ *              each state for its superstate with Q_EMPTY_SIG, but only once per
+ *              table entry, at install time.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_fast_path.h"
+
+Q_DEFINE_THIS_FILE
+
+// Maximum number of AOs with a fast path at the same time
+#define AO_FAST_PATH_MAX_AOS            4u
+
+/*! @struct ao_fast_path_hook_t
+*   @brief  Link between an AO, its fast path and its original dispatch
+*/
+typedef struct
+{
+    QHsm const *            hsm;                                /**< State machine >*/
+    ao_fast_path_t *        fast_path;                          /**< Table and routes >*/
+    QActiveVtable           vtable;                             /**< Patched virtual table >*/
+    void                    (*dispatch)(QHsm * const me, QEvt const * const e,
+                                        uint_fast8_t const qs_id); /**< Original dispatch >*/
+} ao_fast_path_hook_t;
+
+static ao_fast_path_hook_t ao_fast_path_hooks[AO_FAST_PATH_MAX_AOS];
+static uint8_t             ao_fast_path_n_hooks = 0u;
+
+static QEvt const ao_fast_path_empty_evt = {Q_EMPTY_SIG, 0u, 0u};
+static QEvt const ao_fast_path_entry_evt = {Q_ENTRY_SIG, 0u, 0u};
+static QEvt const ao_fast_path_exit_evt  = {Q_EXIT_SIG, 0u, 0u};
+static QEvt const ao_fast_path_init_evt  = {Q_INIT_SIG, 0u, 0u};
+
+// Private functions
+static ao_fast_path_hook_t * ao_fast_path_find_hook(QHsm const * const hsm);
+
+static void ao_fast_path_dispatch(QHsm * const me, QEvt const * const e, uint_fast8_t const qs_id);
+
+static uint8_t ao_fast_path_chain(QHsm * const hsm, QStateHandler state, QStateHandler * const chain);
+
+static bool ao_fast_path_route(QHsm * const hsm, ao_fast_path_entry_t const * const entry,
+                               ao_fast_path_route_t * const route);
+
+/**
+*   @brief      Give an active object a fast path
+*   @details    Must be called after QActive_ctor() and before the AO is started.
+*               An AO constructed again, as by a driver restart, keeps its hook.
+*   @param[in]  ao          - pointer to the active object
+*   @param[in]  fast_path   - fast path storage for this AO
+*   @param[in]  table       - hot (state, signal) pairs, must outlive the AO
+*   @param[in]  n_entries   - number of entries in table
+*   @param[out] nothing
+*   @return     bool        - false if all hooks are in use, the table is too long,
+*                             or an entry's transition cannot be taken directly
+*/
+bool ao_fast_path_install(QActive * const ao, ao_fast_path_t * const fast_path,
+                          ao_fast_path_entry_t const * const table, uint8_t n_entries)
+{
+    ao_fast_path_hook_t * hook = ao_fast_path_find_hook(&ao->super);
+
+    if (((hook == NULL) && (ao_fast_path_n_hooks >= AO_FAST_PATH_MAX_AOS)) ||
+        (n_entries > AO_FAST_PATH_MAX_ENTRIES))
+    {
+        return false;
+    }
+
+    memset(fast_path, 0, sizeof(*fast_path));
+
+    // Working out the routes uses the state machine's temporary state
+    QStateHandler const temp = ao->super.temp.fun;
+    bool ok = true;
+
+    for (uint8_t i = 0u; ok && (i < n_entries); i++)
+    {
+        ok = ao_fast_path_route(&ao->super, &table[i], &fast_path->routes[i]);
+    }
+
+    ao->super.temp.fun = temp;
+
+    if (!ok)
+    {
+        return false;
+    }
+
+    fast_path->table     = table;
+    fast_path->n_entries = n_entries;
+    fast_path->enabled   = true;
+
+    if (hook == NULL)
+    {
+        hook      = &ao_fast_path_hooks[ao_fast_path_n_hooks++];
+        hook->hsm = &ao->super;
+    }
+
+    hook->fast_path = fast_path;
+
+    // Copy the AO's virtual table and patch the dispatch entry, unless still patched
+    if (ao->super.vptr != &hook->vtable.super)
+    {
+        hook->vtable                = *(QActiveVtable const *)ao->super.vptr;
+        hook->dispatch              = hook->vtable.super.dispatch;
+        hook->vtable.super.dispatch = &ao_fast_path_dispatch;
+
+        ao->super.vptr = &hook->vtable.super;
+    }
+
+    return true;
+}
+
+/**
+*   @brief      Turn the fast path on or off, every event takes the normal dispatch while off
+*/
+void ao_fast_path_enable(ao_fast_path_t * const fast_path, bool enable)
+{
+    fast_path->enabled = enable;
+}
+
+/**
+*   @brief      Hook of a state machine
+*   @return     ao_fast_path_hook_t - pointer to the hook, or NULL if never installed
+*/
+static ao_fast_path_hook_t * ao_fast_path_find_hook(QHsm const * const hsm)
+{
+    for (uint8_t i = 0u; i < ao_fast_path_n_hooks; i++)
+    {
+        if (ao_fast_path_hooks[i].hsm == hsm)
+        {
+            return &ao_fast_path_hooks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+*   @brief      Dispatch wrapper installed in the AO's virtual table
+*/
+static void ao_fast_path_dispatch(QHsm * const me, QEvt const * const e, uint_fast8_t const qs_id)
+{
+    ao_fast_path_hook_t const * const hook = ao_fast_path_find_hook(me);
+
+    Q_ASSERT(hook != NULL);
+
+    ao_fast_path_t * const fast_path = hook->fast_path;
+
+    for (uint8_t i = 0u; fast_path->enabled && (i < fast_path->n_entries); i++)
+    {
+        ao_fast_path_entry_t const * const entry = &fast_path->table[i];
+
+        if ((entry->state != me->state.fun) || (entry->sig != e->sig))
+        {
+            continue;
+        }
+
+        if (!(*entry->action)(me, e))
+        {
+            fast_path->declined++;
+            break;
+        }
+
+        ao_fast_path_route_t const * const route = &fast_path->routes[i];
+
+        for (uint8_t k = 0u; k < route->n_exits; k++)
+        {
+            (void)(*route->exits[k])(me, &ao_fast_path_exit_evt);
+        }
+        for (uint8_t k = 0u; k < route->n_entries; k++)
+        {
+            (void)(*route->entries[k])(me, &ao_fast_path_entry_evt);
+        }
+
+        if (entry->target != NULL)
+        {
+            me->state.fun = entry->target;
+        }
+
+        // States without an entry or exit action report their superstate here
+        me->temp.fun = me->state.fun;
+        fast_path->hits++;
+        return;
+    }
+
+    (*hook->dispatch)(me, e, qs_id);
+}
+
+/**
+*   @brief      List a state and its superstates, innermost first, QHsm_top excluded
+*   @return     uint8_t     - number of states, 0 if nested deeper than AO_FAST_PATH_MAX_DEPTH
+*/
+static uint8_t ao_fast_path_chain(QHsm * const hsm, QStateHandler state, QStateHandler * const chain)
+{
+    uint8_t n = 0u;
+
+    while (state != (QStateHandler)&QHsm_top)
+    {
+        if (n >= AO_FAST_PATH_MAX_DEPTH)
+        {
+            return 0u;
+        }
+
+        chain[n++] = state;
+
+        (void)(*state)(hsm, &ao_fast_path_empty_evt);
+        state = hsm->temp.fun;
+    }
+
+    return n;
+}
+
+/**
+*   @brief      Work out the exit and entry path of one table entry
+*   @return     bool        - false if the transition cannot be taken directly: the
+*                             target is an ancestor of the source or has an initial
+*                             transition, or the states are nested too deep
+*/
+static bool ao_fast_path_route(QHsm * const hsm, ao_fast_path_entry_t const * const entry,
+                               ao_fast_path_route_t * const route)
+{
+    QStateHandler source_chain[AO_FAST_PATH_MAX_DEPTH];
+    QStateHandler target_chain[AO_FAST_PATH_MAX_DEPTH];
+
+    memset(route, 0, sizeof(*route));
+
+    if (entry->target == NULL)
+    {
+        return true;
+    }
+
+    if ((*entry->target)(hsm, &ao_fast_path_init_evt) == (QState)Q_RET_TRAN)
+    {
+        return false;
+    }
+
+    // Self transition: exit and re-enter the source
+    if (entry->target == entry->state)
+    {
+        route->n_exits    = 1u;
+        route->n_entries  = 1u;
+        route->exits[0]   = entry->state;
+        route->entries[0] = entry->state;
+        return true;
+    }
+
+    uint8_t const n_source = ao_fast_path_chain(hsm, entry->state, source_chain);
+    uint8_t const n_target = ao_fast_path_chain(hsm, entry->target, target_chain);
+
+    if ((n_source == 0u) || (n_target == 0u))
+    {
+        return false;
+    }
+
+    // The least common ancestor is the innermost source superstate the target is nested in
+    uint8_t n_exits   = n_source;
+    uint8_t n_entries = n_target;
+
+    for (uint8_t s = 0u; (s < n_source) && (n_exits == n_source); s++)
+    {
+        for (uint8_t t = 0u; t < n_target; t++)
+        {
+            if (source_chain[s] == target_chain[t])
+            {
+                n_exits   = s;
+                n_entries = t;
+                break;
+            }
+        }
+    }
+
+    if (n_entries == 0u)
+    {
+        return false;
+    }
+
+    route->n_exits   = n_exits;
+    route->n_entries = n_entries;
+
+    memcpy(route->exits, source_chain, n_exits * sizeof(route->exits[0]));
+
+    for (uint8_t k = 0u; k < n_entries; k++)
+    {
+        route->entries[k] = target_chain[n_entries - 1u - k];
+    }
+
+    return true;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file        ao_fast_path.h
+ * @brief       Table-driven dispatch of hot (state, signal) pairs
+ * @details     Opt-in dispatch shortcut for driver state machines.
+ *              ao_fast_path_install() replaces the dispatch entry of the AO's
+ *              virtual table with one that looks the event up in a table of hot
+ *              (leaf state, signal) pairs first. On a hit the entry's action runs
+ *              and the transition is taken along an exit and entry path worked
+ *              out once at install time, so the step does not walk the switch
+ *              hierarchy to find the handler, nor the state hierarchy to find the
+ *              transition's least common ancestor. Everything else, and any hit
+ *              whose action declines the event, goes to the normal dispatch.
+ *
+ *              The action doubles as the guard: it returns false, before doing
+ *              anything, to leave the event to the state machine. A fast path
+ *              step must have the same effect as the normal one, so the state
+ *              handlers and the actions should share their helpers.
+ *
+ *              Fast path steps emit no QS state machine records. Install the RTC
+ *              profiler after the fast path to measure the steps it takes.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_FAST_PATH_H
+#define AO_FAST_PATH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qpc.h"
+
+// Maximum number of table entries per AO
+#define AO_FAST_PATH_MAX_ENTRIES        8u
+
+// Maximum state nesting depth of a source or target state
+#define AO_FAST_PATH_MAX_DEPTH          6u
+
+// Guard and action of an entry, false to decline the event
+typedef bool (*ao_fast_path_action_t)(void * const me, QEvt const * const e);
+
+/*! @struct ao_fast_path_entry_t
+*   @brief  One hot (state, signal) pair
+*/
+typedef struct
+{
+    QStateHandler           state;                              /**< Leaf state >*/
+    QSignal                 sig;                                /**< Signal >*/
+    ao_fast_path_action_t   action;                             /**< Guard and action >*/
+    QStateHandler           target;                             /**< Leaf target state, NULL for an internal transition >*/
+} ao_fast_path_entry_t;
+
+/*! @struct ao_fast_path_route_t
+*   @brief  Transition path of an entry, computed at install time
+*/
+typedef struct
+{
+    uint8_t                 n_exits;
+    uint8_t                 n_entries;
+    QStateHandler           exits[AO_FAST_PATH_MAX_DEPTH];      /**< Innermost first >*/
+    QStateHandler           entries[AO_FAST_PATH_MAX_DEPTH];    /**< Outermost first >*/
+} ao_fast_path_route_t;
+
+/*! @struct ao_fast_path_t
+*   @brief  Per-AO fast path state
+*/
+typedef struct
+{
+    ao_fast_path_entry_t const *    table;
+    uint8_t                         n_entries;
+    bool                            enabled;                    /**< Runtime switch, for A/B measurements >*/
+    uint32_t                        hits;                       /**< Steps taken on the fast path >*/
+    uint32_t                        declined;                   /**< Table hits the action declined >*/
+    ao_fast_path_route_t            routes[AO_FAST_PATH_MAX_ENTRIES]; /**< Indexed like table >*/
+} ao_fast_path_t;
+
+bool ao_fast_path_install(QActive * const ao, ao_fast_path_t * const fast_path,
+                          ao_fast_path_entry_t const * const table, uint8_t n_entries);
+
+void ao_fast_path_enable(ao_fast_path_t * const fast_path, bool enable);
+
+#endif
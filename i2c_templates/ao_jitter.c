@@ -0,0 +1,192 @@
+/**
+ * @file        ao_jitter.c
+ * @brief       Timing deviation statistics of a periodic activity
+ * @details     A sample is a few compares and one histogram bin, constant time,
+ *              so it can be taken on the dispatch path it measures.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_jitter.h"
+#include "driver_qs_records.h"
+
+// Private functions
+static uint8_t ao_jitter_hist_bin(uint32_t abs_us);
+
+static uint32_t ao_jitter_p99_us(ao_jitter_t const * const jitter);
+
+/**
+*   @brief      Histogram bin of an absolute deviation
+*/
+static uint8_t ao_jitter_hist_bin(uint32_t abs_us)
+{
+    uint8_t bin = 0u;
+
+    while ((abs_us > 0u) && (bin < (AO_JITTER_HIST_BINS - 1u)))
+    {
+        abs_us >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+/**
+*   @brief      Upper bound of the bin holding the 99th percentile of the absolute deviation
+*   @details    For the last bin, which holds everything larger, the largest
+*               absolute deviation seen.
+*/
+static uint32_t ao_jitter_p99_us(ao_jitter_t const * const jitter)
+{
+    // Samples allowed above the percentile
+    uint32_t const above = jitter->n_samples / 100u;
+    uint32_t seen = 0u;
+
+    for (uint32_t b = AO_JITTER_HIST_BINS; b-- > 0u; )
+    {
+        seen += jitter->histogram[b];
+
+        if (seen > above)
+        {
+            if (b == (AO_JITTER_HIST_BINS - 1u))
+            {
+                // The last bin has no upper bound, the largest deviation seen is one
+                uint32_t const min_abs = (uint32_t)((jitter->min_us < 0) ? -jitter->min_us : jitter->min_us);
+                uint32_t const max_abs = (uint32_t)((jitter->max_us < 0) ? -jitter->max_us : jitter->max_us);
+
+                return (min_abs > max_abs) ? min_abs : max_abs;
+            }
+
+            return (b == 0u) ? 0u : ((1u << b) - 1u);
+        }
+    }
+
+    return 0u;
+}
+
+/**
+*   @brief      Reset the statistics
+*   @param[in]  jitter      - pointer to the tracker
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_jitter_init(ao_jitter_t * const jitter)
+{
+    memset(jitter, 0, sizeof(*jitter));
+}
+
+/**
+*   @brief      Signed deviation of a time from its ideal, across clock wraps
+*   @param[in]  actual      - AO clock time
+*   @param[in]  ideal       - AO clock time it should have been
+*   @param[out] nothing
+*   @return     int32_t     - deviation, us, late when positive
+*/
+int32_t ao_jitter_deviation_us(timer_count_t actual, timer_count_t ideal)
+{
+    // Taken unsigned, then signed by which way round is shorter
+    if ((int32_t)(actual - ideal) >= 0)
+    {
+        return (int32_t)AO_CLOCK_COUNTS_TO_US((timer_count_t)(actual - ideal));
+    }
+
+    return -(int32_t)AO_CLOCK_COUNTS_TO_US((timer_count_t)(ideal - actual));
+}
+
+/**
+*   @brief      Add one deviation
+*   @param[in]  jitter          - pointer to the tracker
+*   @param[in]  deviation_us    - actual minus ideal time, us
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_jitter_observe(ao_jitter_t * const jitter, int32_t deviation_us)
+{
+    uint32_t const abs_us = (uint32_t)((deviation_us < 0) ? -deviation_us : deviation_us);
+
+    if ((jitter->n_samples == 0u) || (deviation_us < jitter->min_us))
+    {
+        jitter->min_us = deviation_us;
+    }
+    if ((jitter->n_samples == 0u) || (deviation_us > jitter->max_us))
+    {
+        jitter->max_us = deviation_us;
+    }
+
+    jitter->last_us = deviation_us;
+    jitter->abs_sum_us += abs_us;
+    jitter->histogram[ao_jitter_hist_bin(abs_us)]++;
+    jitter->n_samples++;
+}
+
+/**
+*   @brief      Count a period that produced no sample
+*   @param[in]  jitter      - pointer to the tracker
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_jitter_miss(ao_jitter_t * const jitter)
+{
+    jitter->n_missed++;
+}
+
+/**
+*   @brief      Snapshot of the statistics
+*   @param[in]  jitter      - pointer to the tracker
+*   @param[out] report      - statistics
+*   @return     nothing
+*/
+void ao_jitter_get_report(ao_jitter_t const * const jitter, ao_jitter_report_t * const report)
+{
+    report->n_samples = jitter->n_samples;
+    report->n_missed = jitter->n_missed;
+    report->last_us = jitter->last_us;
+    report->min_us = jitter->min_us;
+    report->max_us = jitter->max_us;
+    report->mean_abs_us = (jitter->n_samples == 0u) ? 0u :
+                          (uint32_t)(jitter->abs_sum_us / jitter->n_samples);
+    report->p99_us = ao_jitter_p99_us(jitter);
+}
+
+/**
+*   @brief      Export the statistics through QS, a summary then one record per bin
+*   @param[in]  jitter      - pointer to the tracker
+*   @param[in]  stream      - number of the stream, defined by the owner
+*   @param[in]  qs_id       - QS id of the owning AO
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_jitter_qs_dump(ao_jitter_t const * const jitter, uint8_t stream, uint8_t qs_id)
+{
+    ao_jitter_report_t report;
+
+    (void)qs_id;    // unused when QS is disabled
+
+    ao_jitter_get_report(jitter, &report);
+
+    QS_BEGIN_ID(DRIVER_QS_JITTER, qs_id)
+        QS_U8(0, stream);
+        QS_U32(0, report.n_samples);
+        QS_U32(0, report.n_missed);
+        QS_I32(0, report.min_us);
+        QS_I32(0, report.max_us);
+        QS_U32(0, report.mean_abs_us);
+        QS_U32(0, report.p99_us);
+    QS_END()
+
+    for (uint8_t bin = 0u; bin < AO_JITTER_HIST_BINS; bin++)
+    {
+        QS_BEGIN_ID(DRIVER_QS_JITTER_HIST, qs_id)
+            QS_U8(0, stream);
+            QS_U8(0, bin);
+            QS_U32(0, jitter->histogram[bin]);
+        QS_END()
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file        ao_jitter.h
+ * @brief       Timing deviation statistics of a periodic activity
+ * @details     One tracker per periodic stream. Each sample is the deviation of
+ *              an actual time from its ideal time, late when positive. The
+ *              tracker keeps the signed extremes, the mean absolute deviation and
+ *              a log2 histogram of the absolute deviation, from which the 99th
+ *              percentile is read. Periods that produced no sample are counted
+ *              apart, since they have no deviation.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_JITTER_H
+#define AO_JITTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ao_clock.h"
+
+/**
+    @brief Number of deviation histogram bins.
+    Bin 0 holds deviations under 1 us, bin n holds [2^(n-1), 2^n) us and the
+    last bin holds everything larger.
+*/
+#define AO_JITTER_HIST_BINS             16u
+
+/*! @struct ao_jitter_t
+*   @brief  Deviation statistics of one stream
+*/
+typedef struct
+{
+    uint32_t                n_samples;
+    uint32_t                n_missed;                           /**< Periods without a sample >*/
+    int32_t                 last_us;
+    int32_t                 min_us;
+    int32_t                 max_us;
+    uint64_t                abs_sum_us;
+    uint32_t                histogram[AO_JITTER_HIST_BINS];     /**< Absolute deviation histogram >*/
+} ao_jitter_t;
+
+/*! @struct ao_jitter_report_t
+*   @brief  Exported snapshot of a tracker
+*/
+typedef struct
+{
+    uint32_t                n_samples;
+    uint32_t                n_missed;
+    int32_t                 last_us;
+    int32_t                 min_us;
+    int32_t                 max_us;
+    uint32_t                mean_abs_us;
+    uint32_t                p99_us;                             /**< Upper bound of the bin holding the 99th percentile, the largest deviation in the last bin >*/
+} ao_jitter_report_t;
+
+void ao_jitter_init(ao_jitter_t * const jitter);
+
+int32_t ao_jitter_deviation_us(timer_count_t actual, timer_count_t ideal);
+
+void ao_jitter_observe(ao_jitter_t * const jitter, int32_t deviation_us);
+
+void ao_jitter_miss(ao_jitter_t * const jitter);
+
+void ao_jitter_get_report(ao_jitter_t const * const jitter, ao_jitter_report_t * const report);
+
+void ao_jitter_qs_dump(ao_jitter_t const * const jitter, uint8_t stream, uint8_t qs_id);
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * @file        ao_retry_policy.c
+ * @brief       Retry decisions keyed by the class of a transfer error
+ * @details     Tables are a handful of entries, so lookups are a linear scan.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ao_retry_policy.h"
+
+// Private functions
+static ao_retry_policy_entry_t const * ao_retry_policy_find(ao_retry_policy_t const * const me, int32_t hal_error);
+
+static uint32_t ao_retry_policy_delay_ms(ao_retry_policy_entry_t const * const entry, uint8_t retry);
+
+/**
+*   @brief      Table entry of a HAL error, NULL if it has none
+*/
+static ao_retry_policy_entry_t const * ao_retry_policy_find(ao_retry_policy_t const * const me, int32_t hal_error)
+{
+    for (uint8_t i = 0u; i < me->n_entries; i++)
+    {
+        if (me->table[i].hal_error == hal_error)
+        {
+            return &me->table[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+*   @brief      Delay before a retry, retry counts from 0
+*/
+static uint32_t ao_retry_policy_delay_ms(ao_retry_policy_entry_t const * const entry, uint8_t retry)
+{
+    switch (entry->action)
+    {
+        case AO_RETRY_BACKOFF:
+        {
+            uint8_t const shift = (retry < AO_RETRY_POLICY_MAX_SHIFT) ? retry : AO_RETRY_POLICY_MAX_SHIFT;
+
+            return (uint32_t)entry->delay_ms << shift;
+        }
+        case AO_RETRY_RECOVER:
+        {
+            return entry->delay_ms;
+        }
+        default:
+        {
+            return 0u;
+        }
+    }
+}
+
+/**
+*   @brief      Set the policy table and clear the statistics
+*   @param[in]  me          - retry policy
+*   @param[in]  table       - what to do per HAL error, must outlive the policy
+*   @param[in]  n_entries   - entries in the table, at most AO_RETRY_POLICY_MAX_ENTRIES
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_retry_policy_init(ao_retry_policy_t * const me, ao_retry_policy_entry_t const * const table,
+                          uint8_t n_entries)
+{
+    memset(me, 0, sizeof(*me));
+
+    me->table     = table;
+    me->n_entries = (n_entries < AO_RETRY_POLICY_MAX_ENTRIES) ? n_entries : (uint8_t)AO_RETRY_POLICY_MAX_ENTRIES;
+}
+
+/**
+*   @brief      Start counting retries for a new request, for every entry
+*/
+void ao_retry_policy_reset(ao_retry_policy_t * const me)
+{
+    memset(me->retries, 0, sizeof(me->retries));
+}
+
+/**
+*   @brief      Class of a HAL error, without spending a retry
+*   @param[in]  me          - retry policy
+*   @param[in]  hal_error   - error from the HAL
+*   @param[out] nothing
+*   @return     ao_retry_action_t - action of the table entry, AO_RETRY_FAIL if none
+*/
+ao_retry_action_t ao_retry_policy_lookup(ao_retry_policy_t const * const me, int32_t hal_error)
+{
+    ao_retry_policy_entry_t const * const entry = ao_retry_policy_find(me, hal_error);
+
+    return (entry != NULL) ? entry->action : AO_RETRY_FAIL;
+}
+
+/**
+*   @brief      Decide what to do about an error of the current request
+*   @param[in]  me          - retry policy
+*   @param[in]  hal_error   - error from the HAL
+*   @param[out] delay_ms    - wait before re-issuing, for BACKOFF and RECOVER
+*   @return     ao_retry_action_t - what to do, GIVE_UP once the entry is out of retries
+*/
+ao_retry_action_t ao_retry_policy_decide(ao_retry_policy_t * const me, int32_t hal_error,
+                                         uint32_t * const delay_ms)
+{
+    ao_retry_policy_entry_t const * const entry = ao_retry_policy_find(me, hal_error);
+    ao_retry_action_t action = AO_RETRY_FAIL;
+
+    *delay_ms = 0u;
+
+    if (entry != NULL)
+    {
+        uint8_t * const retries = &me->retries[entry - me->table];
+
+        action = entry->action;
+
+        if ((action != AO_RETRY_FAIL) && (*retries >= entry->max_retries))
+        {
+            action = AO_RETRY_GIVE_UP;
+        }
+        else if (action != AO_RETRY_FAIL)
+        {
+            *delay_ms = ao_retry_policy_delay_ms(entry, *retries);
+            (*retries)++;
+        }
+    }
+
+    me->decisions[action]++;
+
+    return action;
+}
+
+/**
+*   @brief      Longest a request can take with every retry of every error class
+*   @details    Entries count their retries apart, so a request can use up all of
+*               them in turn: the budget is the sum over the entries, not the
+*               worst one.
+*   @param[in]  me          - retry policy
+*   @param[in]  attempt_ms  - time one attempt may take
+*   @param[out] nothing
+*   @return     uint32_t    - ms, including the first attempt
+*/
+uint32_t ao_retry_policy_budget_ms(ao_retry_policy_t const * const me, uint32_t attempt_ms)
+{
+    uint32_t budget = attempt_ms;
+
+    for (uint8_t i = 0u; i < me->n_entries; i++)
+    {
+        ao_retry_policy_entry_t const * const entry = &me->table[i];
+
+        if (entry->action == AO_RETRY_FAIL)
+        {
+            continue;
+        }
+
+        for (uint8_t retry = 0u; retry < entry->max_retries; retry++)
+        {
+            budget += ao_retry_policy_delay_ms(entry, retry) + attempt_ms;
+        }
+    }
+
+    return budget;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file        ao_retry_policy.h
+ * @brief       Retry decisions keyed by the class of a transfer error
+ * @details     A driver describes in a table what each HAL error means for the
+ *              transfer that hit it:
+ *
+ *              AO_RETRY_NOW        -   re-issue at once, e.g. arbitration lost to
+ *                                      another master
+ *              AO_RETRY_BACKOFF    -   re-issue after delay_ms, doubled on every
+ *                                      retry, e.g. a device NAKing while busy
+ *              AO_RETRY_RECOVER    -   recover the bus, then re-issue after
+ *                                      delay_ms, e.g. a stuck bus
+ *              AO_RETRY_FAIL       -   no retry, the device is not there
+ *
+ *              Errors missing from the table fail. Each entry counts its own
+ *              retries of the current request, so a busy device does not use up
+ *              the retries of a stuck bus. An entry gives up after max_retries
+ *              retries, and the request then ends in AO_RETRY_GIVE_UP.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_RETRY_POLICY_H
+#define AO_RETRY_POLICY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Longest backoff, as a number of doublings of delay_ms
+#define AO_RETRY_POLICY_MAX_SHIFT       4u
+
+// Most entries of a policy table, later entries are never looked up
+#define AO_RETRY_POLICY_MAX_ENTRIES     8u
+
+typedef enum
+{
+    AO_RETRY_NOW,                                               /**< Re-issue now >*/
+    AO_RETRY_BACKOFF,                                           /**< Re-issue after an increasing delay >*/
+    AO_RETRY_RECOVER,                                           /**< Recover the bus, re-issue after a delay >*/
+    AO_RETRY_FAIL,                                              /**< Fail the request, the error is not transient >*/
+    AO_RETRY_GIVE_UP,                                           /**< Transient, but out of retries >*/
+
+    AO_RETRY_ACTION_COUNT,
+} ao_retry_action_t;
+
+/*! @struct ao_retry_policy_entry_t
+*   @brief  What to do about one HAL error
+*/
+typedef struct
+{
+    int32_t                 hal_error;
+    ao_retry_action_t       action;
+    uint8_t                 max_retries;                        /**< Retries of one request >*/
+    uint16_t                delay_ms;                           /**< Delay before the first retry >*/
+} ao_retry_policy_entry_t;
+
+/*! @struct ao_retry_policy_t
+*   @brief  Policy table and the retries of the current request, per entry
+*/
+typedef struct
+{
+    ao_retry_policy_entry_t const * table;
+    uint8_t                 n_entries;
+    uint8_t                 retries[AO_RETRY_POLICY_MAX_ENTRIES];   /**< Retries of the current request >*/
+    uint32_t                decisions[AO_RETRY_ACTION_COUNT];   /**< Decisions taken, per action >*/
+} ao_retry_policy_t;
+
+void ao_retry_policy_init(ao_retry_policy_t * const me, ao_retry_policy_entry_t const * const table,
+                          uint8_t n_entries);
+
+void ao_retry_policy_reset(ao_retry_policy_t * const me);
+
+ao_retry_action_t ao_retry_policy_lookup(ao_retry_policy_t const * const me, int32_t hal_error);
+
+ao_retry_action_t ao_retry_policy_decide(ao_retry_policy_t * const me, int32_t hal_error,
+                                         uint32_t * const delay_ms);
+
+uint32_t ao_retry_policy_budget_ms(ao_retry_policy_t const * const me, uint32_t attempt_ms);
+
+#endif
@@ -0,0 +1,294 @@
+/**
+ * @file        ao_rtc_profiler.c
+ * @brief       Run-to-completion step profiler for driver state machines
+ * @details     The profiler hooks the AO's dispatch entry, so the statistics are
+ *              only ever modified from the context of the owning AO.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#if !defined(__ARM_ARCH)
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_rtc_profiler.h"
+#include "driver_qs_records.h"
+
+#if defined(__ARM_ARCH)
+// Needed for the CMSIS DWT and CoreDebug definitions
+#include "mxc_device.h"
+#endif
+
+// Maximum number of AOs that can be profiled at the same time
+#define AO_RTC_PROFILER_MAX_AOS         4u
+
+/*! @struct ao_rtc_profiler_hook_t
+*   @brief  Link between a profiled AO, its profiler and its original dispatch
+*/
+typedef struct
+{
+    QHsm const *            hsm;                                /**< Profiled state machine >*/
+    ao_rtc_profiler_t *     profiler;                           /**< Statistics storage >*/
+    QActiveVtable           vtable;                             /**< Patched virtual table >*/
+    void                    (*dispatch)(QHsm * const me, QEvt const * const e,
+                                        uint_fast8_t const qs_id); /**< Original dispatch >*/
+} ao_rtc_profiler_hook_t;
+
+static ao_rtc_profiler_hook_t ao_rtc_profiler_hooks[AO_RTC_PROFILER_MAX_AOS];
+static uint8_t                ao_rtc_profiler_n_hooks = 0u;
+
+// Private functions
+static ao_rtc_profiler_hook_t * ao_rtc_profiler_find_hook(QHsm const * const hsm);
+
+static void ao_rtc_profiler_dispatch(QHsm * const me, QEvt const * const e, uint_fast8_t const qs_id);
+
+static void ao_rtc_profiler_record(ao_rtc_profiler_t * const profiler, QStateHandler state,
+                                   QSignal sig, uint32_t cost, uint8_t qs_id);
+
+static void ao_rtc_profiler_cycles_init(void);
+
+static uint32_t ao_rtc_profiler_cycles(void);
+
+/**
+*   @brief      Start profiling an active object
+*   @details    Must be called after QActive_ctor() and before the AO is started.
+*               An AO constructed again, as by a driver restart, keeps its hook.
+*   @param[in]  ao          - pointer to the active object to profile
+*   @param[in]  profiler    - statistics storage for this AO
+*   @param[out] nothing
+*   @return     bool        - false if all profiler hooks are in use
+*/
+bool ao_rtc_profiler_install(QActive * const ao, ao_rtc_profiler_t * const profiler)
+{
+    ao_rtc_profiler_hook_t * hook = ao_rtc_profiler_find_hook(&ao->super);
+
+    if (hook == NULL)
+    {
+        if (ao_rtc_profiler_n_hooks >= AO_RTC_PROFILER_MAX_AOS)
+        {
+            return false;
+        }
+
+        hook      = &ao_rtc_profiler_hooks[ao_rtc_profiler_n_hooks++];
+        hook->hsm = &ao->super;
+    }
+
+    ao_rtc_profiler_cycles_init();
+    ao_rtc_profiler_reset(profiler);
+
+    hook->profiler = profiler;
+
+    // Copy the AO's virtual table and patch the dispatch entry, unless still patched
+    if (ao->super.vptr != &hook->vtable.super)
+    {
+        hook->vtable                = *(QActiveVtable const *)ao->super.vptr;
+        hook->dispatch              = hook->vtable.super.dispatch;
+        hook->vtable.super.dispatch = &ao_rtc_profiler_dispatch;
+
+        ao->super.vptr = &hook->vtable.super;
+    }
+
+    return true;
+}
+
+/**
+*   @brief      Clear all statistics
+*/
+void ao_rtc_profiler_reset(ao_rtc_profiler_t * const profiler)
+{
+    memset(profiler, 0, sizeof(*profiler));
+}
+
+/**
+*   @brief      Look up the statistics of a (state, signal) pair
+*   @return     ao_rtc_profiler_entry_t - pointer to the entry, or NULL if never dispatched
+*/
+ao_rtc_profiler_entry_t const * ao_rtc_profiler_find(ao_rtc_profiler_t const * const profiler,
+                                                     QStateHandler state, QSignal sig)
+{
+    for (uint8_t i = 0u; i < profiler->n_entries; i++)
+    {
+        if ((profiler->entries[i].state == state) && (profiler->entries[i].sig == sig))
+        {
+            return &profiler->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+*   @brief      Export all statistics through QS user records
+*   @param[in]  profiler    - statistics storage
+*   @param[in]  qs_id       - QS id (AO priority) the records are attributed to
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_rtc_profiler_qs_dump(ao_rtc_profiler_t const * const profiler, uint8_t qs_id)
+{
+    (void)qs_id;    // unused when QS is disabled
+
+    for (uint8_t i = 0u; i < profiler->n_entries; i++)
+    {
+        ao_rtc_profiler_entry_t const * const entry = &profiler->entries[i];
+
+        QS_BEGIN_ID(DRIVER_QS_RTC_PROFILE, qs_id)
+            QS_FUN(entry->state);
+            QS_SIG(entry->sig, (void *)0);
+            QS_U32(0, entry->count);
+            QS_U32(0, entry->max);
+            QS_U32(0, (uint32_t)(entry->total / entry->count));
+            QS_U32(0, entry->overruns);
+        QS_END()
+
+        QS_BEGIN_ID(DRIVER_QS_RTC_PROFILE_HIST, qs_id)
+            QS_FUN(entry->state);
+            QS_SIG(entry->sig, (void *)0);
+            for (uint8_t bin = 0u; bin < AO_RTC_PROFILER_HIST_BINS; bin++)
+            {
+                QS_U32(0, entry->histogram[bin]);
+            }
+        QS_END()
+    }
+}
+
+/**
+*   @brief      Hook of a state machine
+*   @return     ao_rtc_profiler_hook_t - pointer to the hook, or NULL if never installed
+*/
+static ao_rtc_profiler_hook_t * ao_rtc_profiler_find_hook(QHsm const * const hsm)
+{
+    for (uint8_t i = 0u; i < ao_rtc_profiler_n_hooks; i++)
+    {
+        if (ao_rtc_profiler_hooks[i].hsm == hsm)
+        {
+            return &ao_rtc_profiler_hooks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+*   @brief      Dispatch wrapper installed in the AO's virtual table
+*/
+static void ao_rtc_profiler_dispatch(QHsm * const me, QEvt const * const e, uint_fast8_t const qs_id)
+{
+    ao_rtc_profiler_hook_t const * const hook = ao_rtc_profiler_find_hook(me);
+
+    Q_ASSERT(hook != NULL);
+
+    // The leaf state is captured before dispatch, since the step may change it
+    QStateHandler const state = me->state.fun;
+    QSignal const       sig   = e->sig;
+    uint32_t const      start = ao_rtc_profiler_cycles();
+
+    (*hook->dispatch)(me, e, qs_id);
+
+    ao_rtc_profiler_record(hook->profiler, state, sig, ao_rtc_profiler_cycles() - start, (uint8_t)qs_id);
+}
+
+/**
+*   @brief      Add one step to the statistics of its (state, signal) pair
+*/
+static void ao_rtc_profiler_record(ao_rtc_profiler_t * const profiler, QStateHandler state,
+                                   QSignal sig, uint32_t cost, uint8_t qs_id)
+{
+    ao_rtc_profiler_entry_t * entry = (ao_rtc_profiler_entry_t *)ao_rtc_profiler_find(profiler, state, sig);
+
+    (void)qs_id;    // unused when QS is disabled
+
+    if (entry == NULL)
+    {
+        if (profiler->n_entries >= AO_RTC_PROFILER_MAX_ENTRIES)
+        {
+            profiler->dropped++;
+            return;
+        }
+
+        entry        = &profiler->entries[profiler->n_entries++];
+        entry->state = state;
+        entry->sig   = sig;
+    }
+
+    entry->count++;
+    entry->total += cost;
+
+    if (cost > entry->max)
+    {
+        entry->max = cost;
+    }
+
+    uint32_t bound = (uint32_t)1u << AO_RTC_PROFILER_HIST_SHIFT;
+    uint8_t  bin   = 0u;
+
+    while ((cost >= bound) && (bin < (AO_RTC_PROFILER_HIST_BINS - 1u)))
+    {
+        bound <<= 1;
+        bin++;
+    }
+    entry->histogram[bin]++;
+
+    if (cost > AO_RTC_PROFILER_BUDGET_CYCLES)
+    {
+        entry->overruns++;
+
+        QS_BEGIN_ID(DRIVER_QS_RTC_OVERRUN, qs_id)
+            QS_FUN(state);
+            QS_SIG(sig, (void *)0);
+            QS_U32(0, cost);
+        QS_END()
+    }
+}
+
+#if defined(__ARM_ARCH)
+
+/**
+*   @brief      Enable the DWT cycle counter
+*/
+static void ao_rtc_profiler_cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+*   @brief      Current DWT cycle count
+*/
+static uint32_t ao_rtc_profiler_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+#else
+
+/**
+*   @brief      Nothing to enable on the host
+*/
+static void ao_rtc_profiler_cycles_init(void)
+{
+}
+
+/**
+*   @brief      Monotonic time in cycles of AO_RTC_PROFILER_HOST_CPU_MHZ, truncated to 32 bits
+*/
+static uint32_t ao_rtc_profiler_cycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    uint64_t const ns = ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+
+    return (uint32_t)((ns * AO_RTC_PROFILER_HOST_CPU_MHZ) / 1000u);
+}
+
+#endif
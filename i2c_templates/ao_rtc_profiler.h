@@ -0,0 +1,90 @@
+/**
+ * @file        ao_rtc_profiler.h
+ * @brief       Run-to-completion step profiler for driver state machines
+ * @details     Opt-in profiler, enabled by building with DRIVER_RTC_PROFILER.
+ *              ao_rtc_profiler_install() replaces the dispatch entry of the AO's
+ *              virtual table with a wrapper that measures every RTC step and
+ *              records it against the (state, signal) pair that was dispatched.
+ *              The state is the leaf state active when the event arrived.
+ *
+ *              Step cost is in CPU cycles on every build: read from the DWT cycle
+ *              counter on target, and on the host converted from clock_gettime()
+ *              at the nominal core clock AO_RTC_PROFILER_HOST_CPU_MHZ. The budget,
+ *              the histogram and the QS records therefore mean the same on both.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_RTC_PROFILER_H
+#define AO_RTC_PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qpc.h"
+
+// Maximum number of distinct (state, signal) pairs tracked per AO
+#define AO_RTC_PROFILER_MAX_ENTRIES     32u
+
+/**
+    @brief Number of step cost histogram bins.
+    Bin 0 holds steps below 2^AO_RTC_PROFILER_HIST_SHIFT cycles, each following
+    bin doubles the upper bound, and the last bin holds everything longer.
+*/
+#define AO_RTC_PROFILER_HIST_BINS       12u
+#define AO_RTC_PROFILER_HIST_SHIFT      6u
+
+/**
+    @brief Step cost above which an overrun record is emitted immediately.
+    Long RTC steps delay every lower priority AO, so keep this tight.
+*/
+#ifndef AO_RTC_PROFILER_BUDGET_CYCLES
+#define AO_RTC_PROFILER_BUDGET_CYCLES   20000u
+#endif
+
+/**
+    @brief Core clock the host measurement is converted at, in MHz.
+    Set it to the target's clock to read host profiles as target cycles.
+*/
+#ifndef AO_RTC_PROFILER_HOST_CPU_MHZ
+#define AO_RTC_PROFILER_HOST_CPU_MHZ    100u
+#endif
+
+/*! @struct ao_rtc_profiler_entry_t
+*   @brief  Statistics for one (state, signal) pair
+*/
+typedef struct
+{
+    QStateHandler           state;                              /**< Leaf state at dispatch time >*/
+    QSignal                 sig;                                /**< Dispatched signal >*/
+    uint32_t                count;                              /**< Number of steps >*/
+    uint64_t                total;                              /**< Sum of step costs >*/
+    uint32_t                max;                                /**< Longest step >*/
+    uint32_t                overruns;                           /**< Steps above the budget >*/
+    uint32_t                histogram[AO_RTC_PROFILER_HIST_BINS]; /**< Step cost histogram >*/
+} ao_rtc_profiler_entry_t;
+
+/*! @struct ao_rtc_profiler_t
+*   @brief  Per-AO profiler state
+*/
+typedef struct
+{
+    uint8_t                 n_entries;                          /**< Entries in use >*/
+    uint32_t                dropped;                            /**< Steps that did not fit in the table >*/
+    ao_rtc_profiler_entry_t entries[AO_RTC_PROFILER_MAX_ENTRIES]; /**< Per (state, signal) statistics >*/
+} ao_rtc_profiler_t;
+
+bool ao_rtc_profiler_install(QActive * const ao, ao_rtc_profiler_t * const profiler);
+
+void ao_rtc_profiler_reset(ao_rtc_profiler_t * const profiler);
+
+ao_rtc_profiler_entry_t const * ao_rtc_profiler_find(ao_rtc_profiler_t const * const profiler,
+                                                     QStateHandler state, QSignal sig);
+
+void ao_rtc_profiler_qs_dump(ao_rtc_profiler_t const * const profiler, uint8_t qs_id);
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file        ao_schedule.c
+ * @brief       Static time-triggered schedule of register batches
+ * @details     Releasing a frame is a clock read and a table lookup, so it adds
+ *              no variable work between the timer and the I2C request.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_schedule.h"
+#include "driver_qs_records.h"
+
+/**
+*   @brief      Set up a schedule from its tables, stopped
+*   @details    The tables are kept by reference. More than
+*               AO_SCHEDULE_MAX_BATCHES batches, a slot that names a missing
+*               batch, or a batch over AO_SCHEDULE_BATCH_READS reads or
+*               AO_SCHEDULE_BATCH_BYTES bytes, rejects the whole table.
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[in]  slots       - batch of each slot of the major cycle
+*   @param[in]  n_slots     - slots in the major cycle
+*   @param[in]  batches     - register batches
+*   @param[in]  n_batches   - number of batches
+*   @param[in]  frame_ms    - minor frame, the period of the driver timer
+*   @param[out] nothing
+*   @return     bool        - false if the tables are not valid
+*/
+bool ao_schedule_init(ao_schedule_t * const schedule, uint8_t const * const slots, uint8_t n_slots,
+                      ao_schedule_batch_t const * const batches, uint8_t n_batches, uint32_t frame_ms)
+{
+    memset(schedule, 0, sizeof(*schedule));
+
+    if ((n_slots == 0u) || (frame_ms == 0u) || (n_batches > AO_SCHEDULE_MAX_BATCHES))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0u; i < n_slots; i++)
+    {
+        if ((slots[i] != AO_SCHEDULE_NO_BATCH) && (slots[i] >= n_batches))
+        {
+            return false;
+        }
+    }
+
+    for (uint8_t i = 0u; i < n_batches; i++)
+    {
+        uint32_t bytes = 0u;
+
+        if ((batches[i].n_reads == 0u) || (batches[i].n_reads > AO_SCHEDULE_BATCH_READS))
+        {
+            return false;
+        }
+
+        for (uint8_t r = 0u; r < batches[i].n_reads; r++)
+        {
+            bytes += batches[i].reads[r].length;
+        }
+
+        if (bytes > AO_SCHEDULE_BATCH_BYTES)
+        {
+            return false;
+        }
+    }
+
+    schedule->slots = slots;
+    schedule->n_slots = n_slots;
+    schedule->batches = batches;
+    schedule->n_batches = n_batches;
+    schedule->period = AO_CLOCK_MS_TO_COUNTS(frame_ms);
+    return true;
+}
+
+/**
+*   @brief      Start the major cycle at its first slot
+*   @details    Called when the periodic timer is armed. The statistics restart,
+*               and the first release sets the time base of the ideal times: the
+*               timer is armed at some phase of its tick, so its first expiry is
+*               up to a tick short of a frame.
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_schedule_start(ao_schedule_t * const schedule)
+{
+    schedule->next_slot = 0u;
+    schedule->slot = 0u;
+    schedule->n_frames = 0u;
+    schedule->n_cycles = 0u;
+    schedule->n_overruns = 0u;
+
+    ao_jitter_init(&schedule->release);
+    for (uint8_t i = 0u; i < AO_SCHEDULE_MAX_BATCHES; i++)
+    {
+        ao_jitter_init(&schedule->dispatch[i]);
+    }
+}
+
+/**
+*   @brief      Release the next frame on a tick of the periodic timer
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[in]  overrun     - the batch of the previous frame is still on the bus
+*   @param[out] nothing
+*   @return     uint8_t     - batch to read in this frame, AO_SCHEDULE_NO_BATCH if none
+*/
+uint8_t ao_schedule_release(ao_schedule_t * const schedule, bool overrun)
+{
+    if (schedule->n_frames == 0u)
+    {
+        schedule->ideal = AO_CLOCK_NOW();
+    }
+
+    ao_jitter_observe(&schedule->release, ao_jitter_deviation_us(AO_CLOCK_NOW(), schedule->ideal));
+    schedule->n_frames++;
+
+    // The next ideal time follows the table, not this release
+    schedule->released_ideal = schedule->ideal;
+    schedule->ideal = (timer_count_t)(schedule->ideal + schedule->period);
+
+    schedule->slot = schedule->next_slot;
+    schedule->next_slot++;
+    if (schedule->next_slot >= schedule->n_slots)
+    {
+        schedule->next_slot = 0u;
+        schedule->n_cycles++;
+    }
+
+    uint8_t const batch = schedule->slots[schedule->slot];
+
+    if ((batch != AO_SCHEDULE_NO_BATCH) && overrun)
+    {
+        schedule->n_overruns++;
+        ao_jitter_miss(&schedule->dispatch[batch]);
+        return AO_SCHEDULE_NO_BATCH;
+    }
+
+    return batch;
+}
+
+/**
+*   @brief      Record when the batch of the last release was posted to the bus
+*   @param[in]  schedule        - pointer to the schedule
+*   @param[in]  batch           - batch returned by ao_schedule_release()
+*   @param[in]  dispatched_at   - AO clock time of the I2C request
+*   @param[out] nothing
+*   @return     int32_t         - deviation from the ideal time of the frame, us
+*/
+int32_t ao_schedule_dispatched(ao_schedule_t * const schedule, uint8_t batch, timer_count_t dispatched_at)
+{
+    int32_t const deviation_us = ao_jitter_deviation_us(dispatched_at, schedule->released_ideal);
+
+    if (batch < schedule->n_batches)
+    {
+        ao_jitter_observe(&schedule->dispatch[batch], deviation_us);
+    }
+
+    return deviation_us;
+}
+
+/**
+*   @brief      Batch by number, as returned by ao_schedule_release()
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[in]  batch       - batch number
+*   @param[out] nothing
+*   @return     ao_schedule_batch_t const * - batch, NULL if there is none
+*/
+ao_schedule_batch_t const * ao_schedule_get_batch(ao_schedule_t const * const schedule, uint8_t batch)
+{
+    return (batch < schedule->n_batches) ? &schedule->batches[batch] : NULL;
+}
+
+/**
+*   @brief      Release statistics since the schedule started
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[out] report      - statistics
+*   @return     nothing
+*/
+void ao_schedule_get_report(ao_schedule_t const * const schedule, ao_schedule_report_t * const report)
+{
+    ao_jitter_report_t release;
+
+    ao_jitter_get_report(&schedule->release, &release);
+
+    report->n_frames = schedule->n_frames;
+    report->n_cycles = schedule->n_cycles;
+    report->n_overruns = schedule->n_overruns;
+    report->last_us = release.last_us;
+    report->min_us = release.min_us;
+    report->max_us = release.max_us;
+    report->mean_abs_us = release.mean_abs_us;
+    report->p99_us = release.p99_us;
+}
+
+/**
+*   @brief      Dispatch jitter of one batch since the schedule started
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[in]  batch       - batch number
+*   @param[out] report      - statistics
+*   @return     bool        - false if there is no such batch
+*/
+bool ao_schedule_get_jitter(ao_schedule_t const * const schedule, uint8_t batch, ao_jitter_report_t * const report)
+{
+    if (batch >= schedule->n_batches)
+    {
+        return false;
+    }
+
+    ao_jitter_get_report(&schedule->dispatch[batch], report);
+    return true;
+}
+
+/**
+*   @brief      Export the release statistics through QS, then the jitter of each batch
+*   @param[in]  schedule    - pointer to the schedule
+*   @param[in]  qs_id       - QS id of the owning AO
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_schedule_qs_dump(ao_schedule_t const * const schedule, uint8_t qs_id)
+{
+    ao_schedule_report_t report;
+
+    (void)qs_id;    // unused when QS is disabled
+
+    ao_schedule_get_report(schedule, &report);
+
+    QS_BEGIN_ID(DRIVER_QS_SCHEDULE, qs_id)
+        QS_U32(0, report.n_frames);
+        QS_U32(0, report.n_cycles);
+        QS_U32(0, report.n_overruns);
+        QS_I32(0, report.min_us);
+        QS_I32(0, report.max_us);
+        QS_U32(0, report.mean_abs_us);
+        QS_U32(0, report.p99_us);
+    QS_END()
+
+    // The stream of a batch is its number
+    for (uint8_t batch = 0u; batch < schedule->n_batches; batch++)
+    {
+        ao_jitter_qs_dump(&schedule->dispatch[batch], batch, qs_id);
+    }
+}
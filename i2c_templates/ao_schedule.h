@@ -0,0 +1,120 @@
+/**
+ * @file        ao_schedule.h
+ * @brief       Static time-triggered schedule of register batches
+ * @details     A cyclic executive for drivers that sample on a fixed period.
+ *              The major cycle is a compile-time table of slots, one per minor
+ *              frame; each slot names the register batch read in that frame, or
+ *              AO_SCHEDULE_NO_BATCH. A driver releases one frame per tick of a
+ *              single periodic timer and reads the batch of the slot.
+ *
+ *              Every release is compared with its ideal time, the first release
+ *              plus a whole number of frames, so the jitter figures include any
+ *              drift and not only the spread between neighbouring frames. A
+ *              frame released while the previous batch is still on the bus is an
+ *              overrun: its batch is skipped, the table is not shifted.
+ *
+ *              Each batch is also a stream of its own: the driver reports when it
+ *              actually posted the batch to the bus, and the deviation from the
+ *              ideal time of its frame goes to the ao_jitter.h tracker of the
+ *              batch. Overruns count as missed periods of the batch skipped.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_SCHEDULE_H
+#define AO_SCHEDULE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ao_clock.h"
+#include "ao_jitter.h"
+
+// Register reads in one batch, issued as one I2C request
+#define AO_SCHEDULE_BATCH_READS         2u
+
+// Bytes read by one batch, all reads together
+#define AO_SCHEDULE_BATCH_BYTES         16u
+
+// Batches in one table, each has a jitter tracker
+#define AO_SCHEDULE_MAX_BATCHES         4u
+
+// Slot without a batch, the bus is left free for that frame
+#define AO_SCHEDULE_NO_BATCH            0xFFu
+
+/*! @struct ao_schedule_read_t
+*   @brief  One register read of a batch
+*/
+typedef struct
+{
+    uint16_t                reg;                                /**< First register, the device auto-increments >*/
+    uint8_t                 length;
+} ao_schedule_read_t;
+
+/*! @struct ao_schedule_batch_t
+*   @brief  Registers read together in one frame
+*/
+typedef struct
+{
+    ao_schedule_read_t      reads[AO_SCHEDULE_BATCH_READS];
+    uint8_t                 n_reads;
+} ao_schedule_batch_t;
+
+/*! @struct ao_schedule_report_t
+*   @brief  Release jitter of the frames so far, deviations are late when positive
+*/
+typedef struct
+{
+    uint32_t                n_frames;
+    uint32_t                n_cycles;                           /**< Major cycles completed >*/
+    uint32_t                n_overruns;                         /**< Frames skipped, previous batch still on the bus >*/
+    int32_t                 last_us;
+    int32_t                 min_us;
+    int32_t                 max_us;
+    uint32_t                mean_abs_us;                        /**< Mean of the absolute deviations >*/
+    uint32_t                p99_us;
+} ao_schedule_report_t;
+
+/*! @struct ao_schedule_t
+*   @brief  Schedule table and its release statistics
+*/
+typedef struct
+{
+    uint8_t const *             slots;                          /**< Batch of each slot of the major cycle >*/
+    ao_schedule_batch_t const * batches;
+    uint8_t                     n_slots;
+    uint8_t                     n_batches;
+    timer_count_t               period;                         /**< Minor frame, AO clock counts >*/
+    timer_count_t               ideal;                          /**< Ideal time of the next release >*/
+    timer_count_t               released_ideal;                 /**< Ideal time of the last release >*/
+    uint8_t                     next_slot;
+    uint8_t                     slot;                           /**< Slot of the last release >*/
+    uint32_t                    n_frames;
+    uint32_t                    n_cycles;
+    uint32_t                    n_overruns;
+    ao_jitter_t                 release;                        /**< Frame releases against their ideal time >*/
+    ao_jitter_t                 dispatch[AO_SCHEDULE_MAX_BATCHES];  /**< Batch dispatches, per batch >*/
+} ao_schedule_t;
+
+bool ao_schedule_init(ao_schedule_t * const schedule, uint8_t const * const slots, uint8_t n_slots,
+                      ao_schedule_batch_t const * const batches, uint8_t n_batches, uint32_t frame_ms);
+
+void ao_schedule_start(ao_schedule_t * const schedule);
+
+uint8_t ao_schedule_release(ao_schedule_t * const schedule, bool overrun);
+
+int32_t ao_schedule_dispatched(ao_schedule_t * const schedule, uint8_t batch, timer_count_t dispatched_at);
+
+ao_schedule_batch_t const * ao_schedule_get_batch(ao_schedule_t const * const schedule, uint8_t batch);
+
+void ao_schedule_get_report(ao_schedule_t const * const schedule, ao_schedule_report_t * const report);
+
+bool ao_schedule_get_jitter(ao_schedule_t const * const schedule, uint8_t batch, ao_jitter_report_t * const report);
+
+void ao_schedule_qs_dump(ao_schedule_t const * const schedule, uint8_t qs_id);
+
+#endif
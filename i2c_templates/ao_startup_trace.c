@@ -0,0 +1,97 @@
+/**
+ * @file        ao_startup_trace.c
+ * @brief       Timestamps of the steps of a driver bring-up
+ * @details     Marking is one clock read and a store, cheap enough to leave in
+ *              production builds.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_startup_trace.h"
+#include "driver_qs_records.h"
+
+/**
+*   @brief      Start a new bring-up, forgetting the previous one
+*   @param[in]  trace       - pointer to the trace
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_startup_trace_begin(ao_startup_trace_t * const trace)
+{
+    memset(trace, 0, sizeof(*trace));
+
+    trace->begin = AO_CLOCK_NOW();
+}
+
+/**
+*   @brief      Record the time of a step, unless it was already marked
+*   @param[in]  trace       - pointer to the trace
+*   @param[in]  step        - step number, below AO_STARTUP_TRACE_MAX_STEPS
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_startup_trace_mark(ao_startup_trace_t * const trace, uint8_t step)
+{
+    uint8_t const bit = (uint8_t)(1u << step);
+
+    if ((step >= AO_STARTUP_TRACE_MAX_STEPS) || ((trace->marked & bit) != 0u))
+    {
+        return;
+    }
+
+    trace->at[step] = AO_CLOCK_NOW();
+    trace->marked  |= bit;
+}
+
+/**
+*   @brief      Time of a step since the trace began
+*   @param[in]  trace           - pointer to the trace
+*   @param[in]  step            - step number
+*   @param[out] since_begin_us  - microseconds from begin() to the step
+*   @return     bool            - false if the step was not reached
+*/
+bool ao_startup_trace_get_us(ao_startup_trace_t const * const trace, uint8_t step, uint32_t * const since_begin_us)
+{
+    if ((step >= AO_STARTUP_TRACE_MAX_STEPS) || ((trace->marked & (1u << step)) == 0u))
+    {
+        return false;
+    }
+
+    *since_begin_us = AO_CLOCK_COUNTS_TO_US((timer_count_t)(trace->at[step] - trace->begin));
+    return true;
+}
+
+/**
+*   @brief      Export the marked steps through QS, one record per step
+*   @param[in]  trace       - pointer to the trace
+*   @param[in]  qs_id       - QS id of the owning AO
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_startup_trace_qs_dump(ao_startup_trace_t const * const trace, uint8_t qs_id)
+{
+    (void)qs_id;    // unused when QS is disabled
+
+    for (uint8_t step = 0u; step < AO_STARTUP_TRACE_MAX_STEPS; step++)
+    {
+        uint32_t since_begin_us = 0u;
+
+        if (!ao_startup_trace_get_us(trace, step, &since_begin_us))
+        {
+            continue;
+        }
+
+        QS_BEGIN_ID(DRIVER_QS_STARTUP_STEP, qs_id)
+            QS_U8(0, step);
+            QS_U32(0, (uint32_t)trace->at[step]);
+            QS_U32(0, since_begin_us);
+        QS_END()
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file        ao_startup_trace.h
+ * @brief       Timestamps of the steps of a driver bring-up
+ * @details     Each AO keeps its own trace and marks its steps with the AO clock,
+ *              so the traces of a driver stack, or of several stacks starting at
+ *              once, can be merged on the host by timestamp. Steps are numbered
+ *              by the driver; the first mark of a step after begin() counts.
+ *
+ *              Exported through QS as DRIVER_QS_STARTUP_STEP records: step (U8),
+ *              AO clock time (U32) and time since the trace began (U32).
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_STARTUP_TRACE_H
+#define AO_STARTUP_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ao_clock.h"
+
+// Steps a driver can mark
+#define AO_STARTUP_TRACE_MAX_STEPS      8u
+
+/*! @struct ao_startup_trace_t
+*   @brief  Step timestamps of the last bring-up
+*/
+typedef struct
+{
+    timer_count_t           begin;                              /**< AO clock time of begin() >*/
+    timer_count_t           at[AO_STARTUP_TRACE_MAX_STEPS];
+    uint8_t                 marked;                             /**< One bit per step seen >*/
+} ao_startup_trace_t;
+
+void ao_startup_trace_begin(ao_startup_trace_t * const trace);
+
+void ao_startup_trace_mark(ao_startup_trace_t * const trace, uint8_t step);
+
+bool ao_startup_trace_get_us(ao_startup_trace_t const * const trace, uint8_t step, uint32_t * const since_begin_us);
+
+void ao_startup_trace_qs_dump(ao_startup_trace_t const * const trace, uint8_t qs_id);
+
+#endif
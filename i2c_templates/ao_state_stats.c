@@ -0,0 +1,142 @@
+/**
+ * @file        ao_state_stats.c
+ * @brief       Per-state dwell time and transition count statistics
+ * @details     Updates happen in the context of the owning AO, on entry and exit
+ *              only, so the per-event cost is a couple of stores.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_state_stats.h"
+#include "driver_qs_records.h"
+
+/**
+*   @brief      Reset the statistics
+*   @param[in]  stats       - pointer to the statistics
+*   @param[in]  n_states    - number of states the AO tracks
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_state_stats_init(ao_state_stats_t * const stats, uint8_t n_states)
+{
+    Q_REQUIRE(n_states <= AO_STATE_STATS_MAX_STATES);
+
+    memset(stats, 0, sizeof(*stats));
+
+    stats->started_at = AO_CLOCK_NOW();
+    stats->n_states   = n_states;
+}
+
+/**
+*   @brief      Record entry into a state
+*   @param[in]  stats       - pointer to the statistics
+*   @param[in]  state       - AO specific state number
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_state_stats_enter(ao_state_stats_t * const stats, uint8_t state)
+{
+    Q_REQUIRE(state < stats->n_states);
+
+    ao_state_stats_entry_t * const entry = &stats->states[state];
+
+    entry->active     = true;
+    entry->entered_at = AO_CLOCK_NOW();
+    entry->n_entries++;
+
+    stats->n_transitions++;
+}
+
+/**
+*   @brief      Record exit from a state and close its visit
+*   @param[in]  stats       - pointer to the statistics
+*   @param[in]  state       - AO specific state number
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_state_stats_exit(ao_state_stats_t * const stats, uint8_t state)
+{
+    Q_REQUIRE(state < stats->n_states);
+
+    ao_state_stats_entry_t * const entry = &stats->states[state];
+
+    if (entry->active)
+    {
+        timer_count_t dwell = AO_CLOCK_NOW() - entry->entered_at;
+
+        entry->active       = false;
+        entry->dwell_total += dwell;
+
+        if (dwell > entry->dwell_max)
+        {
+            entry->dwell_max = dwell;
+        }
+    }
+}
+
+/**
+*   @brief      Fill in a snapshot of one state
+*   @param[in]  stats       - pointer to the statistics
+*   @param[in]  state       - AO specific state number
+*   @param[out] report      - snapshot to fill in
+*   @return     bool        - false if the state number is out of range
+*/
+bool ao_state_stats_get_report(ao_state_stats_t const * const stats, uint8_t state,
+                               ao_state_stats_report_t * const report)
+{
+    if (state >= stats->n_states)
+    {
+        return false;
+    }
+
+    ao_state_stats_entry_t const * const entry = &stats->states[state];
+    timer_count_t now     = AO_CLOCK_NOW();
+    timer_count_t current = entry->active ? (timer_count_t)(now - entry->entered_at) : 0u;
+    uint64_t      uptime  = (timer_count_t)(now - stats->started_at);
+
+    report->active      = entry->active;
+    report->n_entries   = entry->n_entries;
+    report->dwell_total = entry->dwell_total + current;
+    report->dwell_max   = (current > entry->dwell_max) ? current : entry->dwell_max;
+    report->permille    = (uptime == 0u) ? 0u : (uint16_t)((report->dwell_total * 1000u) / uptime);
+
+    return true;
+}
+
+/**
+*   @brief      Export the statistics of every state through QS user records
+*   @param[in]  stats       - pointer to the statistics
+*   @param[in]  names       - human readable state names, indexed by state number
+*   @param[in]  qs_id       - QS id (AO priority) the records are attributed to
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_state_stats_qs_dump(ao_state_stats_t const * const stats, char const * const * names,
+                            uint8_t qs_id)
+{
+    ao_state_stats_report_t report;
+
+    (void)names;    // unused when QS is disabled
+    (void)qs_id;
+
+    for (uint8_t state = 0u; state < stats->n_states; state++)
+    {
+        (void)ao_state_stats_get_report(stats, state, &report);
+
+        QS_BEGIN_ID(DRIVER_QS_STATE_STATS, qs_id)
+            QS_STR(names[state]);
+            QS_U8(0, report.active);
+            QS_U32(0, report.n_entries);
+            QS_U32(0, AO_CLOCK_COUNTS_TO_MS(report.dwell_total));
+            QS_U32(0, AO_CLOCK_COUNTS_TO_MS(report.dwell_max));
+            QS_U16(0, report.permille);
+        QS_END()
+    }
+}
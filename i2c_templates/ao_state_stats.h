@@ -0,0 +1,75 @@
+/**
+ * @file        ao_state_stats.h
+ * @brief       Per-state dwell time and transition count statistics
+ * @details     Each driver numbers its states and calls ao_state_stats_enter()
+ *              on Q_ENTRY_SIG and ao_state_stats_exit() on Q_EXIT_SIG. Because
+ *              QP delivers entry/exit to every state along a transition path,
+ *              superstates (e.g. busy) are accounted for independently of their
+ *              substates (read, write).
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_STATE_STATS_H
+#define AO_STATE_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ao_clock.h"
+
+// Maximum number of states tracked per AO
+#define AO_STATE_STATS_MAX_STATES       10u
+
+/*! @struct ao_state_stats_entry_t
+*   @brief  Statistics for one state
+*/
+typedef struct
+{
+    bool                    active;                             /**< State is currently entered >*/
+    timer_count_t           entered_at;                         /**< Time of the last entry >*/
+    uint32_t                n_entries;                          /**< Number of times the state was entered >*/
+    uint64_t                dwell_total;                        /**< Time spent in the state, completed visits >*/
+    timer_count_t           dwell_max;                          /**< Longest completed visit >*/
+} ao_state_stats_entry_t;
+
+/*! @struct ao_state_stats_t
+*   @brief  Per-AO state statistics
+*/
+typedef struct
+{
+    timer_count_t           started_at;                         /**< Time the statistics were reset >*/
+    uint32_t                n_transitions;                      /**< Total number of state entries >*/
+    uint8_t                 n_states;                           /**< Number of states in use >*/
+    ao_state_stats_entry_t  states[AO_STATE_STATS_MAX_STATES];  /**< Per state statistics >*/
+} ao_state_stats_t;
+
+/*! @struct ao_state_stats_report_t
+*   @brief  Exported snapshot of one state, including the current visit
+*/
+typedef struct
+{
+    bool                    active;                             /**< State is currently entered >*/
+    uint32_t                n_entries;                          /**< Number of times the state was entered >*/
+    uint64_t                dwell_total;                        /**< Time spent in the state >*/
+    timer_count_t           dwell_max;                          /**< Longest visit >*/
+    uint16_t                permille;                           /**< Fraction of time since reset >*/
+} ao_state_stats_report_t;
+
+void ao_state_stats_init(ao_state_stats_t * const stats, uint8_t n_states);
+
+void ao_state_stats_enter(ao_state_stats_t * const stats, uint8_t state);
+
+void ao_state_stats_exit(ao_state_stats_t * const stats, uint8_t state);
+
+bool ao_state_stats_get_report(ao_state_stats_t const * const stats, uint8_t state,
+                               ao_state_stats_report_t * const report);
+
+void ao_state_stats_qs_dump(ao_state_stats_t const * const stats, char const * const * names,
+                            uint8_t qs_id);
+
+#endif
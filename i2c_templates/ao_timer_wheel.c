@@ -0,0 +1,355 @@
+/**
+ * @file        ao_timer_wheel.c
+ * @brief       Hierarchical timing wheel shared by the driver timeouts
+ * @details     Drivers arm and disarm from their own AOs, possibly preempting
+ *              the host, so the slot lists are only touched with interrupts
+ *              disabled. Expired timers are taken off one at a time and posted
+ *              outside the critical section.
+ *
+ *              The tick QTimeEvt is a one-shot the host re-arms from the tick
+ *              while timers are armed, so it never has to be disarmed under a
+ *              racing arm. A tick the host handles late delays the wheel:
+ *              timeouts can run late, never early.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ao_timer_wheel.h"
+
+#define AO_TIMER_WHEEL_SLOT_MASK        (AO_TIMER_WHEEL_SLOTS - 1u)
+
+#ifdef DRIVER_TIMER_WHEEL
+// The tick event is a one-shot, at most one is pending
+#define AO_TIMER_WHEEL_HOST_QUEUE_SIZE  2u
+
+// Signal of the tick, the host handles nothing else
+enum
+{
+    AO_TIMER_WHEEL_TICK_SIG = Q_USER_SIG,
+};
+
+// Wheel of all driver timers, see AO_TIMER_ARM
+ao_timer_wheel_t g_ao_timer_wheel;
+
+// AO that ticks g_ao_timer_wheel
+static QActive l_ao_timer_wheel_host;
+
+static QEvt const * ao_timer_wheel_host_que_sto[AO_TIMER_WHEEL_HOST_QUEUE_SIZE];
+
+// state functions
+static QState ao_timer_wheel_host_initial  (QActive * const me, QEvt const * const e);
+static QState ao_timer_wheel_host_active   (QActive * const me, QEvt const * const e);
+#endif
+
+// Private functions
+static void ao_timer_wheel_unlink(ao_timer_wheel_link_t * const link);
+
+static void ao_timer_wheel_insert(ao_timer_wheel_t * const wheel, ao_timer_wheel_timer_t * const timer);
+
+static void ao_timer_wheel_cascade(ao_timer_wheel_t * const wheel, uint8_t level);
+
+/**
+*   @brief      Take a link out of its list
+*/
+static void ao_timer_wheel_unlink(ao_timer_wheel_link_t * const link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = link;
+    link->prev = link;
+}
+
+/**
+*   @brief      Put a timer in the slot of its expiry, the level follows how far away it is
+*/
+static void ao_timer_wheel_insert(ao_timer_wheel_t * const wheel, ao_timer_wheel_timer_t * const timer)
+{
+    uint32_t const delta = timer->expires - wheel->now;
+    uint8_t level = 0u;
+
+    while ((level < (AO_TIMER_WHEEL_LEVELS - 1u))
+           && (delta >= (1u << (AO_TIMER_WHEEL_SLOT_BITS * (level + 1u)))))
+    {
+        level++;
+    }
+
+    uint32_t const index = (timer->expires >> (AO_TIMER_WHEEL_SLOT_BITS * level)) & AO_TIMER_WHEEL_SLOT_MASK;
+    ao_timer_wheel_link_t * const head = &wheel->slots[level][index];
+
+    timer->link.next = head->next;
+    timer->link.prev = head;
+    head->next->prev = &timer->link;
+    head->next = &timer->link;
+}
+
+/**
+*   @brief      Move the timers of the current slot of a level down to the levels below
+*/
+static void ao_timer_wheel_cascade(ao_timer_wheel_t * const wheel, uint8_t level)
+{
+    uint32_t const index = (wheel->now >> (AO_TIMER_WHEEL_SLOT_BITS * level)) & AO_TIMER_WHEEL_SLOT_MASK;
+    ao_timer_wheel_link_t * const head = &wheel->slots[level][index];
+
+    while (head->next != head)
+    {
+        ao_timer_wheel_link_t * const link = head->next;
+
+        ao_timer_wheel_unlink(link);
+        ao_timer_wheel_insert(wheel, (ao_timer_wheel_timer_t *)link);
+        wheel->n_cascaded++;
+    }
+}
+
+/**
+*   @brief      Empty the wheel and name the AO that ticks it
+*   @details    The host handles tick_sig by calling ao_timer_wheel_tick().
+*   @param[in]  wheel       - pointer to the wheel
+*   @param[in]  host        - AO the tick event is posted to
+*   @param[in]  tick_sig    - signal of the tick event
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_timer_wheel_init(ao_timer_wheel_t * const wheel, QActive * const host, enum_t tick_sig)
+{
+    memset(wheel, 0, sizeof(*wheel));
+
+    for (uint8_t level = 0u; level < AO_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (uint8_t slot = 0u; slot < AO_TIMER_WHEEL_SLOTS; slot++)
+        {
+            wheel->slots[level][slot].next = &wheel->slots[level][slot];
+            wheel->slots[level][slot].prev = &wheel->slots[level][slot];
+        }
+    }
+
+    QTimeEvt_ctorX(&wheel->tick_evt, host, tick_sig, 0U);
+}
+
+/**
+*   @brief      Set up a timer, disarmed
+*   @param[in]  timer       - pointer to the timer
+*   @param[in]  act         - AO the timeout is posted to
+*   @param[in]  sig         - signal of the timeout
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_timer_wheel_timer_ctor(ao_timer_wheel_timer_t * const timer, QActive * const act, enum_t sig)
+{
+    memset(timer, 0, sizeof(*timer));
+
+    timer->link.next = &timer->link;
+    timer->link.prev = &timer->link;
+    timer->evt.sig = (QSignal)sig;
+    timer->act = act;
+}
+
+/**
+*   @brief      Arm a timer, re-arming it if it already is
+*   @param[in]  wheel       - pointer to the wheel
+*   @param[in]  timer       - pointer to the timer
+*   @param[in]  ticks       - ticks to expiry, at least 1, clamped to AO_TIMER_WHEEL_MAX_TICKS
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_timer_wheel_arm(ao_timer_wheel_t * const wheel, ao_timer_wheel_timer_t * const timer, uint32_t ticks)
+{
+    bool start = false;
+
+    if (ticks == 0u)
+    {
+        ticks = 1u;
+    }
+    else if (ticks > AO_TIMER_WHEEL_MAX_TICKS)
+    {
+        ticks = AO_TIMER_WHEEL_MAX_TICKS;
+    }
+
+    QF_INT_DISABLE();
+
+    if (timer->armed)
+    {
+        ao_timer_wheel_unlink(&timer->link);
+    }
+    else
+    {
+        timer->armed = true;
+        wheel->n_armed++;
+    }
+
+    timer->expires = wheel->now + ticks;
+    ao_timer_wheel_insert(wheel, timer);
+
+    start = !wheel->ticking;
+    wheel->ticking = true;
+
+    QF_INT_ENABLE();
+
+    if (start)
+    {
+        QTimeEvt_armX(&wheel->tick_evt, 1U, 0U);
+    }
+}
+
+/**
+*   @brief      Disarm a timer
+*   @param[in]  wheel       - pointer to the wheel
+*   @param[in]  timer       - pointer to the timer
+*   @param[out] nothing
+*   @return     bool        - true if it was armed, as QTimeEvt_disarm()
+*/
+bool ao_timer_wheel_disarm(ao_timer_wheel_t * const wheel, ao_timer_wheel_timer_t * const timer)
+{
+    bool was_armed = false;
+
+    QF_INT_DISABLE();
+
+    if (timer->armed)
+    {
+        ao_timer_wheel_unlink(&timer->link);
+        timer->armed = false;
+        wheel->n_armed--;
+        was_armed = true;
+    }
+
+    QF_INT_ENABLE();
+
+    return was_armed;
+}
+
+/**
+*   @brief      Advance the wheel one tick and post the timeouts that expire
+*   @details    Called by the host on its tick signal.
+*   @param[in]  wheel       - pointer to the wheel
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_timer_wheel_tick(ao_timer_wheel_t * const wheel)
+{
+    bool rearm = false;
+
+    QF_INT_DISABLE();
+
+    wheel->now++;
+
+    // At the start of each slot of a level, its timers move down
+    for (uint8_t level = 1u; level < AO_TIMER_WHEEL_LEVELS; level++)
+    {
+        if ((wheel->now & ((1u << (AO_TIMER_WHEEL_SLOT_BITS * level)) - 1u)) != 0u)
+        {
+            break;
+        }
+        ao_timer_wheel_cascade(wheel, level);
+    }
+
+    QF_INT_ENABLE();
+
+    ao_timer_wheel_link_t * const head = &wheel->slots[0][wheel->now & AO_TIMER_WHEEL_SLOT_MASK];
+
+    for (;;)
+    {
+        ao_timer_wheel_timer_t * timer = NULL;
+
+        QF_INT_DISABLE();
+
+        if (head->next != head)
+        {
+            timer = (ao_timer_wheel_timer_t *)head->next;
+            ao_timer_wheel_unlink(&timer->link);
+            timer->armed = false;
+            wheel->n_armed--;
+            wheel->n_expired++;
+        }
+
+        QF_INT_ENABLE();
+
+        if (timer == NULL)
+        {
+            break;
+        }
+
+        QACTIVE_POST(timer->act, &timer->evt, wheel);
+    }
+
+    QF_INT_DISABLE();
+
+    rearm = (wheel->n_armed > 0u);
+    wheel->ticking = rearm;
+
+    QF_INT_ENABLE();
+
+    if (rearm)
+    {
+        QTimeEvt_armX(&wheel->tick_evt, 1U, 0U);
+    }
+}
+
+#ifdef DRIVER_TIMER_WHEEL
+/**
+*   @brief      Initial state as required by QP
+*/
+static QState ao_timer_wheel_host_initial(QActive * const me, QEvt const * const e)
+{
+    (void)e;    // avoid compiler warning
+
+    QS_OBJ_DICTIONARY(me);
+    QS_FUN_DICTIONARY(&ao_timer_wheel_host_initial);
+    QS_FUN_DICTIONARY(&ao_timer_wheel_host_active);
+
+    return Q_TRAN(&ao_timer_wheel_host_active);
+}
+
+/**
+*   @brief      Advance the driver timers on each tick
+*/
+static QState ao_timer_wheel_host_active(QActive * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&QHsm_top);
+
+    (void)me;   // avoid compiler warning
+
+    switch (e->sig)
+    {
+        case AO_TIMER_WHEEL_TICK_SIG:
+        {
+            ao_timer_wheel_tick(&g_ao_timer_wheel);
+            status = Q_HANDLED();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+/**
+*   @brief      Set up g_ao_timer_wheel and start the AO that ticks it
+*   @details    Called once by the application, after QF_init() and before any
+*               AO that arms a driver timer. Above the drivers, their timeouts
+*               are not held up by their own work.
+*   @param[in]  priority    - unique QP priority
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_timer_wheel_start(uint8_t priority)
+{
+    QActive_ctor(&l_ao_timer_wheel_host, (QStateHandler)&ao_timer_wheel_host_initial);
+    ao_timer_wheel_init(&g_ao_timer_wheel, &l_ao_timer_wheel_host, AO_TIMER_WHEEL_TICK_SIG);
+
+    QACTIVE_START(&l_ao_timer_wheel_host,
+                  priority,
+                  ao_timer_wheel_host_que_sto,
+                  Q_DIM(ao_timer_wheel_host_que_sto),
+                  (void *)0,
+                  0U,
+                  (QEvt *)0);
+}
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file        ao_timer_wheel.h
+ * @brief       Hierarchical timing wheel shared by the driver timeouts
+ * @details     Every armed QTimeEvt is visited by QF on every tick, so the tick
+ *              costs grow with the number of drivers. Built with
+ *              DRIVER_TIMER_WHEEL, the driver timers live in one wheel instead,
+ *              and a single QTimeEvt, armed only while a driver timer is,
+ *              ticks it.
+ *
+ *              AO_TIMER_WHEEL_LEVELS levels of AO_TIMER_WHEEL_SLOTS slots cover
+ *              timeouts up to AO_TIMER_WHEEL_SLOTS ^ AO_TIMER_WHEEL_LEVELS - 1
+ *              ticks; longer ones are clamped. Arm and disarm are O(1). A tick
+ *              costs one slot of the lowest level, plus one slot of an upper level
+ *              every AO_TIMER_WHEEL_SLOTS ticks, whose timers move down a level.
+ *              Neither depends on the number of armed timers.
+ *
+ *              A timer posts its own static event to its AO, like a QTimeEvt.
+ *              Drivers use the AO_TIMER_* macros, which map to QTimeEvt without
+ *              DRIVER_TIMER_WHEEL.
+ *
+ *              One AO hosts the wheel, see ao_timer_wheel_init(). With
+ *              DRIVER_TIMER_WHEEL the application starts it once with
+ *              ao_timer_wheel_start(), before any AO that arms a driver timer;
+ *              the drivers are only clients of the AO_TIMER_* macros.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_TIMER_WHEEL_H
+#define AO_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qpc.h"
+#include "whoop_qp_time.h"
+
+#define AO_TIMER_WHEEL_SLOT_BITS        5u
+#define AO_TIMER_WHEEL_SLOTS            (1u << AO_TIMER_WHEEL_SLOT_BITS)
+#define AO_TIMER_WHEEL_LEVELS           3u
+
+// Longest timeout the wheel holds, in ticks
+#define AO_TIMER_WHEEL_MAX_TICKS        ((1u << (AO_TIMER_WHEEL_SLOT_BITS * AO_TIMER_WHEEL_LEVELS)) - 1u)
+
+/*! @struct ao_timer_wheel_link_t
+*   @brief  Links of a timer in its slot, slots hold an empty link as list head
+*/
+typedef struct ao_timer_wheel_link
+{
+    struct ao_timer_wheel_link *    next;
+    struct ao_timer_wheel_link *    prev;
+} ao_timer_wheel_link_t;
+
+/*! @struct ao_timer_wheel_timer_t
+*   @brief  One driver timeout
+*/
+typedef struct
+{
+    ao_timer_wheel_link_t   link;                               /**< First, the slot lists hold links >*/
+    QEvt                    evt;                                /**< Posted on expiry >*/
+    QActive *               act;                                /**< AO the event is posted to >*/
+    uint32_t                expires;                            /**< Wheel tick of expiry >*/
+    bool                    armed;
+} ao_timer_wheel_timer_t;
+
+/*! @struct ao_timer_wheel_t
+*   @brief  The wheel and the QTimeEvt that ticks it
+*/
+typedef struct
+{
+    ao_timer_wheel_link_t   slots[AO_TIMER_WHEEL_LEVELS][AO_TIMER_WHEEL_SLOTS];
+    QTimeEvt                tick_evt;                           /**< Re-armed each tick while timers are armed >*/
+    bool                    ticking;                            /**< tick_evt armed or its event pending >*/
+    uint32_t                now;                                /**< Ticks counted since init >*/
+    uint16_t                n_armed;
+    uint32_t                n_expired;
+    uint32_t                n_cascaded;                         /**< Timers moved down a level >*/
+} ao_timer_wheel_t;
+
+void ao_timer_wheel_init(ao_timer_wheel_t * const wheel, QActive * const host, enum_t tick_sig);
+
+void ao_timer_wheel_timer_ctor(ao_timer_wheel_timer_t * const timer, QActive * const act, enum_t sig);
+
+void ao_timer_wheel_arm(ao_timer_wheel_t * const wheel, ao_timer_wheel_timer_t * const timer, uint32_t ticks);
+
+bool ao_timer_wheel_disarm(ao_timer_wheel_t * const wheel, ao_timer_wheel_timer_t * const timer);
+
+void ao_timer_wheel_tick(ao_timer_wheel_t * const wheel);
+
+#ifdef DRIVER_TIMER_WHEEL
+extern ao_timer_wheel_t g_ao_timer_wheel;
+
+void ao_timer_wheel_start(uint8_t priority);
+
+typedef ao_timer_wheel_timer_t  ao_timer_t;
+#define AO_TIMER_CTOR(t_, act_, sig_)   ao_timer_wheel_timer_ctor((t_), (act_), (sig_))
+#define AO_TIMER_ARM(t_, ticks_)        ao_timer_wheel_arm(&g_ao_timer_wheel, (t_), (ticks_))
+#define AO_TIMER_DISARM(t_)             ao_timer_wheel_disarm(&g_ao_timer_wheel, (t_))
+#else
+typedef QTimeEvt                ao_timer_t;
+#define AO_TIMER_CTOR(t_, act_, sig_)   QTimeEvt_ctorX((t_), (act_), (sig_), 0U)
+#define AO_TIMER_ARM(t_, ticks_)        whoop_qp_time_safe_arm((t_), (ticks_), 0U)
+#define AO_TIMER_DISARM(t_)             QTimeEvt_disarm(t_)
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file        ao_unhandled.c
+ * @brief       Per-signal counters of events no state handled
+ * @details     Counting happens in the context of the owning AO; signal names
+ *              are left to QSpy, which has them from the signal dictionaries.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "ao_unhandled.h"
+#include "driver_qs_records.h"
+
+/**
+*   @brief      Reset the counters
+*   @param[in]  unhandled   - pointer to the counters
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_unhandled_init(ao_unhandled_t * const unhandled)
+{
+    memset(unhandled, 0, sizeof(*unhandled));
+}
+
+/**
+*   @brief      Count one unhandled event
+*   @param[in]  unhandled   - pointer to the counters
+*   @param[in]  sig         - signal of the event
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_unhandled_count(ao_unhandled_t * const unhandled, QSignal sig)
+{
+    ao_unhandled_entry_t * entry = NULL;
+
+    for (uint8_t i = 0u; i < unhandled->n_sigs; i++)
+    {
+        if (unhandled->sigs[i].sig == sig)
+        {
+            entry = &unhandled->sigs[i];
+            break;
+        }
+    }
+
+    if ((entry == NULL) && (unhandled->n_sigs < AO_UNHANDLED_MAX_SIGS))
+    {
+        entry      = &unhandled->sigs[unhandled->n_sigs++];
+        entry->sig = sig;
+    }
+
+    uint16_t * const count = (entry != NULL) ? &entry->count : &unhandled->other;
+
+    if (*count < UINT16_MAX)
+    {
+        (*count)++;
+    }
+
+    unhandled->total++;
+}
+
+/**
+*   @brief      Number of unhandled events of one signal
+*   @param[in]  unhandled   - pointer to the counters
+*   @param[in]  sig         - signal
+*   @param[out] nothing
+*   @return     uint16_t    - count, saturated at UINT16_MAX, 0 if the signal did not fit
+*/
+uint16_t ao_unhandled_get(ao_unhandled_t const * const unhandled, QSignal sig)
+{
+    for (uint8_t i = 0u; i < unhandled->n_sigs; i++)
+    {
+        if (unhandled->sigs[i].sig == sig)
+        {
+            return unhandled->sigs[i].count;
+        }
+    }
+
+    return 0u;
+}
+
+/**
+*   @brief      Export the counters through QS, one record per signal
+*   @details    Signals are looked up in the global signal dictionary, local
+*               signals show up as numbers.
+*   @param[in]  unhandled   - pointer to the counters
+*   @param[in]  qs_id       - QS id of the owning AO
+*   @param[out] nothing
+*   @return     nothing
+*/
+void ao_unhandled_qs_dump(ao_unhandled_t const * const unhandled, uint8_t qs_id)
+{
+    (void)qs_id;    // unused when QS is disabled
+
+    for (uint8_t i = 0u; i < unhandled->n_sigs; i++)
+    {
+        QS_BEGIN_ID(DRIVER_QS_UNHANDLED, qs_id)
+            QS_SIG(unhandled->sigs[i].sig, (void *)0);
+            QS_U16(0, unhandled->sigs[i].count);
+        QS_END()
+    }
+
+    QS_BEGIN_ID(DRIVER_QS_UNHANDLED_TOTAL, qs_id)
+        QS_U32(0, unhandled->total);
+        QS_U16(0, unhandled->other);
+    QS_END()
+}
@@ -0,0 +1,57 @@
+/**
+ * @file        ao_unhandled.h
+ * @brief       Per-signal counters of events no state handled
+ * @details     The backstop of each driver counts the signals that reach its
+ *              default branch instead of formatting a debug line for them, so a
+ *              storm of unhandled events (retry self-posts, stale timeouts) costs
+ *              one increment each. The counters are exported through QS with
+ *              ao_unhandled_qs_dump(), from the driver's telemetry request.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef AO_UNHANDLED_H
+#define AO_UNHANDLED_H
+
+#include <stdint.h>
+
+#include "qpc.h"
+
+// Distinct signals counted, the events of any further signal are counted in other
+#define AO_UNHANDLED_MAX_SIGS           8u
+
+/*! @struct ao_unhandled_entry_t
+*   @brief  Count of one unhandled signal
+*/
+typedef struct
+{
+    QSignal                 sig;                                /**< Signal >*/
+    uint16_t                count;                              /**< Unhandled events, saturating >*/
+} ao_unhandled_entry_t;
+
+/*! @struct ao_unhandled_t
+*   @brief  Per-AO unhandled signal counters
+*   @details The backstop only sees a few distinct signals, so they are kept in
+*            a small table in order of first appearance.
+*/
+typedef struct
+{
+    uint32_t                total;                              /**< Unhandled events since reset >*/
+    uint16_t                other;                              /**< Events of signals that did not fit, saturating >*/
+    uint8_t                 n_sigs;                             /**< Entries in use >*/
+    ao_unhandled_entry_t    sigs[AO_UNHANDLED_MAX_SIGS];        /**< Per signal counts >*/
+} ao_unhandled_t;
+
+void ao_unhandled_init(ao_unhandled_t * const unhandled);
+
+void ao_unhandled_count(ao_unhandled_t * const unhandled, QSignal sig);
+
+uint16_t ao_unhandled_get(ao_unhandled_t const * const unhandled, QSignal sig);
+
+void ao_unhandled_qs_dump(ao_unhandled_t const * const unhandled, uint8_t qs_id);
+
+#endif
@@ -24,6 +24,16 @@
  *                                          state are cached in a queue until the driver is
  *                                          idle again
  *
+ *              With DEVICE_LEVEL_COMPONENT, device_level runs as an orthogonal
+ *              component of this AO: the backstop dispatches the events it owns to
+ *              it, and requests to it are dispatched rather than posted.
+ *
+ *              With DRIVER_FAST_BRINGUP, starting enables device_level on entry
+ *              instead of self-posting first. A supervisor that enables several
+ *              driver stacks back to back then has every device_level starting
+ *              before the first api_level has run its starting state, so the
+ *              stacks come up concurrently rather than one hop at a time.
+ *
  
  *
  *
@@ -38,6 +48,14 @@
 #include "qpc.h"
 #include "common.h"
 #include "ao_timings.h"
+#include "ao_duty_cycle.h"
+#include "ao_rtc_profiler.h"
+#include "ao_state_stats.h"
+#include "ao_unhandled.h"
+#include "ao_error_agg.h"
+#include "ao_startup_trace.h"
+#include "ao_timer_wheel.h"
+#include "driver_qs_records.h"
 #include "events.h"
 #include "signals.h"
 #include "whoop_printf.h"
@@ -48,6 +66,11 @@
 #include "device_level.h"
 #include "api_level.h"
 
+// Only the profiler install in the constructor asserts
+#ifdef DRIVER_RTC_PROFILER
+Q_DEFINE_THIS_FILE
+#endif
+
 /**
  *  @brief      define the human-readable name for this module
 */
@@ -90,6 +113,13 @@ static uint32_t api_level_debug_level = STARTING_DEBUG_LEVEL; // Default debug l
 */
 #define API_LEVEL_DEFERRED_QUEUE_SIZE    5u
 
+#ifdef DEVICE_LEVEL_COMPONENT
+// device_level runs inside this AO, hand it the event in the same RTC step
+#define API_LEVEL_TO_DEVICE_LEVEL(me_, e_)      device_level_component_dispatch(e_)
+#else
+#define API_LEVEL_TO_DEVICE_LEVEL(me_, e_)      QACTIVE_POST(g_ao_device_level, (e_), (me_))
+#endif
+
 typedef struct
 {
     QActive                 super;
@@ -97,15 +127,35 @@ typedef struct
     uint8_t                 request_id;                 /**< The request ID passed to this AO */
     QEQueue                 deferred_event_queue;
     QEvent const *          deferred_events_queue_buf[API_LEVEL_DEFERRED_QUEUE_SIZE];
-    QTimeEvt                time_event;                 /**< Timeout timer. */
-    QTimeEvt                busy_event;                 /**< Busy timer. */
+    ao_timer_t              time_event;                 /**< Timeout timer. */
+    ao_timer_t              busy_event;                 /**< Busy timer. */
+    ao_timer_t              error_event;                /**< Collects aggregated error reports */
     api_level_status_t      status;                     
     ao_timings_t            ao_timings;                 /**< Timing data*/
+    ao_duty_cycle_t         duty_cycle;                 /**< Duty cycle telemetry built on ao_timings */
+    ao_state_stats_t        state_stats;                /**< Dwell time and transition counts per state */
+    ao_unhandled_t          unhandled;                  /**< Events no state handled, per signal */
+    ao_error_agg_t          error_agg;                  /**< Merges repeated error reports */
+    ao_startup_trace_t      startup_trace;              /**< Timestamps of the last bring-up */
+#ifdef DRIVER_RTC_PROFILER
+    ao_rtc_profiler_t       rtc_profiler;               /**< RTC step cost statistics */
+#endif
     uint32_t                debug_level;                /**< Current threshold for gating debug output. >*/
 } api_level_t;
 
 static QEvt const * api_level_que_sto[API_LEVEL_QUEUE_SIZE];     // api_level queue storage space
 
+// State names for the QS state statistics dump, indexed by api_level_state_id_t
+static char const * const api_level_state_names[API_LEVEL_STATE_COUNT] =
+{
+    [API_LEVEL_STATE_DISABLED]  = "disabled",
+    [API_LEVEL_STATE_STARTING]  = "starting",
+    [API_LEVEL_STATE_ENABLED]   = "enabled",
+    [API_LEVEL_STATE_IDLE]      = "idle",
+    [API_LEVEL_STATE_BUSY]      = "busy",
+    [API_LEVEL_STATE_ERROR]     = "error",
+};
+
 // Signals for use in local context only
 enum
 {
@@ -113,6 +163,7 @@ enum
     LOCAL_API_LEVEL_BUSY_TIMEOUT_SIG,
     LOCAL_API_LEVEL_START_INIT_SIG,
     LOCAL_API_LEVEL_RETRY_SIG,
+    LOCAL_API_LEVEL_ERROR_FLUSH_SIG,
 };
 
 // Single instance of the internal api_level object
@@ -126,6 +177,11 @@ static api_level_t ao_api_level =
 // globally scoped opaque pointer
 QActive * const g_ao_api_level = &ao_api_level.super;
 
+#ifdef DEVICE_LEVEL_COMPONENT
+// Events for device_level land in this AO's queue and go to the component
+QActive * const g_ao_device_level = &ao_api_level.super;
+#endif
+
 // state functions
 static QState api_level_initial            (api_level_t * const me, QEvt const * const e);
 static QState api_level_backstop           (api_level_t * const me, QEvt const * const e);
@@ -140,6 +196,10 @@ static QState api_level_error              (api_level_t * const me, QEvt const *
 static void api_level_error_response(api_level_t * const me, int32_t error_code,
                                       whoop_error_severity_t error_severity);
 
+static void api_level_publish_error(api_level_t * const me, ao_error_agg_report_t const * const report);
+
+static void api_level_flush_errors(api_level_t * const me);
+
 static void api_level_publish_status(api_level_t * const me);
 
 /************************************************************************************/
@@ -163,11 +223,23 @@ void api_level_ctor(void)
     QActive_ctor(&me->super, (QStateHandler)&api_level_initial);
 
     // Create a timer object for API_LEVEL communications timeout detection
-    QTimeEvt_ctorX(&me->time_event,  &me->super, LOCAL_API_LEVEL_TIMEOUT_SIG, 0U);
+    AO_TIMER_CTOR(&me->time_event,  &me->super, LOCAL_API_LEVEL_TIMEOUT_SIG);
 
     // Create a timer object for API_LEVEL busy state timeout detection
-    QTimeEvt_ctorX(&me->busy_event,  &me->super, LOCAL_API_LEVEL_BUSY_TIMEOUT_SIG, 0U);
+    AO_TIMER_CTOR(&me->busy_event,  &me->super, LOCAL_API_LEVEL_BUSY_TIMEOUT_SIG);
 
+    // Create a timer object to collect aggregated error reports
+    AO_TIMER_CTOR(&me->error_event, &me->super, LOCAL_API_LEVEL_ERROR_FLUSH_SIG);
+
+#ifdef DEVICE_LEVEL_COMPONENT
+    device_level_component_ctor(&me->super);
+#endif
+
+#ifdef DRIVER_RTC_PROFILER
+    // Measure every run-to-completion step of this AO. Fails only when every
+    // profiler hook is taken, which would leave the profile silently empty
+    Q_ALLEGE(ao_rtc_profiler_install(&me->super, &me->rtc_profiler));
+#endif
 }
 
 /*! @fn         static QState api_level_initial(api_level_t * me, QEvt const * const e)
@@ -192,6 +264,7 @@ static QState api_level_initial(api_level_t * me, QEvt const * const e)
     QS_FUN_DICTIONARY(&api_level_idle);
     QS_FUN_DICTIONARY(&api_level_busy);
     QS_FUN_DICTIONARY(&api_level_error);
+    DRIVER_QS_USR_DICTIONARIES();
 
     // Subscribe to signal from low level driver
     QActive_subscribe(&me->super, DEVICE_LEVEL_DISABLE_REPORT_SIG);
@@ -203,6 +276,14 @@ static QState api_level_initial(api_level_t * me, QEvt const * const e)
 
     // Initialize the timings
     ao_timings_init(&me->ao_timings);
+    ao_duty_cycle_init(&me->duty_cycle);
+    ao_state_stats_init(&me->state_stats, API_LEVEL_STATE_COUNT);
+    ao_unhandled_init(&me->unhandled);
+    ao_error_agg_init(&me->error_agg);
+
+#ifdef DEVICE_LEVEL_COMPONENT
+    device_level_component_init();
+#endif
 
     // Move to the disabled state, and wait for enable signal
     return Q_TRAN(&api_level_disabled);
@@ -258,6 +339,33 @@ QState api_level_backstop(api_level_t * const me, QEvt const * const e)
             break;
         }
 
+        // Export the driver telemetry through QS
+        case API_LEVEL_REQ_TELEMETRY_SIG:
+        {
+            ao_duty_cycle_qs_dump(&me->duty_cycle, me->super.prio);
+            ao_state_stats_qs_dump(&me->state_stats, api_level_state_names, me->super.prio);
+            ao_unhandled_qs_dump(&me->unhandled, me->super.prio);
+            ao_startup_trace_qs_dump(&me->startup_trace, me->super.prio);
+#ifdef DRIVER_RTC_PROFILER
+            ao_rtc_profiler_qs_dump(&me->rtc_profiler, me->super.prio);
+#endif
+            status = Q_HANDLED();
+            break;
+        }
+
+        // Publish the summaries of the error windows that have closed
+        case LOCAL_API_LEVEL_ERROR_FLUSH_SIG:
+        {
+            api_level_flush_errors(me);
+
+            if (ao_error_agg_is_pending(&me->error_agg))
+            {
+                AO_TIMER_ARM(&me->error_event, MS_TO_TICKS(AO_ERROR_AGG_WINDOW_MS));
+            }
+            status = Q_HANDLED();
+            break;
+        }
+
         // If we receive a request to disable the device, service it here
         case API_LEVEL_DISABLE_SIG:
         {
@@ -268,7 +376,7 @@ QState api_level_backstop(api_level_t * const me, QEvt const * const e)
 
             // Disable the device driver
             static QEvt const dis_evt = {DEVICE_LEVEL_DISABLE_SIG, 0u, 0u};
-            QACTIVE_POST(g_ao_device_level, &dis_evt, me);
+            API_LEVEL_TO_DEVICE_LEVEL(me, &dis_evt);
 
             // Move to the disabled state
             status = Q_TRAN(&api_level_disabled);
@@ -294,14 +402,16 @@ QState api_level_backstop(api_level_t * const me, QEvt const * const e)
         // Catch unhandled signals here
         default:
         {
-            if (e->sig < MAX_SIG)
-            {
-                DEBUG_OUT(1u, "%s: Ignoring unhandled signal %s.\n", API_LEVEL_NAME, signals_get_signal_name(e->sig));
-            }
-            else
+#ifdef DEVICE_LEVEL_COMPONENT
+            if (device_level_component_owns(e->sig))
             {
-                DEBUG_OUT(1u, "%s: Ignoring unhandled local signal at offset %d.\n", API_LEVEL_NAME, (e->sig - MAX_SIG));
+                device_level_component_dispatch(e);
+                status = Q_HANDLED();
+                break;
             }
+#endif
+            // Dumped with API_LEVEL_REQ_TELEMETRY_SIG
+            ao_unhandled_count(&me->unhandled, e->sig);
             break;
         }
     }
@@ -325,7 +435,8 @@ QState api_level_disabled(api_level_t * const me, QEvt const * const e)
 
         case Q_ENTRY_SIG:
         {
-            ao_set_idle(&me->ao_timings);
+            ao_state_stats_enter(&me->state_stats, API_LEVEL_STATE_DISABLED);
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
 
             // Set the status of the API_LEVEL device to disabled
             me->status = API_LEVEL_DISABLED;
@@ -337,6 +448,7 @@ QState api_level_disabled(api_level_t * const me, QEvt const * const e)
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, API_LEVEL_STATE_DISABLED);
             status = Q_HANDLED();
             break;
         }
@@ -345,6 +457,8 @@ QState api_level_disabled(api_level_t * const me, QEvt const * const e)
         {
             // Once we receive a start signal, move to the 'starting' state
             DEBUG_OUT(1u, "%s: Driver Starting.\n", API_LEVEL_NAME);
+            ao_startup_trace_begin(&me->startup_trace);
+            ao_startup_trace_mark(&me->startup_trace, API_LEVEL_STARTUP_ENABLE);
 
             status = Q_TRAN(&api_level_starting);
             break;
@@ -384,13 +498,23 @@ static QState api_level_starting(api_level_t * me, QEvt const *e)
     {
         case Q_ENTRY_SIG:
         {
-            ao_set_busy(&me->ao_timings);
+            ao_state_stats_enter(&me->state_stats, API_LEVEL_STATE_STARTING);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
 
             QActive_subscribe(&me->super, DEVICE_LEVEL_READY_REPORT_SIG);
 
+#ifdef DRIVER_FAST_BRINGUP
+            // Enable the low level driver now, it starts while other stacks are enabled
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(API_LEVEL_INIT_LOCKUP_TIME_MS));
+
+            static QEvt const device_level_enable_evt = {DEVICE_LEVEL_ENABLE_SIG, 0u, 0u};
+            API_LEVEL_TO_DEVICE_LEVEL(me, &device_level_enable_evt);
+            ao_startup_trace_mark(&me->startup_trace, API_LEVEL_STARTUP_DEVICE_ENABLE);
+#else
             // Self-post the init starting sig
             static QEvt const start_evt = {LOCAL_API_LEVEL_START_INIT_SIG, 0u, 0u};
             QACTIVE_POST(g_ao_api_level, &start_evt, me);
+#endif
 
             status = Q_HANDLED();
             break;
@@ -400,11 +524,12 @@ static QState api_level_starting(api_level_t * me, QEvt const *e)
         case LOCAL_API_LEVEL_START_INIT_SIG:
         {
             // Arm the One-shot timer in case device not ready or unresponsive
-            whoop_qp_time_safe_arm(&me->time_event, MS_TO_TICKS(API_LEVEL_INIT_LOCKUP_TIME_MS), 0u);
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(API_LEVEL_INIT_LOCKUP_TIME_MS));
 
             // Request i2c bus status from low level driver
             static QEvt const device_level_status_req_evt = {DEVICE_LEVEL_ENABLE_SIG, 0u, 0u};
-            QACTIVE_POST(g_ao_device_level, &device_level_status_req_evt, me);
+            API_LEVEL_TO_DEVICE_LEVEL(me, &device_level_status_req_evt);
+            ao_startup_trace_mark(&me->startup_trace, API_LEVEL_STARTUP_DEVICE_ENABLE);
 
             status = Q_HANDLED();
             break;
@@ -415,6 +540,7 @@ static QState api_level_starting(api_level_t * me, QEvt const *e)
         {
             QActive_unsubscribe(&me->super, DEVICE_LEVEL_READY_REPORT_SIG);
             DEBUG_OUT(1u, "%s: Low level driver active. Moving to idle state\n", API_LEVEL_NAME);
+            ao_startup_trace_mark(&me->startup_trace, API_LEVEL_STARTUP_DEVICE_READY);
 
             status = Q_TRAN(&api_level_idle);
             break;
@@ -461,8 +587,9 @@ static QState api_level_starting(api_level_t * me, QEvt const *e)
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, API_LEVEL_STATE_STARTING);
             // Disable the timeout timer
-            QTimeEvt_disarm(&me->time_event);
+            AO_TIMER_DISARM(&me->time_event);
             status = Q_HANDLED();
             break;
         }
@@ -491,13 +618,15 @@ static QState api_level_enabled(api_level_t * const me, QEvt const * const e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, API_LEVEL_STATE_ENABLED);
             // disarm lockup detection timer if it hasn't already fired.
-            QTimeEvt_disarm(&me->time_event);
+            AO_TIMER_DISARM(&me->time_event);
 
             DEBUG_OUT(1u, "%s: Driver Enabled.\n", API_LEVEL_NAME);
 
             me->status = API_LEVEL_ENABLED;
             api_level_publish_status(me);
+            ao_startup_trace_mark(&me->startup_trace, API_LEVEL_STARTUP_READY);
 
             status = Q_HANDLED();
             break;
@@ -505,6 +634,7 @@ static QState api_level_enabled(api_level_t * const me, QEvt const * const e)
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, API_LEVEL_STATE_ENABLED);
             status = Q_HANDLED();
             break;
         }
@@ -554,8 +684,9 @@ QState api_level_idle(api_level_t * me, QEvt const * const e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, API_LEVEL_STATE_IDLE);
             // Mark the API_LEVEL driver as enabled
-            ao_set_idle(&me->ao_timings);
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
             me->status = API_LEVEL_ENABLED;
 
             status = Q_HANDLED();
@@ -564,6 +695,7 @@ QState api_level_idle(api_level_t * me, QEvt const * const e)
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, API_LEVEL_STATE_IDLE);
             status = Q_HANDLED();
             break;
         }
@@ -593,10 +725,11 @@ QState api_level_busy(api_level_t * me, QEvt const * const e)
     {
         case Q_ENTRY_SIG:
         {
-            ao_set_busy(&me->ao_timings);
+            ao_state_stats_enter(&me->state_stats, API_LEVEL_STATE_BUSY);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
 
             // Arm busy timer
-            whoop_qp_time_safe_arm(&me->busy_event, MS_TO_TICKS(API_LEVEL_LOCKUP_TIME_MS), 0u);
+            AO_TIMER_ARM(&me->busy_event, MS_TO_TICKS(API_LEVEL_LOCKUP_TIME_MS));
 
             status = Q_HANDLED();
             break;
@@ -604,7 +737,8 @@ QState api_level_busy(api_level_t * me, QEvt const * const e)
 
         case Q_EXIT_SIG:
         {
-            QTimeEvt_disarm(&me->busy_event);
+            ao_state_stats_exit(&me->state_stats, API_LEVEL_STATE_BUSY);
+            AO_TIMER_DISARM(&me->busy_event);
 
             status = Q_HANDLED();
             break;
@@ -655,8 +789,9 @@ QState api_level_error(api_level_t * const me, QEvt const * const e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, API_LEVEL_STATE_ERROR);
             // Set the status of the API_LEVEL device to error
-            ao_set_idle(&me->ao_timings);
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
             me->status = API_LEVEL_FATAL_ERROR;
             api_level_publish_status(me);
             status = Q_HANDLED();
@@ -665,6 +800,7 @@ QState api_level_error(api_level_t * const me, QEvt const * const e)
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, API_LEVEL_STATE_ERROR);
             status = Q_HANDLED();
             break;
         }
@@ -673,6 +809,8 @@ QState api_level_error(api_level_t * const me, QEvt const * const e)
         {
             // Once we receive a start signal, move to the 'starting' state
             DEBUG_OUT(1u, "%s: Driver Starting from error state\n", API_LEVEL_NAME);
+            ao_startup_trace_begin(&me->startup_trace);
+            ao_startup_trace_mark(&me->startup_trace, API_LEVEL_STARTUP_ENABLE);
 
             status = Q_TRAN(&api_level_starting);
             break;
@@ -700,7 +838,7 @@ QState api_level_error(api_level_t * const me, QEvt const * const e)
 
 /*!
 *   @brief      Publish an error response
-*   @details
+*   @details    Repeats of the same code are merged, see ao_error_agg.h.
 *   @param[in]  api_level_t  - pointer to instance of API_LEVEL Active Object
 *   @param[in]  error_code    - Reported error
 *   @param[out] nothing
@@ -709,18 +847,67 @@ QState api_level_error(api_level_t * const me, QEvt const * const e)
 static void api_level_error_response(api_level_t * const me, int32_t error_code,
                                       whoop_error_severity_t error_severity)
 {
+    ao_error_agg_report_t report;
+
     DEBUG_OUT(2u, "%s: Error reported, error code 0x%02X\n", API_LEVEL_NAME, error_code);
-    generic_error_signal_t * err_evt = Q_NEW(generic_error_signal_t, GENERIC_ERROR_REPORT_SIG);
 
-    err_evt->error_code     = error_code;
-    err_evt->ao_name        = API_LEVEL_NAME;
-    err_evt->error_severity = error_severity;
-    err_evt->error_subsys   = E_WHOOP_SUBSYS_API_LEVEL;
-    err_evt->extra_info     = 0u;
+    // Summaries of closed windows go out before the new report
+    api_level_flush_errors(me);
+
+    switch (ao_error_agg_add(&me->error_agg, error_code, error_severity, &report))
+    {
+        case AO_ERROR_AGG_PUBLISH:
+        {
+            api_level_publish_error(me, &report);
+            break;
+        }
+        case AO_ERROR_AGG_HELD_FIRST:
+        {
+            AO_TIMER_ARM(&me->error_event, MS_TO_TICKS(AO_ERROR_AGG_WINDOW_MS));
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/*!
+*   @brief      Publish one error report, single or aggregated
+*   @param[in]  api_level_t  - pointer to instance of API_LEVEL Active Object
+*   @param[in]  report       - report from the aggregator
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void api_level_publish_error(api_level_t * const me, ao_error_agg_report_t const * const report)
+{
+    ao_error_agg_event_t * err_evt = Q_NEW(ao_error_agg_event_t, GENERIC_ERROR_REPORT_SIG);
+
+    ao_error_agg_fill(err_evt, report);
+    err_evt->super.ao_name      = API_LEVEL_NAME;
+    err_evt->super.error_subsys = E_WHOOP_SUBSYS_API_LEVEL;
+    err_evt->super.extra_info   = 0u;
 
     QF_PUBLISH((QEvt*)err_evt, me);
 }
 
+/*!
+*   @brief      Publish the summaries of the error windows that have closed
+*   @param[in]  api_level_t  - pointer to instance of API_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void api_level_flush_errors(api_level_t * const me)
+{
+    ao_error_agg_report_t report;
+
+    while (ao_error_agg_next_report(&me->error_agg, &report))
+    {
+        api_level_publish_error(me, &report);
+    }
+}
+
 /*!
 *   @brief      Publish the status of the API Level AO
 *   @param[in]  api_level_t - pointer to instance of API_LEVEL active object
@@ -785,3 +972,57 @@ int32_t api_level_get_last_error(void)
 {
     return ao_api_level.last_error;
 }
+
+/**
+ * @brief Returns true while the AO is in a busy period
+ *
+ */
+bool api_level_is_busy(void)
+{
+    return ao_duty_cycle_is_busy(&ao_api_level.duty_cycle);
+}
+
+/**
+ * @brief Retrieve the accumulated busy time in timer counts
+ *
+ */
+timer_count_t api_level_get_active_counts(void)
+{
+    return ao_duty_cycle_get_active_counts(&ao_api_level.duty_cycle);
+}
+
+/**
+ * @brief Retrieve a snapshot of the duty cycle telemetry
+ *
+ */
+void api_level_get_duty_cycle(ao_duty_cycle_report_t * const report)
+{
+    ao_duty_cycle_get_report(&ao_api_level.duty_cycle, report);
+}
+
+/**
+ * @brief Retrieve dwell time and transition statistics for one state
+ *
+ */
+bool api_level_get_state_stats(api_level_state_id_t state, ao_state_stats_report_t * const report)
+{
+    return ao_state_stats_get_report(&ao_api_level.state_stats, (uint8_t)state, report);
+}
+
+/**
+ * @brief Number of events of one signal no state handled
+ *
+ */
+uint16_t api_level_get_unhandled_count(QSignal sig)
+{
+    return ao_unhandled_get(&ao_api_level.unhandled, sig);
+}
+
+/**
+ * @brief Time from the enable to a step of the last bring-up, false if not reached
+ *
+ */
+bool api_level_get_startup_step_us(api_level_startup_step_t step, uint32_t * const since_enable_us)
+{
+    return ao_startup_trace_get_us(&ao_api_level.startup_trace, (uint8_t)step, since_enable_us);
+}
@@ -15,6 +15,15 @@
 // Needed for whoop_error_t
 #include "common.h"
 
+// Needed for ao_duty_cycle_report_t
+#include "ao_duty_cycle.h"
+
+// Needed for ao_state_stats_report_t
+#include "ao_state_stats.h"
+
+// Needed for ao_startup_trace_t
+#include "ao_startup_trace.h"
+
 #include "device_level.h"
 
 
@@ -30,6 +39,30 @@ typedef enum
 
 } api_level_status_t;
 
+// State numbers used for dwell time and transition statistics
+typedef enum
+{
+    API_LEVEL_STATE_DISABLED   = 0,
+    API_LEVEL_STATE_STARTING   = 1,
+    API_LEVEL_STATE_ENABLED    = 2,
+    API_LEVEL_STATE_IDLE       = 3,
+    API_LEVEL_STATE_BUSY       = 4,
+    API_LEVEL_STATE_ERROR      = 5,
+
+    API_LEVEL_STATE_COUNT,
+} api_level_state_id_t;
+
+// Bring-up steps timestamped in the startup trace
+typedef enum
+{
+    API_LEVEL_STARTUP_ENABLE          = 0,  /**< API_LEVEL_ENABLE_SIG received >*/
+    API_LEVEL_STARTUP_DEVICE_ENABLE   = 1,  /**< DEVICE_LEVEL_ENABLE_SIG sent >*/
+    API_LEVEL_STARTUP_DEVICE_READY    = 2,  /**< DEVICE_LEVEL_READY_REPORT_SIG received >*/
+    API_LEVEL_STARTUP_READY           = 3,  /**< enabled entered, ready report published >*/
+
+    API_LEVEL_STARTUP_STEP_COUNT,
+} api_level_startup_step_t;
+
 typedef struct
 {
     q_event_replyable_request_t    super;       /**<Extend q_event_replyable_response_t */
@@ -53,4 +86,12 @@ bool api_level_is_busy(void);
 
 timer_count_t api_level_get_active_counts(void);
 
+void api_level_get_duty_cycle(ao_duty_cycle_report_t * const report);
+
+bool api_level_get_state_stats(api_level_state_id_t state, ao_state_stats_report_t * const report);
+
+uint16_t api_level_get_unhandled_count(QSignal sig);
+
+bool api_level_get_startup_step_us(api_level_startup_step_t step, uint32_t * const since_enable_us);
+
 #endif
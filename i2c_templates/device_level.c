@@ -10,18 +10,32 @@
  *              One super state:
  *              device_level_backstop       -   Handler for uncaught or error case signals
  *
- *              Four states are children of the backstop state:
+ *              Seven states are children of the backstop state:
  *              device_level_disabled     -   Bounces all requests, waits for an enable signal
  *              device_level_starting     -   Have received enable signal, wait for DEVICE_LEVEL ready
  *              device_level_enabled      -   DEVICE_LEVEL is now ready, signal the supervisor, move to idle
- *              device_level_error          - Fatal error state
+ *              device_level_error          - Fatal error state, answers all requests with an error
+ *              device_level_suspended      - Configuration packed, requests wait for the resume
+ *                                            (DEVICE_LEVEL_SUSPEND)
+ *              device_level_resuming       - Writes the packed configuration back, then idle
+ *                                            (DEVICE_LEVEL_SUSPEND)
+ *              device_level_powering       - Writes the power register on the way to sleep or
+ *                                            back (DEVICE_LEVEL_AUTO_POWER)
  *
- *              Two states are children of the enabled state:
+ *              Four states are children of the enabled state:
  *              device_level_idle           -   The normal inactive state of the DEVICE_LEVEL object
  *              device_level_busy           -   A superstate for while the DEVICE_LEVEL I2C is busy
  *                                      Incoming requests while the driver is in the busy
- *                                      state are cached in a queue until the driver is
- *                                      idle again
+ *                                      state are answered E_WHOOP_DEVICE_LEVEL_BUSY, the
+ *                                      requestor retries
+ *              device_level_recovering     - Warm restart after an I2C error, requests are
+ *                                            deferred until it is back in idle
+ *              device_level_scheduled      - Reads the batches of the static schedule
+ *                                            (DEVICE_LEVEL_SCHEDULE)
+ *
+ *              Two states are children of the busy state:
+ *              device_level_read           - A read transfer is on the bus
+ *              device_level_write          - A write transfer is on the bus
  *
  *
  * @version     0.1
@@ -31,6 +45,7 @@
  *
  */
 #include <stdint.h>
+#include <string.h>
 #include "qpc.h"
 
 #include "common.h"
@@ -42,12 +57,58 @@
 #include "dio.h"
 #include "dio_pin.h"
 #include "whoop_qp_time.h"
+#include "ao_clock.h"
+#include "ao_timings.h"
+#include "ao_duty_cycle.h"
+#include "ao_state_stats.h"
+#include "ao_unhandled.h"
+#include "ao_error_agg.h"
+#include "ao_retry_policy.h"
+#include "ao_config_cache.h"
+#include "ao_config_snapshot.h"
+#include "ao_schedule.h"
+#include "driver_qs_records.h"
 #include "device_level.h"
 
+#ifdef DEVICE_LEVEL_I2C_CAPTURE
+#include "i2c_capture.h"
+#endif
+
+// Only the hook installs in the constructor assert
+#if defined(DRIVER_RTC_PROFILER) || defined(DEVICE_LEVEL_FAST_PATH)
+Q_DEFINE_THIS_FILE
+#endif
+
 
 // I2C information
 #define DEVICE_LEVEL_SLAVE_ADDRESS        0xXXu
 
+/**
+    @brief Identity probe during startup
+    Build with DEVICE_LEVEL_ID_PROBE to have starting read DEVICE_LEVEL_ID_LEN
+    bytes at DEVICE_LEVEL_ID_REGISTER and check them with DEVICE_LEVEL_ID_MATCHES
+    before the driver reports ready. A device that does not answer, or answers
+    another value while it boots, is polled again DEVICE_LEVEL_ID_POLL_MIN_MS
+    later, doubling up to DEVICE_LEVEL_ID_POLL_MAX_MS, until the startup lockup
+    gives up. Override DEVICE_LEVEL_ID_MATCHES to also test a ready bit.
+*/
+#ifdef DEVICE_LEVEL_ID_PROBE
+#ifndef DEVICE_LEVEL_ID_REGISTER
+#define DEVICE_LEVEL_ID_REGISTER          0xXXu
+#endif
+#ifndef DEVICE_LEVEL_ID_VALUE
+#define DEVICE_LEVEL_ID_VALUE             0xXXu
+#endif
+#ifndef DEVICE_LEVEL_ID_LEN
+#define DEVICE_LEVEL_ID_LEN               1u
+#endif
+#ifndef DEVICE_LEVEL_ID_MATCHES
+#define DEVICE_LEVEL_ID_MATCHES(data_)    ((data_)[0] == DEVICE_LEVEL_ID_VALUE)
+#endif
+#define DEVICE_LEVEL_ID_POLL_MIN_MS       1u
+#define DEVICE_LEVEL_ID_POLL_MAX_MS       32u
+#endif
+
 /**
  *  @brief      define the human-readable name for this module
 */
@@ -70,17 +131,132 @@
 */
 #define DEBUG_LEVEL                       (me->debug_level)
 
+// Attempts to bring the driver up before giving up
 #define DEVICE_LEVEL_I2C_ACTIVE_RETRIES   10U
 
+/**
+    @brief Bus recovery before a retry after a stuck bus
+    The I2C AO owns the bus but takes no request to recover it, so the board
+    support code clocks the bus free, e.g. nine SCL pulses through dio_pin.
+    Define this to the name of that function, void (void). The retry table
+    recovers on E_TIME_OUT and E_BAD_STATE, a retry without it would only wait.
+*/
+#ifndef DEVICE_LEVEL_BUS_RECOVER
+#error "device_level_retry_table has AO_RETRY_RECOVER entries: define DEVICE_LEVEL_BUS_RECOVER"
+#endif
+void DEVICE_LEVEL_BUS_RECOVER(void);
+
 /**
     @brief Ensure the AO doesn't wait forever if the device is stuck
-    Set to the minimum allowed timeout time.
+    Upper bound of the lockup timeout, used until enough transfers have
+    completed. After that the timeout of each transfer follows its length at
+    DEVICE_LEVEL_I2C_BUS_HZ and the latency observed on the bus, see
+    ao_adaptive_timeout.h, but is never shorter than DEVICE_LEVEL_LOCKUP_MIN_MS.
 */
 #define DEVICE_LEVEL_LOCKUP_TIME_MS       20u
 
+#define DEVICE_LEVEL_LOCKUP_MIN_MS        2u
+
+// I2C clock of the bus the device is on
+#ifndef DEVICE_LEVEL_I2C_BUS_HZ
+#define DEVICE_LEVEL_I2C_BUS_HZ           400000u
+#endif
+
 // Allow more time for initialization
 #define DEVICE_LEVEL_INIT_LOCKUP_TIME_MS  500u
 
+/**
+    @brief Warm restart after an I2C error
+    The driver waits DEVICE_LEVEL_WARM_RESTART_DELAY_MS, probes the device
+    with one read and restores the cached configuration if the device lost
+    it. A warm restart that fails DEVICE_LEVEL_WARM_RESTART_ATTEMPTS times
+    falls back to the error state.
+*/
+#define DEVICE_LEVEL_WARM_RESTART_DELAY_MS    2u
+#define DEVICE_LEVEL_WARM_RESTART_ATTEMPTS    3u
+
+/**
+    @brief Suspend and resume
+    Build with DEVICE_LEVEL_SUSPEND to take these. DEVICE_LEVEL_SUSPEND_SIG packs the cached configuration into write runs, see
+    ao_config_snapshot.h, and holds requests until DEVICE_LEVEL_RESUME_SIG. The
+    resume writes the runs back DEVICE_LEVEL_BURST_TRANSACTIONS at a time, one
+    I2C request each, and falls back to a warm restart if that fails. A suspend
+    that arrives during a transfer or a bring-up waits for idle; disabled and
+    error have nothing to keep and ignore both signals. A running schedule stops
+    for the suspend, once its batch is off the bus, and starts again after the
+    resume.
+*/
+#define DEVICE_LEVEL_BURST_TRANSACTIONS   ((uint8_t)Q_DIM(((i2c_comm_req_event_t *)0)->transactions))
+
+// The device advances its register address on multi-byte writes
+#ifndef DEVICE_LEVEL_AUTO_INCREMENT
+#define DEVICE_LEVEL_AUTO_INCREMENT       true
+#endif
+
+/**
+    @brief Automatic power management
+    Build with DEVICE_LEVEL_AUTO_POWER to let requests bring the driver up and
+    idleness put it down. A request that finds the driver disabled is deferred
+    and starts the driver, and requests arriving during the bring-up wait with
+    it. After DEVICE_LEVEL_AUTO_SLEEP_MS in idle the driver writes
+    DEVICE_LEVEL_POWER_SLEEP to DEVICE_LEVEL_POWER_REGISTER and parks in
+    disabled; the next bring-up writes DEVICE_LEVEL_POWER_WAKE there first.
+*/
+#ifdef DEVICE_LEVEL_AUTO_POWER
+#ifndef DEVICE_LEVEL_AUTO_SLEEP_MS
+#define DEVICE_LEVEL_AUTO_SLEEP_MS        1000u
+#endif
+#ifndef DEVICE_LEVEL_POWER_REGISTER
+#define DEVICE_LEVEL_POWER_REGISTER       0xXXu
+#endif
+#ifndef DEVICE_LEVEL_POWER_SLEEP
+#define DEVICE_LEVEL_POWER_SLEEP          0xXXu
+#endif
+#ifndef DEVICE_LEVEL_POWER_WAKE
+#define DEVICE_LEVEL_POWER_WAKE           0xXXu
+#endif
+#endif
+
+/**
+    @brief Static schedule
+    Build with DEVICE_LEVEL_SCHEDULE for time-triggered sampling.
+    DEVICE_LEVEL_SCHEDULE_START_SIG takes idle to scheduled, which releases one
+    minor frame every DEVICE_LEVEL_SCHEDULE_FRAME_MS from a periodic timer and
+    reads the register batch device_level_schedule_slots names for that frame.
+    Each batch is one I2C request and its registers are published with
+    DEVICE_LEVEL_SAMPLE_SIG. Requests are refused while the schedule runs, so
+    nothing competes with it for the bus. A batch that fails is dropped, not
+    retried, since a retry would run into the next frame.
+    The frame should be a whole number of QF ticks.
+*/
+#ifdef DEVICE_LEVEL_SCHEDULE
+#ifndef DEVICE_LEVEL_SCHEDULE_FRAME_MS
+#define DEVICE_LEVEL_SCHEDULE_FRAME_MS    10u
+#endif
+#ifndef DEVICE_LEVEL_SAMPLE_REGISTER
+#define DEVICE_LEVEL_SAMPLE_REGISTER      0xXXu
+#endif
+#ifndef DEVICE_LEVEL_SAMPLE_LEN
+#define DEVICE_LEVEL_SAMPLE_LEN           6u
+#endif
+#ifndef DEVICE_LEVEL_STATUS_REGISTER
+#define DEVICE_LEVEL_STATUS_REGISTER      0xXXu
+#endif
+#ifndef DEVICE_LEVEL_STATUS_LEN
+#define DEVICE_LEVEL_STATUS_LEN           1u
+#endif
+#endif
+
+// Register read by the warm restart probe while no configuration is cached
+#ifndef DEVICE_LEVEL_PROBE_REGISTER
+#define DEVICE_LEVEL_PROBE_REGISTER       0x00u
+#endif
+
+// Writes cached for a warm restart; narrow this to the configuration registers
+#ifndef DEVICE_LEVEL_IS_CONFIG_REG
+#define DEVICE_LEVEL_IS_CONFIG_REG(reg_)  (true)
+#endif
+
 /**
     @brief define the maximum allowable busy time for the AO
     To ensure that the AO does not fail to exit the busy state and
@@ -89,7 +265,9 @@
     idle.
     This time was chosen as an absolute maximum. In normal operation,
     only one register should be read at a time, which should last
-    substantially less than 100ms including timeouts and retries.
+    substantially less than 100ms including timeouts and retries. The
+    timer is armed for the lockup timeout of every attempt if that is
+    shorter.
 */
 #define DEVICE_LEVEL_BUSY_TIME_MS         100u
 
@@ -108,14 +286,83 @@ static device_level_t ao_device_level =
     .last_hal_error             = E_NO_ERROR,
 };
 
+#ifdef DEVICE_LEVEL_COMPONENT
+// The container AO owns the queue, the time events and the subscriptions, and
+// defines g_ao_device_level as itself
+#define DEVICE_LEVEL_AO(me_)            ((me_)->container)
+#else
+#define DEVICE_LEVEL_AO(me_)            (&(me_)->super)
+
 // Globally scoped opaque pointer
 QActive * const g_ao_device_level = &ao_device_level.super;
 
 // I2C object queue storage space
 static QEvt const * device_level_que_sto[DEVICE_LEVEL_QUEUE_SIZE];
+#endif
+
+// State names for the QS state statistics dump, indexed by device_level_state_id_t
+static char const * const device_level_state_names[DEVICE_LEVEL_STATE_COUNT] =
+{
+    [DEVICE_LEVEL_STATE_DISABLED]   = "disabled",
+    [DEVICE_LEVEL_STATE_STARTING]   = "starting",
+    [DEVICE_LEVEL_STATE_ENABLED]    = "enabled",
+    [DEVICE_LEVEL_STATE_IDLE]       = "idle",
+    [DEVICE_LEVEL_STATE_BUSY]       = "busy",
+    [DEVICE_LEVEL_STATE_READ]       = "read",
+    [DEVICE_LEVEL_STATE_WRITE]      = "write",
+    [DEVICE_LEVEL_STATE_ERROR]      = "error",
+    [DEVICE_LEVEL_STATE_RECOVERING] = "recovering",
+    [DEVICE_LEVEL_STATE_POWERING]   = "powering",
+    [DEVICE_LEVEL_STATE_SUSPENDED]  = "suspended",
+    [DEVICE_LEVEL_STATE_RESUMING]   = "resuming",
+    [DEVICE_LEVEL_STATE_SCHEDULED]  = "scheduled",
+};
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+// Values written to DEVICE_LEVEL_POWER_REGISTER, the transfer points into them
+static uint8_t const device_level_power_sleep[1] = {DEVICE_LEVEL_POWER_SLEEP};
+static uint8_t const device_level_power_wake[1]  = {DEVICE_LEVEL_POWER_WAKE};
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+// Register batches of the static schedule, the device specific part
+static ao_schedule_batch_t const device_level_schedule_batches[] =
+{
+    {   // Sample registers
+        .reads   = {{DEVICE_LEVEL_SAMPLE_REGISTER, DEVICE_LEVEL_SAMPLE_LEN}},
+        .n_reads = 1u,
+    },
+    {   // Sample registers, then the status
+        .reads   = {{DEVICE_LEVEL_SAMPLE_REGISTER, DEVICE_LEVEL_SAMPLE_LEN},
+                    {DEVICE_LEVEL_STATUS_REGISTER, DEVICE_LEVEL_STATUS_LEN}},
+        .n_reads = 2u,
+    },
+};
 
-// Define a retry counter for functions that need it
-static uint8_t  device_level_retry_counter = 0u;
+// Batch read in each minor frame of the major cycle, AO_SCHEDULE_NO_BATCH leaves the bus free
+static uint8_t const device_level_schedule_slots[] =
+{
+    0u, 0u, 0u, 1u,
+};
+#endif
+
+/**
+    @brief Retry policy per HAL error
+    Transient errors are retried within the request, only errors that say the
+    device is not there, or are unknown, take the driver to its error state.
+*/
+static ao_retry_policy_entry_t const device_level_retry_table[] =
+{
+    // Arbitration lost: the other master is done by the time we are back
+    { .hal_error = E_COMM_ERR,      .action = AO_RETRY_NOW,      .max_retries = 3u, .delay_ms = 0u  },
+    // The device NAKs while busy: 1, 2, 4, 8 ms
+    { .hal_error = E_BUSY,          .action = AO_RETRY_BACKOFF,  .max_retries = 4u, .delay_ms = 1u  },
+    // No answer, or the bus reports it cannot start: stuck bus
+    { .hal_error = E_TIME_OUT,      .action = AO_RETRY_RECOVER,  .max_retries = 2u, .delay_ms = 10u },
+    { .hal_error = E_BAD_STATE,     .action = AO_RETRY_RECOVER,  .max_retries = 2u, .delay_ms = 10u },
+    // Address NAK: the device is not there
+    { .hal_error = E_NO_RESPONSE,   .action = AO_RETRY_FAIL,     .max_retries = 0u, .delay_ms = 0u  },
+};
 
 
 // state functions
@@ -129,6 +376,17 @@ static QState device_level_busy           (device_level_t * const me, QEvt const
 static QState device_level_read           (device_level_t * const me, QEvt const * const e);
 static QState device_level_write          (device_level_t * const me, QEvt const * const e);
 static QState device_level_error          (device_level_t * const me, QEvt const * const e);
+static QState device_level_recovering     (device_level_t * const me, QEvt const * const e);
+#ifdef DEVICE_LEVEL_SUSPEND
+static QState device_level_suspended      (device_level_t * const me, QEvt const * const e);
+static QState device_level_resuming       (device_level_t * const me, QEvt const * const e);
+#endif
+#ifdef DEVICE_LEVEL_AUTO_POWER
+static QState device_level_powering       (device_level_t * const me, QEvt const * const e);
+#endif
+#ifdef DEVICE_LEVEL_SCHEDULE
+static QState device_level_scheduled      (device_level_t * const me, QEvt const * const e);
+#endif
 
 // Helper functions
 
@@ -137,6 +395,10 @@ static bool device_level_is_i2c_bus_enabled(i2c_bus_status_t status);
 static void device_level_publish_error_response(device_level_t * const me, int32_t error_code,
         whoop_error_severity_t error_severity);
 
+static void device_level_publish_error(device_level_t * const me, ao_error_agg_report_t const * const report);
+
+static void device_level_flush_errors(device_level_t * const me);
+
 static void device_level_publish_status(device_level_t * const me);
 
 static void device_level_i2c_read(device_level_t * const me);
@@ -145,22 +407,150 @@ static void device_level_i2c_write(device_level_t * const me);
 
 static void device_level_i2c_comm_req(device_level_t * const me);
 
-static bool device_level_try_retry(device_level_t * const me);
+static void device_level_i2c_dispatch(device_level_t * const me, i2c_transaction_data_t const * const transactions,
+                                      uint8_t n_transactions);
+
+static void device_level_recovery_req(device_level_t * const me);
+
+static QState device_level_recovery_retry(device_level_t * const me);
+
+static QState device_level_bring_up(device_level_t * const me);
+
+#ifdef DEVICE_LEVEL_SUSPEND
+static void device_level_resume_req(device_level_t * const me);
+#endif
+
+static QState device_level_resumed(device_level_t * const me);
+
+static void device_level_defer_or_reject(device_level_t * const me, QEvt const * const e);
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+static void device_level_schedule_req(device_level_t * const me, uint8_t batch);
+
+static void device_level_publish_sample(device_level_t * const me);
+
+static QState device_level_schedule_done(device_level_t * const me);
+static void device_level_publish_jitter(device_level_t * const me);
+#endif
+
+#ifdef DEVICE_LEVEL_ID_PROBE
+static void device_level_id_probe_req(device_level_t * const me);
+
+static void device_level_id_probe_again(device_level_t * const me);
+#endif
+
+static QState device_level_retry_or_fail(device_level_t * const me, int32_t hal_error);
+
+static void device_level_respond(device_level_t * const me);
+
+static void device_level_set_lockup(device_level_t * const me);
+
+static void device_level_fail(device_level_t * const me, int32_t error_code);
+
+static void device_level_respond_error(device_level_t * const me, QActive * const requestor, uint32_t req_id,
+                                       int32_t error_code, int32_t hal_error);
+
+static void device_level_reject_deferred(device_level_t * const me, int32_t error_code, int32_t hal_error);
+
+static void device_level_qs_txn(device_level_t * const me, uint8_t record);
+
+#if defined(DEVICE_LEVEL_FAST_PATH) && !defined(DEVICE_LEVEL_COMPONENT)
+static bool device_level_fast_complete(void * const me, QEvt const * const e);
+
+static bool device_level_fast_error(void * const me, QEvt const * const e);
+
+// Transfer results answered without walking the state handlers
+static ao_fast_path_entry_t const device_level_fast_path_table[] =
+{
+    {(QStateHandler)&device_level_read,  I2C_COMM_COMPLETE_SIG, &device_level_fast_complete, (QStateHandler)&device_level_idle},
+    {(QStateHandler)&device_level_write, I2C_COMM_COMPLETE_SIG, &device_level_fast_complete, (QStateHandler)&device_level_idle},
+    {(QStateHandler)&device_level_read,  I2C_COMM_ERROR_SIG,    &device_level_fast_error,    (QStateHandler)&device_level_recovering},
+    {(QStateHandler)&device_level_write, I2C_COMM_ERROR_SIG,    &device_level_fast_error,    (QStateHandler)&device_level_recovering},
+};
+#endif
+
+#ifdef DEVICE_LEVEL_I2C_CAPTURE
+static void device_level_capture(device_level_t * const me, i2c_capture_type_t type, int32_t error);
+#define DEVICE_LEVEL_CAPTURE(me_, type_, error_)    device_level_capture((me_), (type_), (error_))
+#else
+#define DEVICE_LEVEL_CAPTURE(me_, type_, error_)    ((void)0)
+#endif
 
 // Signals for use in local context only
 enum
 {
-    LOCAL_DEVICE_LEVEL_TIMEOUT_SIG = MAX_SIG,  /**< Timeout signal used in several spots >*/
+    LOCAL_DEVICE_LEVEL_TIMEOUT_SIG = DEVICE_LEVEL_LOCAL_SIG_BASE,  /**< Timeout signal used in several spots >*/
     LOCAL_DEVICE_LEVEL_BUSY_TIMEOUT_SIG,
     LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG,
     LOCAL_DEVICE_LEVEL_RETRY_SIG,
     LOCAL_DEVICE_LEVEL_I2C_TRANSACTION_START_RW_SIG,
+    LOCAL_DEVICE_LEVEL_ERROR_FLUSH_SIG,
+    LOCAL_DEVICE_LEVEL_AUTO_SLEEP_SIG,
+    LOCAL_DEVICE_LEVEL_FRAME_SIG,
+
+    LOCAL_DEVICE_LEVEL_SIG_END,
 };
 
+// The container routes this range to the component
+Q_ASSERT_COMPILE(LOCAL_DEVICE_LEVEL_SIG_END <= (DEVICE_LEVEL_LOCAL_SIG_BASE + DEVICE_LEVEL_LOCAL_SIG_COUNT));
+
+#ifdef DEVICE_LEVEL_ID_PROBE
+// The identity is read into the warm restart probe buffer
+Q_ASSERT_COMPILE(DEVICE_LEVEL_ID_LEN <= AO_CONFIG_CACHE_MAX_LEN);
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+// A batch is one I2C request
+Q_ASSERT_COMPILE(AO_SCHEDULE_BATCH_READS <= DEVICE_LEVEL_BURST_TRANSACTIONS);
+#endif
+
 /************************************************************************************/
 /***    START OF HSM                                                              ***/
 /************************************************************************************/
 
+#ifdef DEVICE_LEVEL_COMPONENT
+/**
+*   @brief      DEVICE_LEVEL orthogonal component constructor
+*   @details    Timeouts are delivered to the container, which dispatches them back
+*               to the component. Its RTC steps are measured as part of the
+*               container's.
+*   @param[in]  container   - AO the component runs in
+*   @param[out] nothing
+*   @return     nothing
+*/
+void device_level_component_ctor(QActive * const container)
+{
+    //Create a pointer to the instance of myself
+    device_level_t * const me = &ao_device_level;
+
+    me->container = container;
+
+    //Register the state machine, and set entry state
+    QHsm_ctor(&me->super, (QStateHandler)&device_level_initial);
+
+    // Create a timer object for DEVICE_LEVEL communications timeout detection
+    AO_TIMER_CTOR(&me->time_event,  container, LOCAL_DEVICE_LEVEL_TIMEOUT_SIG);
+
+    // Create a timer object for the DEVICE_LEVEL busy state timeout detection
+    AO_TIMER_CTOR(&me->busy_timer,  container, LOCAL_DEVICE_LEVEL_BUSY_TIMEOUT_SIG);
+
+    // Create a timer object to collect aggregated error reports
+    AO_TIMER_CTOR(&me->error_timer, container, LOCAL_DEVICE_LEVEL_ERROR_FLUSH_SIG);
+
+    // Delays retries that back off or wait for the bus
+    AO_TIMER_CTOR(&me->retry_timer, container, LOCAL_DEVICE_LEVEL_RETRY_SIG);
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+    // Measures the time spent in idle before the device is put to sleep
+    AO_TIMER_CTOR(&me->sleep_timer, container, LOCAL_DEVICE_LEVEL_AUTO_SLEEP_SIG);
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+    // Releases the frames of the static schedule
+    QTimeEvt_ctorX(&me->frame_timer, container, LOCAL_DEVICE_LEVEL_FRAME_SIG, 0U);
+#endif
+}
+#else
 /**
 *   @brief      DEVICE_LEVEL active object contructor
 *   @details
@@ -178,11 +568,42 @@ void device_level_ctor(void)
     QActive_ctor(&me->super, (QStateHandler)&device_level_initial);
 
     // Create a timer object for DEVICE_LEVEL communications timeout detection
-    QTimeEvt_ctorX(&me->time_event,  &me->super, LOCAL_DEVICE_LEVEL_TIMEOUT_SIG, 0U);
+    AO_TIMER_CTOR(&me->time_event,  &me->super, LOCAL_DEVICE_LEVEL_TIMEOUT_SIG);
 
     // Create a timer object for the DEVICE_LEVEL busy state timeout detection
-    QTimeEvt_ctorX(&me->busy_timer,  &me->super, LOCAL_DEVICE_LEVEL_BUSY_TIMEOUT_SIG, 0U);
+    AO_TIMER_CTOR(&me->busy_timer,  &me->super, LOCAL_DEVICE_LEVEL_BUSY_TIMEOUT_SIG);
+
+    // Create a timer object to collect aggregated error reports
+    AO_TIMER_CTOR(&me->error_timer, &me->super, LOCAL_DEVICE_LEVEL_ERROR_FLUSH_SIG);
+
+    // Delays retries that back off or wait for the bus
+    AO_TIMER_CTOR(&me->retry_timer, &me->super, LOCAL_DEVICE_LEVEL_RETRY_SIG);
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+    // Measures the time spent in idle before the device is put to sleep
+    AO_TIMER_CTOR(&me->sleep_timer, &me->super, LOCAL_DEVICE_LEVEL_AUTO_SLEEP_SIG);
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+    // Releases the frames of the static schedule
+    QTimeEvt_ctorX(&me->frame_timer, &me->super, LOCAL_DEVICE_LEVEL_FRAME_SIG, 0U);
+#endif
+
+#ifdef DEVICE_LEVEL_FAST_PATH
+    // Before the profiler, so the profiler measures the fast path steps too. A table
+    // that cannot be installed would leave every event on the state handlers, and
+    // dispatch_fast in sim_bench comparing them with themselves.
+    Q_ALLEGE(ao_fast_path_install(&me->super, &me->fast_path, device_level_fast_path_table,
+                                  (uint8_t)Q_DIM(device_level_fast_path_table)));
+#endif
+
+#ifdef DRIVER_RTC_PROFILER
+    // Measure every run-to-completion step of this AO. Fails only when every
+    // profiler hook is taken, which would leave the profile silently empty
+    Q_ALLEGE(ao_rtc_profiler_install(&me->super, &me->rtc_profiler));
+#endif
 }
+#endif
 
 /**
 *   @brief      Initial state as required by QP
@@ -208,12 +629,46 @@ static QState device_level_initial(device_level_t * me, QEvt const * const e)
     QS_FUN_DICTIONARY(&device_level_read);
     QS_FUN_DICTIONARY(&device_level_write);
     QS_FUN_DICTIONARY(&device_level_error);
+    QS_FUN_DICTIONARY(&device_level_recovering);
+#ifdef DEVICE_LEVEL_SUSPEND
+    QS_FUN_DICTIONARY(&device_level_suspended);
+    QS_FUN_DICTIONARY(&device_level_resuming);
+#endif
+#ifdef DEVICE_LEVEL_AUTO_POWER
+    QS_FUN_DICTIONARY(&device_level_powering);
+#endif
+#ifdef DEVICE_LEVEL_SCHEDULE
+    QS_FUN_DICTIONARY(&device_level_scheduled);
+#endif
+    DRIVER_QS_USR_DICTIONARIES();
 
     // Subscribe to the necessary I2C messages
-    QActive_subscribe((QActive *)me, I2C_BUS_STATUS_SIG);
+    QActive_subscribe(DEVICE_LEVEL_AO(me), I2C_BUS_STATUS_SIG);
 
     me->status = DEVICE_LEVEL_DISABLED;
 
+    // Initialize the timings
+    ao_timings_init(&me->ao_timings);
+    ao_duty_cycle_init(&me->duty_cycle);
+    ao_state_stats_init(&me->state_stats, DEVICE_LEVEL_STATE_COUNT);
+    ao_unhandled_init(&me->unhandled);
+    ao_error_agg_init(&me->error_agg);
+    ao_adaptive_timeout_init(&me->lockup, DEVICE_LEVEL_I2C_BUS_HZ, DEVICE_LEVEL_LOCKUP_MIN_MS,
+                             DEVICE_LEVEL_LOCKUP_TIME_MS);
+    ao_retry_policy_init(&me->retry_policy, device_level_retry_table, (uint8_t)Q_DIM(device_level_retry_table));
+    ao_config_cache_init(&me->config_cache);
+#ifdef DEVICE_LEVEL_SCHEDULE
+    if (!ao_schedule_init(&me->schedule, device_level_schedule_slots, (uint8_t)Q_DIM(device_level_schedule_slots),
+                          device_level_schedule_batches, (uint8_t)Q_DIM(device_level_schedule_batches),
+                          DEVICE_LEVEL_SCHEDULE_FRAME_MS))
+    {
+        DEBUG_OUT(1u, "%s: Schedule table rejected\n", DEVICE_LEVEL_NAME);
+    }
+#endif
+
+    // Requests that arrive during a warm restart wait here
+    QEQueue_init(&me->deferred_queue, me->deferred_queue_buf, Q_DIM(me->deferred_queue_buf));
+
     // Move to the idle state, and begin to service requests
     return Q_TRAN(&device_level_disabled);
 }
@@ -272,6 +727,54 @@ QState device_level_backstop(device_level_t * const me, QEvt const * const e)
             break;
         }
 
+        // Export the driver telemetry through QS
+        case DEVICE_LEVEL_REQ_TELEMETRY_SIG:
+        {
+            ao_duty_cycle_qs_dump(&me->duty_cycle, DEVICE_LEVEL_AO(me)->prio);
+            ao_state_stats_qs_dump(&me->state_stats, device_level_state_names, DEVICE_LEVEL_AO(me)->prio);
+            ao_unhandled_qs_dump(&me->unhandled, DEVICE_LEVEL_AO(me)->prio);
+            ao_startup_trace_qs_dump(&me->startup_trace, DEVICE_LEVEL_AO(me)->prio);
+#ifdef DEVICE_LEVEL_SCHEDULE
+            ao_schedule_qs_dump(&me->schedule, DEVICE_LEVEL_AO(me)->prio);
+#endif
+#if defined(DRIVER_RTC_PROFILER) && !defined(DEVICE_LEVEL_COMPONENT)
+            ao_rtc_profiler_qs_dump(&me->rtc_profiler, me->super.prio);
+#endif
+            status = Q_HANDLED();
+            break;
+        }
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+        // Jitter of each batch of the schedule, whether it runs or not
+        case DEVICE_LEVEL_REQ_JITTER_SIG:
+        {
+            device_level_publish_jitter(me);
+            status = Q_HANDLED();
+            break;
+        }
+
+        // Not running; a schedule stopped by a suspend stays stopped after the resume
+        case DEVICE_LEVEL_SCHEDULE_STOP_SIG:
+        {
+            me->schedule_resume = false;
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
+        // Publish the summaries of the error windows that have closed
+        case LOCAL_DEVICE_LEVEL_ERROR_FLUSH_SIG:
+        {
+            device_level_flush_errors(me);
+
+            if (ao_error_agg_is_pending(&me->error_agg))
+            {
+                AO_TIMER_ARM(&me->error_timer, MS_TO_TICKS(AO_ERROR_AGG_WINDOW_MS));
+            }
+            status = Q_HANDLED();
+            break;
+        }
+
         // If we receive a request to disable the device, service it here
         case DEVICE_LEVEL_DISABLE_SIG:
         {
@@ -287,16 +790,8 @@ QState device_level_backstop(device_level_t * const me, QEvt const * const e)
 
         default:
         {
-            // Catch unhandled signals here
-            if (e->sig < MAX_SIG)
-            {
-                DEBUG_OUT(1u, "%s: ignoring unhandled signal %s.\n", DEVICE_LEVEL_NAME, signals_get_signal_name(e->sig));
-            }
-            else
-            {
-                DEBUG_OUT(1u, "%s: ignoring unhandled signal %d.\n", DEVICE_LEVEL_NAME, (e->sig - MAX_SIG));
-            }
-
+            // Catch unhandled signals here, dumped with DEVICE_LEVEL_REQ_TELEMETRY_SIG
+            ao_unhandled_count(&me->unhandled, e->sig);
             break;
         }
     }
@@ -321,16 +816,42 @@ static QState device_level_disabled(device_level_t * me, QEvt const *e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_DISABLED);
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
+
             // Set device to disabled
             me->status = DEVICE_LEVEL_DISABLED;
             device_level_publish_status(me);
 
+#ifdef DEVICE_LEVEL_SCHEDULE
+            // The next enable starts from scratch, without the schedule
+            me->schedule_resume = false;
+#endif
+
+            bool serve_deferred = false;
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+            serve_deferred = me->parking;
+            me->parking = false;
+#endif
+            if (serve_deferred)
+            {
+                // A request that came in while parking wakes the driver right away
+                (void)QActive_recall(DEVICE_LEVEL_AO(me), &me->deferred_queue);
+            }
+            else
+            {
+                // Disabled, or the bus is gone: requests deferred meanwhile are not served
+                device_level_reject_deferred(me, E_WHOOP_DEVICE_LEVEL_I2C_ERROR, 0);
+            }
+
             status = Q_HANDLED();
             break;
         }
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_DISABLED);
             status = Q_HANDLED();
             break;
         }
@@ -339,7 +860,9 @@ static QState device_level_disabled(device_level_t * me, QEvt const *e)
         case DEVICE_LEVEL_ENABLE_SIG:
         {
             DEBUG_OUT(1u, "%s: Driver Starting\n", DEVICE_LEVEL_NAME);
-            status = Q_TRAN(&device_level_starting);
+            ao_startup_trace_begin(&me->startup_trace);
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_ENABLE);
+            status = device_level_bring_up(me);
             break;
         }
 
@@ -351,9 +874,32 @@ static QState device_level_disabled(device_level_t * me, QEvt const *e)
             break;
         }
 
+#ifdef DEVICE_LEVEL_SUSPEND
+        // Nothing to keep, the enable that follows configures from scratch
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        case DEVICE_LEVEL_RESUME_SIG:
+        {
+            DEBUG_OUT(2u, "%s: Disabled, nothing to suspend or resume\n", DEVICE_LEVEL_NAME);
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
         case DEVICE_LEVEL_WRITE_SIG:
         case DEVICE_LEVEL_READ_SIG:
         {
+#ifdef DEVICE_LEVEL_AUTO_POWER
+            // The request is served from idle once the driver is up
+            if (QActive_defer(DEVICE_LEVEL_AO(me), &me->deferred_queue, e))
+            {
+                DEBUG_OUT(1u, "%s: Driver Starting on request\n", DEVICE_LEVEL_NAME);
+                me->n_lazy_enables++;
+                ao_startup_trace_begin(&me->startup_trace);
+                ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_ENABLE);
+                status = device_level_bring_up(me);
+                break;
+            }
+#endif
             DEBUG_OUT(1u, "%s: Device is disabled, cannot complete request %d\n", DEVICE_LEVEL_NAME, e->sig);
             status = Q_HANDLED();
             break;
@@ -386,37 +932,108 @@ static QState device_level_starting(device_level_t * me, QEvt const *e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_STARTING);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_STARTING);
 
             // One-shot timer in case I2C not ready or unresponsive
-            whoop_qp_time_safe_arm(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_INIT_LOCKUP_TIME_MS), 0u);
-
+            me->n_retries = 0u;
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_INIT_LOCKUP_TIME_MS));
+
+#ifdef DEVICE_LEVEL_ID_PROBE
+            // Ready is reported once the device answers with its identity
+            me->id_poll_ms = DEVICE_LEVEL_ID_POLL_MIN_MS;
+            me->n_id_polls = 0u;
+            device_level_id_probe_req(me);
+#else
             // Post a local signal to begin the process
             static QEvt const start_rw_event = {LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG, 0, 0};
-            QACTIVE_POST(&me->super, &start_rw_event, me);
+            QACTIVE_POST(DEVICE_LEVEL_AO(me), &start_rw_event, me);
+#endif
             
             status = Q_HANDLED();
             break;
         }
 
+#ifdef DEVICE_LEVEL_ID_PROBE
+        case LOCAL_DEVICE_LEVEL_RETRY_SIG:
+        {
+            device_level_id_probe_req(me);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case I2C_COMM_COMPLETE_SIG:
+        {
+            i2c_comm_cmpt_event_t * p_evt = (i2c_comm_cmpt_event_t *) e;
+
+            status = Q_HANDLED();
+
+            if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->n_mismatched++;
+            }
+            else if (DEVICE_LEVEL_ID_MATCHES(me->probe_data))
+            {
+                DEBUG_OUT(1u, "%s: Device identified after %u polls\n", DEVICE_LEVEL_NAME, (unsigned)me->n_id_polls);
+                ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_ENTER_IDLE);
+                status = Q_TRAN(&device_level_idle);
+            }
+            else
+            {
+                // Still booting, or not the device we expect
+                me->n_id_mismatches++;
+                device_level_id_probe_again(me);
+            }
+            break;
+        }
+
+        case I2C_COMM_ERROR_SIG:
+        {
+            i2c_comm_error_event_t * p_evt = (i2c_comm_error_event_t *) e;
+
+            if (Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->last_hal_error = p_evt->error_code;
+                device_level_id_probe_again(me);
+            }
+            else
+            {
+                me->n_mismatched++;
+            }
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
         case LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG:
         {
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_ENTER_IDLE);
             status = Q_TRAN(&device_level_idle);
             break;
         }
 
-        // If timed out before the i2c bus is ready, re-enter state and try again
+        // If timed out before the i2c bus is ready, wait again
         case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
         {
-            bool retry_ok = device_level_try_retry(me);
-            
             status = Q_HANDLED();
-            
-            if (!retry_ok)
+
+            if (me->n_retries < DEVICE_LEVEL_I2C_ACTIVE_RETRIES)
+            {
+                me->n_retries++;
+                AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_INIT_LOCKUP_TIME_MS));
+#ifdef DEVICE_LEVEL_ID_PROBE
+                // The probe got no answer at all, ask again
+                AO_TIMER_DISARM(&me->retry_timer);
+                device_level_id_probe_req(me);
+#endif
+            }
+            else
             {
                 DEBUG_OUT(1u, "%s: Too many timeouts during startup, giving up\n", DEVICE_LEVEL_NAME);
                 status = Q_TRAN(&device_level_error);
             }
-            
+
             break;
         }
 
@@ -428,9 +1045,35 @@ static QState device_level_starting(device_level_t * me, QEvt const *e)
             break;
         }
 
+#ifdef DEVICE_LEVEL_SUSPEND
+        // Suspend once started, idle takes it
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        {
+            if (!QActive_defer(DEVICE_LEVEL_AO(me), &me->deferred_queue, e))
+            {
+                DEBUG_OUT(1u, "%s: Queue full, suspend dropped\n", DEVICE_LEVEL_NAME);
+            }
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+        // Requests wait for the bring-up they may have started
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        {
+            device_level_defer_or_reject(me, e);
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
         case Q_EXIT_SIG:
         {
-            QTimeEvt_disarm(&me->time_event);
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_STARTING);
+            AO_TIMER_DISARM(&me->time_event);
+            AO_TIMER_DISARM(&me->retry_timer);
             status = Q_HANDLED();
             break;
         }
@@ -461,14 +1104,21 @@ static QState device_level_enabled(device_level_t * const me, QEvt const * const
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_ENABLED);
             DEBUG_OUT(1u, "%s: Driver enabled.\n", DEVICE_LEVEL_NAME);
             // Mark the device status as enabled
             me->status = DEVICE_LEVEL_ENABLED;
             device_level_publish_status(me);
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_READY);
 
+#ifdef DRIVER_FAST_BRINGUP
+            // Every transition into enabled already targets one of its substates
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_SETTLED);
+#else
             // Post a local signal to begin the process
             static QEvt const start_rw_event = {LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG, 0, 0};
-            QACTIVE_POST(&me->super, &start_rw_event, me);
+            QACTIVE_POST(DEVICE_LEVEL_AO(me), &start_rw_event, me);
+#endif
 
             status = Q_HANDLED();
             break;
@@ -477,12 +1127,14 @@ static QState device_level_enabled(device_level_t * const me, QEvt const * const
         case LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG:
         {
             // Transition to Idle
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_SETTLED);
             status = Q_TRAN(&device_level_idle);
             break;
         }
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_ENABLED);
             status = Q_HANDLED();
             break;
         }
@@ -493,6 +1145,46 @@ static QState device_level_enabled(device_level_t * const me, QEvt const * const
             status = Q_HANDLED();
             break;
         }
+
+#ifdef DEVICE_LEVEL_SUSPEND
+        // Suspend once the current transfer is done, idle takes it
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        {
+            if (!QActive_defer(DEVICE_LEVEL_AO(me), &me->deferred_queue, e))
+            {
+                DEBUG_OUT(1u, "%s: Queue full, suspend dropped\n", DEVICE_LEVEL_NAME);
+            }
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+        // Same for the schedule, it starts from idle
+        case DEVICE_LEVEL_SCHEDULE_START_SIG:
+        {
+            if (!QActive_defer(DEVICE_LEVEL_AO(me), &me->deferred_queue, e))
+            {
+                DEBUG_OUT(1u, "%s: Queue full, schedule start dropped\n", DEVICE_LEVEL_NAME);
+            }
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_SCHEDULE_STOP_SIG:
+        {
+            DEBUG_OUT(2u, "%s: Schedule not running\n", DEVICE_LEVEL_NAME);
+            status = Q_HANDLED();
+            break;
+        }
+
+        // A frame released just before the schedule stopped
+        case LOCAL_DEVICE_LEVEL_FRAME_SIG:
+        {
+            status = Q_HANDLED();
+            break;
+        }
+#endif
         default:
         {
             break;
@@ -518,20 +1210,45 @@ static QState device_level_idle(device_level_t * const me, QEvt const * const e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_IDLE);
             // Set status as enabled
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
             me->status = DEVICE_LEVEL_ENABLED;
 
             // Reset the I2C request ID
             me->i2c_transaction_id = 0u;
+
+            // Serve a request deferred during a warm restart
+            (void)QActive_recall(DEVICE_LEVEL_AO(me), &me->deferred_queue);
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+            // Re-armed on every return to idle, so it only fires after a quiet period
+            AO_TIMER_ARM(&me->sleep_timer, MS_TO_TICKS(DEVICE_LEVEL_AUTO_SLEEP_MS));
+#endif
             status = Q_HANDLED();
             break;
         }
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_IDLE);
+#ifdef DEVICE_LEVEL_AUTO_POWER
+            AO_TIMER_DISARM(&me->sleep_timer);
+#endif
             status = Q_HANDLED();
             break;
         }
 
+#ifdef DEVICE_LEVEL_AUTO_POWER
+        case LOCAL_DEVICE_LEVEL_AUTO_SLEEP_SIG:
+        {
+            DEBUG_OUT(1u, "%s: Idle, putting the device to sleep\n", DEVICE_LEVEL_NAME);
+            me->power_sleeping = true;
+            me->n_auto_sleeps++;
+            status = Q_TRAN(&device_level_powering);
+            break;
+        }
+#endif
+
         case DEVICE_LEVEL_WRITE_SIG:
         {
             DEBUG_OUT(1u, "%s: Received write request\n", DEVICE_LEVEL_NAME);
@@ -545,11 +1262,38 @@ static QState device_level_idle(device_level_t * const me, QEvt const * const e)
             me->requestor               = Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt);
             me->write_data              = p_evt->buffer;
 
+            me->txn_seq++;
+            ao_retry_policy_reset(&me->retry_policy);
+            device_level_qs_txn(me, DRIVER_QS_TXN_ACCEPTED);
+
             status =  Q_TRAN(&device_level_write);
 
             break;
         }
 
+#ifdef DEVICE_LEVEL_SUSPEND
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        {
+            status = Q_TRAN(&device_level_suspended);
+            break;
+        }
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+        case DEVICE_LEVEL_SCHEDULE_START_SIG:
+        {
+            status = Q_HANDLED();
+
+            if (me->schedule.n_slots == 0u)
+            {
+                DEBUG_OUT(1u, "%s: No valid schedule table\n", DEVICE_LEVEL_NAME);
+                break;
+            }
+            status = Q_TRAN(&device_level_scheduled);
+            break;
+        }
+#endif
+
         case DEVICE_LEVEL_READ_SIG:
         {
             DEBUG_OUT(1u, "%s: Received read request\n", DEVICE_LEVEL_NAME);
@@ -566,6 +1310,10 @@ static QState device_level_idle(device_level_t * const me, QEvt const * const e)
             me->requestor                   = Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt);
             me->read_data                   = p_evt->buffer;
 
+            me->txn_seq++;
+            ao_retry_policy_reset(&me->retry_policy);
+            device_level_qs_txn(me, DRIVER_QS_TXN_ACCEPTED);
+
             status = Q_TRAN(&device_level_read);
 
             break;
@@ -598,15 +1346,31 @@ static QState device_level_busy(device_level_t * me, QEvt const *e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_BUSY);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
+
+            // Size the lockup timeout for this transfer, every attempt gets it
+            device_level_set_lockup(me);
+
+            // Room for the retries of every error class in turn, up to the busy limit
+            uint32_t busy_ms = ao_retry_policy_budget_ms(&me->retry_policy, me->lockup_ms);
+
+            if (busy_ms > DEVICE_LEVEL_BUSY_TIME_MS)
+            {
+                busy_ms = DEVICE_LEVEL_BUSY_TIME_MS;
+            }
+
             // Arm dedicated busy state timer
-            whoop_qp_time_safe_arm(&me->busy_timer, MS_TO_TICKS(DEVICE_LEVEL_BUSY_TIME_MS), 0);
+            AO_TIMER_ARM(&me->busy_timer, MS_TO_TICKS(busy_ms));
             status = Q_HANDLED();
             break;
         }
         case Q_EXIT_SIG:
         {
-            // Disarm timer
-            QTimeEvt_disarm(&me->busy_timer);
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_BUSY);
+            // Disarm timers
+            AO_TIMER_DISARM(&me->busy_timer);
+            AO_TIMER_DISARM(&me->retry_timer);
             status = Q_HANDLED();
             break;
         }
@@ -615,32 +1379,48 @@ static QState device_level_busy(device_level_t * me, QEvt const *e)
         case DEVICE_LEVEL_WRITE_SIG:
         case DEVICE_LEVEL_READ_SIG:
         {
-            // AO will need to subscribe to the busy signal
-            device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_BUSY, E_S_WHOOP_WARNING);
+            // Read and write requests share the replyable request header
+            device_level_read_request_event_t * p_evt = (device_level_read_request_event_t *) e;
+
+            device_level_respond_error(me, Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt), Q_GET_REPLYABLE_REQUEST_ID(p_evt),
+                                       E_WHOOP_DEVICE_LEVEL_BUSY, 0);
             me->last_error = E_WHOOP_DEVICE_LEVEL_BUSY;
             status = Q_HANDLED();
             break;
         }
 
-        case LOCAL_DEVICE_LEVEL_BUSY_TIMEOUT_SIG:
+        // A request recalled on the first entry to idle can overtake the self-posted
+        // transition to idle; the driver has settled, don't abandon the request
+        case LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG:
         {
-            // Problem: we didn't get an I2C response after the timeout interval
-            bool retry_ok = device_level_try_retry(me);
-
-            if (!retry_ok)
-            {
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT, E_S_WHOOP_ERROR);
-                me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT;
-                me->last_hal_error = E_TIME_OUT;
+            status = Q_HANDLED();
+            break;
+        }
 
-                status = Q_TRAN(&device_level_idle);
-            }
-            else
-            {
-                DEBUG_OUT(1u, "%s: Got timeout error during read, retrying\n", DEVICE_LEVEL_NAME);
-                status = Q_HANDLED();
-            }
+        // Re-issue the transfer, under a new I2C transaction id so that a late
+        // answer to the abandoned attempt is not taken for this one
+        case LOCAL_DEVICE_LEVEL_RETRY_SIG:
+        {
+            device_level_qs_txn(me, DRIVER_QS_TXN_RETRIED);
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(me->lockup_ms));
+            device_level_i2c_comm_req(me);
+            status = Q_HANDLED();
+            break;
+        }
+
+        // The busy timer covers every retry the policy allows, so this ends the request
+        case LOCAL_DEVICE_LEVEL_BUSY_TIMEOUT_SIG:
+        {
+            // Problem: we didn't get an I2C response after the timeout interval
+            device_level_qs_txn(me, DRIVER_QS_TXN_TIMED_OUT);
+            DEVICE_LEVEL_CAPTURE(me, I2C_CAPTURE_TIMEOUT, 0);
 
+            me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT;
+            me->last_hal_error = E_TIME_OUT;
+            device_level_respond_error(me, me->requestor, me->device_level_req_id,
+                                       E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT, E_TIME_OUT);
+
+            status = Q_TRAN(&device_level_idle);
             break;
         }
 
@@ -671,12 +1451,14 @@ static QState device_level_read(device_level_t * const me, QEvt const * const e)
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_READ);
             // Start a timer to catch i2c lockups.
-            whoop_qp_time_safe_arm(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_LOCKUP_TIME_MS), 0U);
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(me->lockup_ms));
 
             // Post a local signal to begin the process
             static QEvt const start_rw_event = {LOCAL_DEVICE_LEVEL_I2C_TRANSACTION_START_RW_SIG, 0, 0};
-            QACTIVE_POST(&me->super, &start_rw_event, me);
+            QACTIVE_POST(DEVICE_LEVEL_AO(me), &start_rw_event, me);
+            device_level_qs_txn(me, DRIVER_QS_TXN_QUEUED);
 
             status = Q_HANDLED();
             break;
@@ -684,8 +1466,9 @@ static QState device_level_read(device_level_t * const me, QEvt const * const e)
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_READ);
             // Disarm lockup detection timer if it hasn't already fired.
-            QTimeEvt_disarm(&me->time_event);
+            AO_TIMER_DISARM(&me->time_event);
             status = Q_HANDLED();
             break;
         }
@@ -706,25 +1489,18 @@ static QState device_level_read(device_level_t * const me, QEvt const * const e)
             // Make sure this is a response to our signal
             if (Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
             {
-                QTimeEvt_disarm(&me->time_event);
-
-                device_level_response_event_t * rsp_evt = Q_NEW(device_level_response_event_t, DEVICE_LEVEL_RESPONSE_SIG);
-                rsp_evt->req_type = DEVICE_LEVEL_READ;
-                rsp_evt->buffer = me->read_data;
-
-                QACTIVE_POST_REPLYABLE_RESPONSE(me->requestor, me->device_level_req_id, rsp_evt, me);
-
+                device_level_respond(me);
                 status = Q_TRAN(&device_level_idle);
-
             }
             else
             {
                 // If we received a mismatch, then it may not necessarily be an error. The replyable system allows
                 // for multiple requests from a single sender, with unique transaction id's. Since we are not using
                 // it in this way here, a mismatch, albeit highly unlikely, may in fact indicate an error here.
-                // Treat it as a warning at this point.
+                // Treat it as a warning at this point. The request is still pending, so there is
+                // nobody to answer; count it.
 
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID, E_S_WHOOP_WARNING);
+                me->n_mismatched++;
                 me->last_error = E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID;
                 status = Q_HANDLED();
 
@@ -740,23 +1516,17 @@ static QState device_level_read(device_level_t * const me, QEvt const * const e)
             if (Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
             {
                 DEBUG_OUT(1u, "%s: Got communication error during read\n", DEVICE_LEVEL_NAME);
-
-                QTimeEvt_disarm(&me->time_event);
-
-                device_level_publish_error_response(me, p_evt->error_code, E_S_WHOOP_ERROR);
-                me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_ERROR;
-                me->last_hal_error = p_evt->error_code;
-
-                status = Q_TRAN(&device_level_error);
+                status = device_level_retry_or_fail(me, p_evt->error_code);
             }
             else
             {
                 // If we received a mismatch, then it may not necessarily be an error. The replyable system allows
                 // for multiple requests from a single sender, with unique transaction id's. Since we are not using
                 // it in this way here, a mismatch, albeit highly unlikely, may in fact indicate an error here.
-                // Treat it as a warning at this point.
+                // Treat it as a warning at this point. The request is still pending, so there is
+                // nobody to answer; count it.
 
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID, E_S_WHOOP_WARNING);
+                me->n_mismatched++;
                 me->last_error = E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID;
                 status = Q_HANDLED();
             }
@@ -766,22 +1536,10 @@ static QState device_level_read(device_level_t * const me, QEvt const * const e)
         case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
         {
             // Problem: we didn't get an I2C response after the timeout interval
-            bool retry_ok = device_level_try_retry(me);
-
-            if (!retry_ok)
-            {
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT, E_S_WHOOP_ERROR);
-                me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT;
-                me->last_hal_error = E_TIME_OUT;
-
-                status = Q_TRAN(&device_level_idle);
-            }
-            else
-            {
-                DEBUG_OUT(1u, "%s: Got timeout error during read, retrying\n", DEVICE_LEVEL_NAME);
-                status = Q_HANDLED();
-            }
-
+            device_level_qs_txn(me, DRIVER_QS_TXN_TIMED_OUT);
+            DEVICE_LEVEL_CAPTURE(me, I2C_CAPTURE_TIMEOUT, 0);
+            DEBUG_OUT(1u, "%s: Got timeout error during read\n", DEVICE_LEVEL_NAME);
+            status = device_level_retry_or_fail(me, E_TIME_OUT);
             break;
         }
 
@@ -812,12 +1570,14 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
     {
         case Q_ENTRY_SIG:
         {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_WRITE);
             // Start a timer to catch i2c lockups.
-            whoop_qp_time_safe_arm(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_LOCKUP_TIME_MS), 0U);
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(me->lockup_ms));
 
             // Post a local signal to begin the process
             static QEvt const start_rw_event = {LOCAL_DEVICE_LEVEL_I2C_TRANSACTION_START_RW_SIG, 0, 0};
-            QACTIVE_POST(&me->super, &start_rw_event, me);
+            QACTIVE_POST(DEVICE_LEVEL_AO(me), &start_rw_event, me);
+            device_level_qs_txn(me, DRIVER_QS_TXN_QUEUED);
 
             status = Q_HANDLED();
             break;
@@ -825,8 +1585,9 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_WRITE);
             // Disarm lockup detection timer if it hasn't already fired.
-            QTimeEvt_disarm(&me->time_event);
+            AO_TIMER_DISARM(&me->time_event);
             status = Q_HANDLED();
             break;
         }
@@ -849,14 +1610,7 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
             // Make sure this is a response to our signal
             if (Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
             {
-                QTimeEvt_disarm(&me->time_event);
-
-                device_level_response_event_t * rsp_evt = Q_NEW(device_level_response_event_t, DEVICE_LEVEL_RESPONSE_SIG);
-                rsp_evt->req_type = DEVICE_LEVEL_WRITE;
-                rsp_evt->buffer = me->write_data;
-
-                QACTIVE_POST_REPLYABLE_RESPONSE(me->requestor, me->device_level_req_id, rsp_evt, me);
-
+                device_level_respond(me);
                 status = Q_TRAN(&device_level_idle);
             }
             else
@@ -864,9 +1618,10 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
                 // If we received a mismatch, then it may not necessarily be an error. The replyable system allows
                 // for multiple requests from a single sender, with unique transaction id's. Since we are not using
                 // it in this way here, a mismatch, albeit highly unlikely, may in fact indicate an error here.
-                // Treat it as a warning at this point.
+                // Treat it as a warning at this point. The request is still pending, so there is
+                // nobody to answer; count it.
 
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID, E_S_WHOOP_WARNING);
+                me->n_mismatched++;
                 me->last_error = E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID;
                 status = Q_HANDLED();
             }
@@ -881,22 +1636,17 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
             if (Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
             {
                 DEBUG_OUT(1u, "%s: Got communication error during write\n", DEVICE_LEVEL_NAME);
-                QTimeEvt_disarm(&me->time_event);
-
-                device_level_publish_error_response(me, p_evt->error_code, E_S_WHOOP_ERROR);
-                me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_ERROR;
-                me->last_hal_error = p_evt->error_code;
-
-                status = Q_TRAN(&device_level_error);
+                status = device_level_retry_or_fail(me, p_evt->error_code);
             }
             else
             {
                 // If we received a mismatch, then it may not necessarily be an error. The replyable system allows
                 // for multiple requests from a single sender, with unique transaction id's. Since we are not using
                 // it in this way here, a mismatch, albeit highly unlikely, may in fact indicate an error here.
-                // Treat it as a warning at this point.
+                // Treat it as a warning at this point. The request is still pending, so there is
+                // nobody to answer; count it.
 
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID, E_S_WHOOP_WARNING);
+                me->n_mismatched++;
                 me->last_error = E_WHOOP_DEVICE_LEVEL_MISMATCH_RESP_ID;
                 status = Q_HANDLED();
             }
@@ -906,22 +1656,153 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
         case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
         {
             // Problem: we didn't get an I2C response after the timeout interval
-            bool retry_ok = device_level_try_retry(me);
+            device_level_qs_txn(me, DRIVER_QS_TXN_TIMED_OUT);
+            DEVICE_LEVEL_CAPTURE(me, I2C_CAPTURE_TIMEOUT, 0);
+            DEBUG_OUT(1u, "%s: Got timeout error during write\n", DEVICE_LEVEL_NAME);
+            status = device_level_retry_or_fail(me, E_TIME_OUT);
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+/*! @brief      Warm restart after an I2C error
+*   @details    Recovers without the supervisor and without a starting cycle: the
+*               device is probed with one read of the first cached configuration
+*               register, and if the value read back differs, the cached
+*               configuration is written again. The driver then returns to idle,
+*               which serves the requests deferred meanwhile. Nothing is published
+*               unless the warm restart fails, so api_level keeps running.
+*
+*               recovery_step 0 is the probe, step k replays cache entry k - 1.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  QEvt        - pointer to event that caused entrance to state
+*   @param[out] nothing
+*   @return     QState      - pointer to the QHsm object
+*/
+static QState device_level_recovering(device_level_t * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&device_level_enabled);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_RECOVERING);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
+            me->n_warm_restarts++;
+            me->recovery_attempts = 0u;
+
+            // Give the bus a moment before the probe
+            AO_TIMER_ARM(&me->retry_timer, MS_TO_TICKS(DEVICE_LEVEL_WARM_RESTART_DELAY_MS));
+            status = Q_HANDLED();
+            break;
+        }
+
+        case Q_EXIT_SIG:
+        {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_RECOVERING);
+            AO_TIMER_DISARM(&me->time_event);
+            AO_TIMER_DISARM(&me->retry_timer);
+            status = Q_HANDLED();
+            break;
+        }
+
+        // Entered from resuming, enabled's self-posted transition to idle must not cut it short
+        case LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG:
+        {
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_DEVICE_LEVEL_RETRY_SIG:
+        {
+            me->recovery_step = 0u;
+            device_level_recovery_req(me);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case I2C_COMM_COMPLETE_SIG:
+        {
+            i2c_comm_cmpt_event_t * p_evt = (i2c_comm_cmpt_event_t *) e;
+
+            status = Q_HANDLED();
 
-            if (!retry_ok)
+            if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
             {
-                device_level_publish_error_response(me, E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT, E_S_WHOOP_ERROR);
-                me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT;
-                me->last_hal_error = E_TIME_OUT;
+                me->n_mismatched++;
+                break;
+            }
 
-                status = Q_TRAN(&device_level_idle);
+            AO_TIMER_DISARM(&me->time_event);
+
+            bool done = true;
+
+            if (me->recovery_step == 0u)
+            {
+                // The device answers, restore its configuration only if it lost it
+                ao_config_cache_entry_t const * const first = ao_config_cache_get(&me->config_cache, 0u);
+
+                done = (first == NULL) || ao_config_cache_matches(first, me->probe_data);
+                if (!done)
+                {
+                    me->n_config_replays++;
+                }
+            }
+            else
+            {
+                done = (me->recovery_step >= me->config_cache.count);
+            }
+
+            if (done)
+            {
+                DEBUG_OUT(1u, "%s: Warm restart complete\n", DEVICE_LEVEL_NAME);
+                status = device_level_resumed(me);
+            }
+            else
+            {
+                me->recovery_step++;
+                device_level_recovery_req(me);
+            }
+            break;
+        }
+
+        case I2C_COMM_ERROR_SIG:
+        {
+            i2c_comm_error_event_t * p_evt = (i2c_comm_error_event_t *) e;
+
+            if (Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->last_hal_error = p_evt->error_code;
+                status = device_level_recovery_retry(me);
             }
             else
             {
-                DEBUG_OUT(1u, "%s: Got timeout error during write, retrying\n", DEVICE_LEVEL_NAME);
+                me->n_mismatched++;
                 status = Q_HANDLED();
             }
+            break;
+        }
 
+        case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
+        {
+            me->last_hal_error = E_TIME_OUT;
+            status = device_level_recovery_retry(me);
+            break;
+        }
+
+        // Requests wait for the end of the warm restart
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        {
+            device_level_defer_or_reject(me, e);
+            status = Q_HANDLED();
             break;
         }
 
@@ -933,15 +1814,19 @@ static QState device_level_write(device_level_t * const me, QEvt const * const e
     return status;
 }
 
-/*! @brief      Superstate for fatal error condition
-*   @details    Don't move to disabled when we reach an error condition. Instead,
-*               enter the fatal error state and alert the supervisor.
+#ifdef DEVICE_LEVEL_SUSPEND
+/**
+*   @brief      Device may lose power, requests wait for the resume
+*   @details    Entered from idle, or from scheduled once its batch is off the
+*               bus, so no transfer is in flight. The configuration
+*               is packed on entry, leaving only the bus writes for the resume.
+*               Requests deferred here are served from idle after the resume.
 *   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
 *   @param[in]  QEvt        - pointer to event that caused entrance to state
 *   @param[out] nothing
 *   @return     QState      - pointer to the QHsm object
 */
-static QState device_level_error(device_level_t * const me, QEvt const *e)
+static QState device_level_suspended(device_level_t * const me, QEvt const * const e)
 {
     QState status = Q_SUPER(&device_level_backstop);
 
@@ -949,33 +1834,54 @@ static QState device_level_error(device_level_t * const me, QEvt const *e)
     {
         case Q_ENTRY_SIG:
         {
-            // Publish the error report signal.
-            me->status = DEVICE_LEVEL_FATAL_ERROR;
-            device_level_publish_status(me);
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_SUSPENDED);
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
 
+            ao_config_snapshot_take(&me->snapshot, &me->config_cache, DEVICE_LEVEL_AUTO_INCREMENT);
+            me->n_suspends++;
+            DEBUG_OUT(1u, "%s: Suspended, %u registers in %u runs\n", DEVICE_LEVEL_NAME,
+                      (unsigned)me->snapshot.n_registers, (unsigned)me->snapshot.n_runs);
             status = Q_HANDLED();
             break;
         }
 
         case Q_EXIT_SIG:
         {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_SUSPENDED);
             status = Q_HANDLED();
             break;
         }
 
-        // If we get the enable signal, try a restart
+        case DEVICE_LEVEL_RESUME_SIG:
+        {
+            me->resumed_at = AO_CLOCK_NOW();
+
+            if (me->snapshot.n_runs == 0u)
+            {
+                // Nothing to restore
+                me->resume_us = 0u;
+                status = device_level_resumed(me);
+            }
+            else
+            {
+                status = Q_TRAN(&device_level_resuming);
+            }
+            break;
+        }
+
+        case DEVICE_LEVEL_SUSPEND_SIG:
         case DEVICE_LEVEL_ENABLE_SIG:
         {
-            DEBUG_OUT(1u, "%s: Driver starting from fatal error state.\n", DEVICE_LEVEL_NAME);
-            status = Q_TRAN(&device_level_starting);
+            DEBUG_OUT(2u, "%s: Suspended, waiting for resume\n", DEVICE_LEVEL_NAME);
+            status = Q_HANDLED();
             break;
         }
-        
-        // Move to disabled if we get a disable signal
-        case DEVICE_LEVEL_DISABLE_SIG:
+
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
         {
-            DEBUG_OUT(1u, "%s: Driver disabling.\n", DEVICE_LEVEL_NAME);
-            status = Q_TRAN(&device_level_disabled);
+            device_level_defer_or_reject(me, e);
+            status = Q_HANDLED();
             break;
         }
 
@@ -987,137 +1893,1173 @@ static QState device_level_error(device_level_t * const me, QEvt const *e)
     return status;
 }
 
-/************************************************************************************/
-/***    END OF HSM                                                                ***/
-/************************************************************************************/
-
-/**
-*   @brief      Wrapper for I2C write
-*   @details
-*   @param[in]  device_level_t  - pointer to instance of DEVICE_LEVEL Active Object
-*   @param[in]  nothing
-*   @param[out] nothing
-*   @return     nothing
-*/
-static void device_level_i2c_write(device_level_t * const me)
-{
-    me->i2c_operation = I2C_WRITE;
-    device_level_i2c_comm_req(me);
-}
-
-/*! @fn         static void device_level_i2c_read(device_level_t * const me)
-*   @brief      Wrapper for I2C read
-*   @details
-*   @param[in]  device_level_t  - pointer to instance of DEVICE_LEVEL Active Object
-*   @param[in]  nothing
-*   @param[out] nothing
-*   @return     nothing
-*/
-static void device_level_i2c_read(device_level_t * const me)
-{
-    me->i2c_operation = I2C_READ;
-    device_level_i2c_comm_req(me);
-}
-
 /**
-*   @brief      Make an I2C request with the DEVICE_LEVEL data and the given operation
-*   @details
+*   @brief      Restore the configuration packed by suspended
+*   @details    resume_run is the first run of the burst in flight. A failed burst
+*               hands over to a warm restart, which restores register by register
+*               with retries.
 *   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
-*   @param[in]  i2c_ops_t   - Specifies operation to perform (read or write)
+*   @param[in]  QEvt        - pointer to event that caused entrance to state
 *   @param[out] nothing
-*   @return     nothing
+*   @return     QState      - pointer to the QHsm object
 */
-static void device_level_i2c_comm_req(device_level_t * const me)
+static QState device_level_resuming(device_level_t * const me, QEvt const * const e)
 {
-    i2c_comm_req_event_t * const p_evt = Q_NEW(i2c_comm_req_event_t, I2C_COMM_REQUEST_SIG);
-
-    p_evt->bus_id = INTERNAL;
-    p_evt->address = DEVICE_LEVEL_SLAVE_ADDRESS;
+    QState status = Q_SUPER(&device_level_backstop);
 
-    // Increment transaction ID
-    me->i2c_transaction_id++;
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_RESUMING);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
 
-    i2c_transaction_data_t transaction  = {0};
+            me->resume_run = 0u;
+            device_level_resume_req(me);
+            status = Q_HANDLED();
+            break;
+        }
 
-    transaction.reg_addr_md = I2C_USE_REG_ADDR;
-    transaction.operation = me->i2c_operation;
-    transaction.nak_expected = false;
-    transaction.rec_data = NULL;
-    transaction.rec_data_len = 0u;
-    transaction.send_data = NULL;
-    transaction.send_data_len = 0u;
-    transaction.reg_addr = 0u;
+        case Q_EXIT_SIG:
+        {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_RESUMING);
+            AO_TIMER_DISARM(&me->time_event);
+            status = Q_HANDLED();
+            break;
+        }
 
+        case I2C_COMM_COMPLETE_SIG:
+        {
+            i2c_comm_cmpt_event_t * p_evt = (i2c_comm_cmpt_event_t *) e;
 
-    if ((i2c_ops_t)(transaction.operation) == I2C_READ)
-    {
-        transaction.reg_addr = me->read_data.address;
-        transaction.rec_data = me->read_data.p_data;
-        transaction.rec_data_len = me->read_data.length;
+            status = Q_HANDLED();
 
-        DEBUG_OUT(1u, "%s: dispatching read request to I2C, addr = 0x%03x\n", DEVICE_LEVEL_NAME, me->read_data.address);
-    }
-    else if ((i2c_ops_t)(transaction.operation) == I2C_WRITE)
-    {
-        transaction.reg_addr = me->write_data.address;
-        transaction.send_data = me->write_data.p_data;
-        transaction.send_data_len = me->write_data.length;
-        DEBUG_OUT(1u, "%s: dispatching write request to I2C, addr = 0x%03x\n", DEVICE_LEVEL_NAME, me->write_data.address);
-    }
-    else
-    {
-        transaction.reg_addr = me->write_data.address;
-        transaction.rec_data = me->write_data.p_data;
-        transaction.rec_data_len = me->write_data.length;
+            if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->n_mismatched++;
+                break;
+            }
 
-        transaction.rec_data = me->read_data.p_data;
-        transaction.rec_data_len = me->read_data.length;
-        DEBUG_OUT(2u, "%s: dispatching write-verify request to I2C, addr = 0x%02x\n", DEVICE_LEVEL_NAME, me->write_data.address);
-    }
+            AO_TIMER_DISARM(&me->time_event);
+            me->resume_run = (uint8_t)(me->resume_run + me->resume_sent);
 
-    p_evt->transactions[0] = transaction;
-    p_evt->num_transactions = 1;
+            if (me->resume_run < me->snapshot.n_runs)
+            {
+                device_level_resume_req(me);
+            }
+            else
+            {
+                me->resume_us = AO_CLOCK_COUNTS_TO_US((timer_count_t)(AO_CLOCK_NOW() - me->resumed_at));
+                DEBUG_OUT(1u, "%s: Resumed in %lu us\n", DEVICE_LEVEL_NAME, (unsigned long)me->resume_us);
+                status = device_level_resumed(me);
+            }
+            break;
+        }
+
+        case I2C_COMM_ERROR_SIG:
+        {
+            i2c_comm_error_event_t * p_evt = (i2c_comm_error_event_t *) e;
+
+            status = Q_HANDLED();
+
+            if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->n_mismatched++;
+                break;
+            }
+
+            me->last_hal_error = p_evt->error_code;
+            DEBUG_OUT(1u, "%s: Resume failed, error %d\n", DEVICE_LEVEL_NAME, (int)me->last_hal_error);
+            status = Q_TRAN(&device_level_recovering);
+            break;
+        }
+
+        case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
+        {
+            me->last_hal_error = E_TIME_OUT;
+            DEBUG_OUT(1u, "%s: Resume timed out\n", DEVICE_LEVEL_NAME);
+            status = Q_TRAN(&device_level_recovering);
+            break;
+        }
+
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        {
+            device_level_defer_or_reject(me, e);
+            status = Q_HANDLED();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+/**
+*   @brief      Time-triggered sampling from the static schedule
+*   @details    Each tick of the periodic frame_timer releases a frame, and the
+*               batch of its slot is read unless the previous batch is still on
+*               the bus. Requests are refused meanwhile, so the schedule has the
+*               bus to itself. A stop or a suspend waits for the batch in flight.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  QEvt        - pointer to event that caused entrance to state
+*   @param[out] nothing
+*   @return     QState      - pointer to the QHsm object
+*/
+static QState device_level_scheduled(device_level_t * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&device_level_enabled);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_SCHEDULED);
+
+            me->schedule_busy = false;
+            me->schedule_stopping = false;
+
+            // Kept off the timing wheel: one periodic QTimeEvt, the frames follow its ticks
+            ao_schedule_start(&me->schedule);
+            whoop_qp_time_safe_arm(&me->frame_timer, MS_TO_TICKS(DEVICE_LEVEL_SCHEDULE_FRAME_MS),
+                                   MS_TO_TICKS(DEVICE_LEVEL_SCHEDULE_FRAME_MS));
+            DEBUG_OUT(1u, "%s: Schedule started, %u slots of %u ms\n", DEVICE_LEVEL_NAME,
+                      (unsigned)me->schedule.n_slots, (unsigned)DEVICE_LEVEL_SCHEDULE_FRAME_MS);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case Q_EXIT_SIG:
+        {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_SCHEDULED);
+            QTimeEvt_disarm(&me->frame_timer);
+            AO_TIMER_DISARM(&me->time_event);
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_DEVICE_LEVEL_FRAME_SIG:
+        {
+            uint8_t const batch = ao_schedule_release(&me->schedule, me->schedule_busy);
+
+            if (batch != AO_SCHEDULE_NO_BATCH)
+            {
+                device_level_schedule_req(me, batch);
+            }
+            status = Q_HANDLED();
+            break;
+        }
+
+        case I2C_COMM_COMPLETE_SIG:
+        {
+            i2c_comm_cmpt_event_t * p_evt = (i2c_comm_cmpt_event_t *) e;
+
+            status = Q_HANDLED();
+
+            if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->n_mismatched++;
+                break;
+            }
+
+            AO_TIMER_DISARM(&me->time_event);
+            device_level_publish_sample(me);
+            status = device_level_schedule_done(me);
+            break;
+        }
+
+        // Dropped, a retry would run into the next frame
+        case I2C_COMM_ERROR_SIG:
+        {
+            i2c_comm_error_event_t * p_evt = (i2c_comm_error_event_t *) e;
+
+            status = Q_HANDLED();
+
+            if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->n_mismatched++;
+                break;
+            }
+
+            AO_TIMER_DISARM(&me->time_event);
+            me->last_hal_error = p_evt->error_code;
+            me->n_sample_errors++;
+            status = device_level_schedule_done(me);
+            break;
+        }
+
+        case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
+        {
+            status = Q_HANDLED();
+
+            // Stale, the batch it was armed for is already off the bus
+            if (!me->schedule_busy)
+            {
+                break;
+            }
+
+            me->last_hal_error = E_TIME_OUT;
+            me->n_sample_errors++;
+            status = device_level_schedule_done(me);
+            break;
+        }
+
+        // The bus belongs to the schedule
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        {
+            // Read and write requests share the replyable request header
+            device_level_read_request_event_t * p_evt = (device_level_read_request_event_t *) e;
+
+            device_level_respond_error(me, Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt), Q_GET_REPLYABLE_REQUEST_ID(p_evt),
+                                       E_WHOOP_DEVICE_LEVEL_BUSY, 0);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_SCHEDULE_START_SIG:
+        {
+            DEBUG_OUT(2u, "%s: Schedule already running\n", DEVICE_LEVEL_NAME);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_SCHEDULE_STOP_SIG:
+        {
+            status = Q_HANDLED();
+
+            // A stop overrides a suspend waiting for the batch
+            me->schedule_resume = false;
+
+            if (!me->schedule_busy)
+            {
+                status = Q_TRAN(&device_level_idle);
+                break;
+            }
+
+            // No new frames, leave once the batch in flight is done
+            QTimeEvt_disarm(&me->frame_timer);
+            me->schedule_stopping = true;
+            break;
+        }
+
+#ifdef DEVICE_LEVEL_SUSPEND
+        // Stop the frames for the suspend, the resume starts them again
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        {
+            // Behind a stop, enabled defers it and idle takes it
+            if (me->schedule_stopping && !me->schedule_resume)
+            {
+                break;
+            }
+
+            status = Q_HANDLED();
+            me->schedule_resume = true;
+
+            if (!me->schedule_busy)
+            {
+                status = Q_TRAN(&device_level_suspended);
+                break;
+            }
+
+            QTimeEvt_disarm(&me->frame_timer);
+            me->schedule_stopping = true;
+            break;
+        }
+#endif
+
+        // Same race as in busy, the driver has settled
+        case LOCAL_DEVICE_LEVEL_ACTION_ENTER_IDLE_SIG:
+        {
+            status = Q_HANDLED();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+#endif
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+/**
+*   @brief      Write the power register on the way to sleep or back
+*   @details    Entered from idle after DEVICE_LEVEL_AUTO_SLEEP_MS without a request,
+*               then parks in disabled. Entered from disabled when a bring-up finds
+*               the device asleep, then continues the bring-up. A failed write is
+*               counted and the driver moves on; a device that did not wake is
+*               caught by the requests that follow. Requests are deferred
+*               meanwhile.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  QEvt        - pointer to event that caused entrance to state
+*   @param[out] nothing
+*   @return     QState      - pointer to the QHsm object
+*/
+static QState device_level_powering(device_level_t * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&device_level_backstop);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_POWERING);
+            ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
+
+            i2c_transaction_data_t transaction = {0};
+
+            transaction.operation = I2C_WRITE;
+            transaction.reg_addr_md = I2C_USE_REG_ADDR;
+            transaction.reg_addr = DEVICE_LEVEL_POWER_REGISTER;
+            transaction.send_data = me->power_sleeping ? device_level_power_sleep : device_level_power_wake;
+            transaction.send_data_len = 1u;
+            transaction.nak_expected = false;
+
+            AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_LOCKUP_TIME_MS));
+            device_level_i2c_dispatch(me, &transaction, 1u);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case Q_EXIT_SIG:
+        {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_POWERING);
+            AO_TIMER_DISARM(&me->time_event);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case I2C_COMM_COMPLETE_SIG:
+        case I2C_COMM_ERROR_SIG:
+        case LOCAL_DEVICE_LEVEL_TIMEOUT_SIG:
+        {
+            // Completion and error events share the replyable response header
+            i2c_comm_cmpt_event_t * p_evt = (i2c_comm_cmpt_event_t *) e;
+
+            if ((e->sig != LOCAL_DEVICE_LEVEL_TIMEOUT_SIG)
+                && !Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->i2c_transaction_id))
+            {
+                me->n_mismatched++;
+                status = Q_HANDLED();
+                break;
+            }
+
+            if (e->sig != I2C_COMM_COMPLETE_SIG)
+            {
+                me->n_power_errors++;
+            }
+
+            if (me->power_sleeping)
+            {
+                me->asleep = true;
+                me->parking = true;
+                status = Q_TRAN(&device_level_disabled);
+            }
+            else
+            {
+                me->asleep = false;
+                status = device_level_bring_up(me);
+            }
+            break;
+        }
+
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        {
+            device_level_defer_or_reject(me, e);
+            status = Q_HANDLED();
+            break;
+        }
+
+#ifdef DEVICE_LEVEL_SUSPEND
+        // Taken by idle after a wake, or by disabled after a sleep
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        {
+            if (!QActive_defer(DEVICE_LEVEL_AO(me), &me->deferred_queue, e))
+            {
+                DEBUG_OUT(1u, "%s: Queue full, suspend dropped\n", DEVICE_LEVEL_NAME);
+            }
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+#endif
+
+/*! @brief      Superstate for fatal error condition
+*   @details    Don't move to disabled when we reach an error condition. Instead,
+*               enter the fatal error state and alert the supervisor.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  QEvt        - pointer to event that caused entrance to state
+*   @param[out] nothing
+*   @return     QState      - pointer to the QHsm object
+*/
+static QState device_level_error(device_level_t * const me, QEvt const *e)
+{
+    QState status = Q_SUPER(&device_level_backstop);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            ao_state_stats_enter(&me->state_stats, DEVICE_LEVEL_STATE_ERROR);
+            // Publish the error report signal.
+            ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
+            me->status = DEVICE_LEVEL_FATAL_ERROR;
+            device_level_publish_status(me);
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+            // The next enable starts from scratch, without the schedule
+            me->schedule_resume = false;
+#endif
+
+            // Requests deferred during a failed warm restart will not be served
+            device_level_reject_deferred(me, E_WHOOP_DEVICE_LEVEL_I2C_ERROR, me->last_hal_error);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case Q_EXIT_SIG:
+        {
+            ao_state_stats_exit(&me->state_stats, DEVICE_LEVEL_STATE_ERROR);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        {
+            // Read and write requests share the replyable request header
+            device_level_read_request_event_t * p_evt = (device_level_read_request_event_t *) e;
+
+            device_level_respond_error(me, Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt), Q_GET_REPLYABLE_REQUEST_ID(p_evt),
+                                       E_WHOOP_DEVICE_LEVEL_I2C_ERROR, me->last_hal_error);
+            status = Q_HANDLED();
+            break;
+        }
+
+        // If we get the enable signal, try a restart
+        case DEVICE_LEVEL_ENABLE_SIG:
+        {
+            DEBUG_OUT(1u, "%s: Driver starting from fatal error state.\n", DEVICE_LEVEL_NAME);
+            ao_startup_trace_begin(&me->startup_trace);
+            ao_startup_trace_mark(&me->startup_trace, DEVICE_LEVEL_STARTUP_ENABLE);
+            status = Q_TRAN(&device_level_starting);
+            break;
+        }
+        
+        // Move to disabled if we get a disable signal
+        case DEVICE_LEVEL_DISABLE_SIG:
+        {
+            DEBUG_OUT(1u, "%s: Driver disabling.\n", DEVICE_LEVEL_NAME);
+            status = Q_TRAN(&device_level_disabled);
+            break;
+        }
+
+#ifdef DEVICE_LEVEL_SUSPEND
+        // Nothing to keep, the enable that follows configures from scratch
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        case DEVICE_LEVEL_RESUME_SIG:
+        {
+            DEBUG_OUT(1u, "%s: Fatal error, nothing to suspend or resume\n", DEVICE_LEVEL_NAME);
+            status = Q_HANDLED();
+            break;
+        }
+#endif
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+/************************************************************************************/
+/***    END OF HSM                                                                ***/
+/************************************************************************************/
+
+/**
+*   @brief      Wrapper for I2C write
+*   @details
+*   @param[in]  device_level_t  - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  nothing
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_i2c_write(device_level_t * const me)
+{
+    me->i2c_operation = I2C_WRITE;
+    device_level_i2c_comm_req(me);
+}
+
+/*! @fn         static void device_level_i2c_read(device_level_t * const me)
+*   @brief      Wrapper for I2C read
+*   @details
+*   @param[in]  device_level_t  - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  nothing
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_i2c_read(device_level_t * const me)
+{
+    me->i2c_operation = I2C_READ;
+    device_level_i2c_comm_req(me);
+}
+
+/**
+*   @brief      Make an I2C request with the DEVICE_LEVEL data and the given operation
+*   @details
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  i2c_ops_t   - Specifies operation to perform (read or write)
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_i2c_comm_req(device_level_t * const me)
+{
+    i2c_transaction_data_t transaction  = {0};
+
+    transaction.reg_addr_md = I2C_USE_REG_ADDR;
+    transaction.operation = me->i2c_operation;
+    transaction.nak_expected = false;
+    transaction.rec_data = NULL;
+    transaction.rec_data_len = 0u;
+    transaction.send_data = NULL;
+    transaction.send_data_len = 0u;
+    transaction.reg_addr = 0u;
+
+
+    if ((i2c_ops_t)(transaction.operation) == I2C_READ)
+    {
+        transaction.reg_addr = me->read_data.address;
+        transaction.rec_data = me->read_data.p_data;
+        transaction.rec_data_len = me->read_data.length;
+
+        DEBUG_OUT(1u, "%s: dispatching read request to I2C, addr = 0x%03x\n", DEVICE_LEVEL_NAME, me->read_data.address);
+    }
+    else if ((i2c_ops_t)(transaction.operation) == I2C_WRITE)
+    {
+        transaction.reg_addr = me->write_data.address;
+        transaction.send_data = me->write_data.p_data;
+        transaction.send_data_len = me->write_data.length;
+        DEBUG_OUT(1u, "%s: dispatching write request to I2C, addr = 0x%03x\n", DEVICE_LEVEL_NAME, me->write_data.address);
+    }
+    else
+    {
+        transaction.reg_addr = me->write_data.address;
+        transaction.rec_data = me->write_data.p_data;
+        transaction.rec_data_len = me->write_data.length;
+
+        transaction.rec_data = me->read_data.p_data;
+        transaction.rec_data_len = me->read_data.length;
+        DEBUG_OUT(2u, "%s: dispatching write-verify request to I2C, addr = 0x%02x\n", DEVICE_LEVEL_NAME, me->write_data.address);
+    }
+
+    device_level_i2c_dispatch(me, &transaction, 1u);
+}
+
+/**
+*   @brief      Post one transaction to the I2C AO under a new transaction id
+*   @details
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  transaction       - what to do on the bus
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_i2c_dispatch(device_level_t * const me, i2c_transaction_data_t const * const transactions,
+                                      uint8_t n_transactions)
+{
+    i2c_comm_req_event_t * const p_evt = Q_NEW(i2c_comm_req_event_t, I2C_COMM_REQUEST_SIG);
+
+    p_evt->bus_id = INTERNAL;
+    p_evt->address = DEVICE_LEVEL_SLAVE_ADDRESS;
+
+    // Increment transaction ID
+    me->i2c_transaction_id++;
+
+    for (uint8_t i = 0u; i < n_transactions; i++)
+    {
+        p_evt->transactions[i] = transactions[i];
+    }
+    p_evt->num_transactions = n_transactions;
+
+    me->dispatched_at = AO_CLOCK_NOW();
+    QACTIVE_POST_REPLYABLE_REQUEST(i2c_comm_ao, me->i2c_transaction_id, p_evt, DEVICE_LEVEL_AO(me));
+    device_level_qs_txn(me, DRIVER_QS_TXN_DISPATCHED);
+    DEVICE_LEVEL_CAPTURE(me, I2C_CAPTURE_REQUEST, 0);
+}
+
+/**
+*   @brief      Issue the current step of a warm restart
+*   @details    Step 0 reads back the first cached configuration register, or
+*               DEVICE_LEVEL_PROBE_REGISTER while nothing is cached. Step k writes
+*               cache entry k - 1. Each step gets the full lockup time, the
+*               latency statistics do not apply to a device that just failed.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_recovery_req(device_level_t * const me)
+{
+    i2c_transaction_data_t transaction = {0};
+
+    transaction.reg_addr_md = I2C_USE_REG_ADDR;
+    transaction.nak_expected = false;
+
+    if (me->recovery_step == 0u)
+    {
+        ao_config_cache_entry_t const * const first = ao_config_cache_get(&me->config_cache, 0u);
+
+        transaction.operation = I2C_READ;
+        transaction.reg_addr = (first != NULL) ? first->reg : DEVICE_LEVEL_PROBE_REGISTER;
+        transaction.rec_data = me->probe_data;
+        transaction.rec_data_len = (first != NULL) ? first->length : 1u;
+    }
+    else
+    {
+        ao_config_cache_entry_t const * const entry = ao_config_cache_get(&me->config_cache,
+                                                                          (uint8_t)(me->recovery_step - 1u));
+
+        transaction.operation = I2C_WRITE;
+        transaction.reg_addr = entry->reg;
+        transaction.send_data = entry->data;
+        transaction.send_data_len = entry->length;
+    }
+
+    AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_LOCKUP_TIME_MS));
+    device_level_i2c_dispatch(me, &transaction, 1u);
+}
+
+/**
+*   @brief      Start the warm restart over, or give up on it
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     QState            - status for the recovering state
+*/
+static QState device_level_recovery_retry(device_level_t * const me)
+{
+    AO_TIMER_DISARM(&me->time_event);
+    me->recovery_attempts++;
+
+    if (me->recovery_attempts >= DEVICE_LEVEL_WARM_RESTART_ATTEMPTS)
+    {
+        DEBUG_OUT(1u, "%s: Warm restart failed, error %d\n", DEVICE_LEVEL_NAME, (int)me->last_hal_error);
+        return Q_TRAN(&device_level_error);
+    }
+
+    DEVICE_LEVEL_BUS_RECOVER();
+    AO_TIMER_ARM(&me->retry_timer, MS_TO_TICKS(DEVICE_LEVEL_WARM_RESTART_DELAY_MS));
+    return Q_HANDLED();
+}
+
+#ifdef DEVICE_LEVEL_ID_PROBE
+/**
+*   @brief      Read the identity of the device during startup
+*   @details    The startup lockup timer stays armed, it bounds the whole probe.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_id_probe_req(device_level_t * const me)
+{
+    i2c_transaction_data_t transaction = {0};
+
+    transaction.operation = I2C_READ;
+    transaction.reg_addr_md = I2C_USE_REG_ADDR;
+    transaction.reg_addr = DEVICE_LEVEL_ID_REGISTER;
+    transaction.rec_data = me->probe_data;
+    transaction.rec_data_len = DEVICE_LEVEL_ID_LEN;
+    transaction.nak_expected = false;
+
+    memset(me->probe_data, 0, sizeof(me->probe_data));
+    me->n_id_polls++;
+    device_level_i2c_dispatch(me, &transaction, 1u);
+}
+
+/**
+*   @brief      Poll the identity again after a wait that doubles each time
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_id_probe_again(device_level_t * const me)
+{
+    AO_TIMER_ARM(&me->retry_timer, MS_TO_TICKS(me->id_poll_ms));
+
+    if (me->id_poll_ms < DEVICE_LEVEL_ID_POLL_MAX_MS)
+    {
+        me->id_poll_ms *= 2u;
+    }
+}
+#endif
+
+#ifdef DEVICE_LEVEL_SUSPEND
+/**
+*   @brief      Write the next burst of snapshot runs
+*   @details    One I2C request carries up to DEVICE_LEVEL_BURST_TRANSACTIONS runs,
+*               the I2C AO runs them back to back.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_resume_req(device_level_t * const me)
+{
+    i2c_transaction_data_t transactions[DEVICE_LEVEL_BURST_TRANSACTIONS];
+    uint8_t n = 0u;
+
+    memset(transactions, 0, sizeof(transactions));
+
+    while (n < DEVICE_LEVEL_BURST_TRANSACTIONS)
+    {
+        ao_config_snapshot_run_t const * const run = ao_config_snapshot_get(&me->snapshot,
+                                                                            (uint8_t)(me->resume_run + n));
+
+        if (run == NULL)
+        {
+            break;
+        }
+
+        transactions[n].operation = I2C_WRITE;
+        transactions[n].reg_addr_md = I2C_USE_REG_ADDR;
+        transactions[n].reg_addr = run->reg;
+        transactions[n].send_data = &me->snapshot.data[run->offset];
+        transactions[n].send_data_len = run->length;
+        transactions[n].nak_expected = false;
+        n++;
+    }
+
+    me->resume_sent = n;
+    AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_LOCKUP_TIME_MS));
+    device_level_i2c_dispatch(me, transactions, n);
+}
+#endif
+
+/**
+*   @brief      Leave a resume, or the warm restart that finished one
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     QState            - the schedule if it was running at the suspend, else idle
+*/
+static QState device_level_resumed(device_level_t * const me)
+{
+#ifdef DEVICE_LEVEL_SCHEDULE
+    if (me->schedule_resume)
+    {
+        me->schedule_resume = false;
+        return Q_TRAN(&device_level_scheduled);
+    }
+#else
+    (void)me;   // avoid compiler warning
+#endif
+
+    return Q_TRAN(&device_level_idle);
+}
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+/**
+*   @brief      Read the register batch of the frame just released
+*   @details    The reads land back to back in sample_data.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  batch             - batch number from ao_schedule_release()
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_schedule_req(device_level_t * const me, uint8_t batch)
+{
+    ao_schedule_batch_t const * const reads = ao_schedule_get_batch(&me->schedule, batch);
+    i2c_transaction_data_t transactions[AO_SCHEDULE_BATCH_READS];
+    uint8_t used = 0u;
+
+    memset(transactions, 0, sizeof(transactions));
+
+    for (uint8_t i = 0u; i < reads->n_reads; i++)
+    {
+        transactions[i].operation = I2C_READ;
+        transactions[i].reg_addr_md = I2C_USE_REG_ADDR;
+        transactions[i].reg_addr = reads->reads[i].reg;
+        transactions[i].rec_data = &me->sample_data[used];
+        transactions[i].rec_data_len = reads->reads[i].length;
+        transactions[i].nak_expected = false;
+        used = (uint8_t)(used + reads->reads[i].length);
+    }
+
+    // Taken now, the next release may come before the answer
+    me->sample_batch = batch;
+    me->sample_slot = me->schedule.slot;
+    me->sample_frame = me->schedule.n_frames;
+    me->sample_len = used;
+    me->schedule_busy = true;
+
+    ao_duty_cycle_set_busy(&me->duty_cycle, &me->ao_timings);
+    AO_TIMER_ARM(&me->time_event, MS_TO_TICKS(DEVICE_LEVEL_LOCKUP_TIME_MS));
+    device_level_i2c_dispatch(me, transactions, reads->n_reads);
+
+    // Measured at the request, after everything the frame had to do first
+    me->sample_deviation_us = ao_schedule_dispatched(&me->schedule, batch, me->dispatched_at);
+}
+
+/**
+*   @brief      Publish the registers read by a batch
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_publish_sample(device_level_t * const me)
+{
+    device_level_sample_event_t * const p_evt = Q_NEW(device_level_sample_event_t, DEVICE_LEVEL_SAMPLE_SIG);
+
+    p_evt->batch = me->sample_batch;
+    p_evt->slot = me->sample_slot;
+    p_evt->frame = me->sample_frame;
+    p_evt->released_at = me->dispatched_at;
+    p_evt->deviation_us = me->sample_deviation_us;
+    p_evt->length = me->sample_len;
+    memcpy(p_evt->data, me->sample_data, me->sample_len);
+
+    me->n_samples++;
+    QF_PUBLISH((QEvt *)p_evt, me);
+}
+
+/**
+*   @brief      The batch in flight is off the bus, whatever its outcome
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     QState            - idle or suspended if a stop or suspend was waiting for it
+*/
+static QState device_level_schedule_done(device_level_t * const me)
+{
+    me->schedule_busy = false;
+    ao_duty_cycle_set_idle(&me->duty_cycle, &me->ao_timings);
+
+    if (!me->schedule_stopping)
+    {
+        return Q_HANDLED();
+    }
+
+#ifdef DEVICE_LEVEL_SUSPEND
+    if (me->schedule_resume)
+    {
+        return Q_TRAN(&device_level_suspended);
+    }
+#endif
+
+    return Q_TRAN(&device_level_idle);
+}
+
+/**
+*   @brief      Publish the dispatch jitter of each batch, and export it through QS
+*   @details    One DEVICE_LEVEL_JITTER_REPORT_SIG per batch, the stream is the
+*               batch number.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_publish_jitter(device_level_t * const me)
+{
+    for (uint8_t batch = 0u; batch < me->schedule.n_batches; batch++)
+    {
+        device_level_jitter_report_event_t * const p_evt =
+            Q_NEW(device_level_jitter_report_event_t, DEVICE_LEVEL_JITTER_REPORT_SIG);
+
+        p_evt->stream = batch;
+        p_evt->n_streams = me->schedule.n_batches;
+        (void)ao_schedule_get_jitter(&me->schedule, batch, &p_evt->report);
+        QF_PUBLISH((QEvt *)p_evt, me);
+
+        ao_jitter_qs_dump(&me->schedule.dispatch[batch], batch, DEVICE_LEVEL_AO(me)->prio);
+    }
+}
+#endif
+
+/**
+*   @brief      Hold a request for later, or answer busy if the queue is full
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  e                 - read or write request
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_defer_or_reject(device_level_t * const me, QEvt const * const e)
+{
+    if (!QActive_defer(DEVICE_LEVEL_AO(me), &me->deferred_queue, e))
+    {
+        // Read and write requests share the replyable request header
+        device_level_read_request_event_t * p_evt = (device_level_read_request_event_t *) e;
+
+        device_level_respond_error(me, Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt),
+                                   Q_GET_REPLYABLE_REQUEST_ID(p_evt), E_WHOOP_DEVICE_LEVEL_BUSY, 0);
+    }
+}
+
+/**
+*   @brief      First state of a bring-up from disabled
+*   @details    A device put to sleep by DEVICE_LEVEL_AUTO_POWER is woken first.
+*               With DRIVER_FAST_BRINGUP starting is skipped, unless it has an
+*               identity probe to run.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     QState            - transition to take
+*/
+static QState device_level_bring_up(device_level_t * const me)
+{
+#ifdef DEVICE_LEVEL_AUTO_POWER
+    if (me->asleep)
+    {
+        me->power_sleeping = false;
+        return Q_TRAN(&device_level_powering);
+    }
+#else
+    (void)me;
+#endif
+
+#if defined(DRIVER_FAST_BRINGUP) && !defined(DEVICE_LEVEL_ID_PROBE)
+    // Starting only waits for its own self-post, skip it
+    return Q_TRAN(&device_level_idle);
+#else
+    return Q_TRAN(&device_level_starting);
+#endif
+}
+
+/**
+*   @brief      Answer the requestor of the transaction that just completed
+*   @details    Shared by the read and write states and the fast path.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_respond(device_level_t * const me)
+{
+    AO_TIMER_DISARM(&me->time_event);
+    ao_adaptive_timeout_observe(&me->lockup, me->wire_us,
+                                AO_CLOCK_COUNTS_TO_US((timer_count_t)(AO_CLOCK_NOW() - me->dispatched_at)));
+    device_level_qs_txn(me, DRIVER_QS_TXN_COMPLETED);
+    DEVICE_LEVEL_CAPTURE(me, I2C_CAPTURE_COMPLETE, 0);
+
+    device_level_response_event_t * rsp_evt = Q_NEW(device_level_response_event_t, DEVICE_LEVEL_RESPONSE_SIG);
+
+    if (me->i2c_operation == I2C_READ)
+    {
+        rsp_evt->req_type = DEVICE_LEVEL_READ;
+        rsp_evt->buffer = me->read_data;
+    }
+    else
+    {
+        rsp_evt->req_type = DEVICE_LEVEL_WRITE;
+        rsp_evt->buffer = me->write_data;
+
+        // Restored by a warm restart
+        if (DEVICE_LEVEL_IS_CONFIG_REG(me->write_data.address))
+        {
+            (void)ao_config_cache_store(&me->config_cache, me->write_data.address, me->write_data.p_data,
+                                        me->write_data.length);
+        }
+    }
+
+    QACTIVE_POST_REPLYABLE_RESPONSE(me->requestor, me->device_level_req_id, rsp_evt, me);
+    device_level_qs_txn(me, DRIVER_QS_TXN_RESPONDED);
+}
+
+/**
+*   @brief      Compute the lockup timeout of the pending transfer
+*   @details    Called on entry to busy, before the read or write state arms the
+*               lockup timer. Only completed transfers feed the latency statistics,
+*               so a stuck bus does not stretch the timeout that detects it.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_set_lockup(device_level_t * const me)
+{
+    if (me->i2c_operation == I2C_READ)
+    {
+        me->wire_us = ao_adaptive_timeout_wire_us(&me->lockup, true, 0u, me->read_data.length);
+    }
+    else
+    {
+        me->wire_us = ao_adaptive_timeout_wire_us(&me->lockup, true, me->write_data.length, 0u);
+    }
+
+    me->lockup_ms = ao_adaptive_timeout_ms(&me->lockup, me->wire_us);
+}
+
+/**
+*   @brief      Report the I2C error that ended the current transaction
+*   @details    Shared by the read and write states and the fast path.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  error_code        - HAL error from the I2C driver
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_fail(device_level_t * const me, int32_t error_code)
+{
+    AO_TIMER_DISARM(&me->time_event);
+    device_level_qs_txn(me, DRIVER_QS_TXN_FAILED);
+    DEVICE_LEVEL_CAPTURE(me, I2C_CAPTURE_ERROR, error_code);
+
+    me->last_error = E_WHOOP_DEVICE_LEVEL_I2C_ERROR;
+    me->last_hal_error = error_code;
+    device_level_respond_error(me, me->requestor, me->device_level_req_id,
+                               E_WHOOP_DEVICE_LEVEL_I2C_ERROR, error_code);
+
+    // The driver restarts, which concerns everybody
+    device_level_publish_error_response(me, error_code, E_S_WHOOP_ERROR);
+}
+
+/**
+*   @brief      Answer one requestor with an error
+*   @details    Errors of a single request go to its requestor only; publishing is
+*               kept for changes of the driver's own state.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  requestor         - AO that sent the request
+*   @param[in]  req_id            - replyable request ID of the request
+*   @param[in]  error_code        - E_WHOOP_DEVICE_LEVEL_* error
+*   @param[in]  hal_error         - error from the I2C driver, 0 if none
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_respond_error(device_level_t * const me, QActive * const requestor, uint32_t req_id,
+                                       int32_t error_code, int32_t hal_error)
+{
+    device_level_error_response_event_t * rsp_evt = Q_NEW(device_level_error_response_event_t,
+                                                          DEVICE_LEVEL_ERROR_RESPONSE_SIG);
+
+    rsp_evt->error_code = error_code;
+    rsp_evt->hal_error  = hal_error;
+
+    QACTIVE_POST_REPLYABLE_RESPONSE(requestor, req_id, rsp_evt, me);
+}
+
+/**
+*   @brief      Empty the deferred queue, answering each request with an error
+*   @details    Taken from the queue directly rather than recalled, so nothing is
+*               posted back to the AO. Other deferred events are dropped.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  error_code        - E_WHOOP_DEVICE_LEVEL_* error
+*   @param[in]  hal_error         - error from the I2C driver, 0 if none
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_reject_deferred(device_level_t * const me, int32_t error_code, int32_t hal_error)
+{
+    QEvt const * e;
+
+    while ((e = QEQueue_get(&me->deferred_queue, DEVICE_LEVEL_AO(me)->prio)) != (QEvt const *)0)
+    {
+        if ((e->sig == DEVICE_LEVEL_READ_SIG) || (e->sig == DEVICE_LEVEL_WRITE_SIG))
+        {
+            // Read and write requests share the replyable request header
+            device_level_read_request_event_t const * p_evt = (device_level_read_request_event_t const *) e;
+
+            device_level_respond_error(me, Q_GET_REPLYABLE_REQUEST_REQUESTOR(p_evt),
+                                       Q_GET_REPLYABLE_REQUEST_ID(p_evt), error_code, hal_error);
+        }
+
+        // Release the reference the queue held
+        QF_gc(e);
+    }
+}
+
+/**
+*   @brief      Returns TRUE if internal bus (DEVICE_LEVEL I2C bus) is ready
+*   @details
+*   @param[in]  i2c_bus_status_t  - internally reported state of i2c bus
+*   @param[in]  nothing
+*   @param[out] nothing
+*   @return     bool ready(True) or Not Ready (False)
+*/
+static bool device_level_func_is_i2c_bus_enabled(i2c_bus_status_t status)
+{
+    return (status == INTERNAL_ONLY_READY) || (status == BOTH_READY);
+}
+
+/**
+*   @brief      Publish an error response
+*   @details    Repeats of the same code are merged, see ao_error_agg.h.
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  error_code  - Reported error
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_publish_error_response(device_level_t * const me, int32_t error_code,
+        whoop_error_severity_t error_severity)
+{
+    ao_error_agg_report_t report;
+
+    DEBUG_OUT(2u, "%s: Error reported, error code 0x%02X\n", DEVICE_LEVEL_NAME, error_code);
 
-    QACTIVE_POST_REPLYABLE_REQUEST(i2c_comm_ao, me->i2c_transaction_id, p_evt, me);
+    // Summaries of closed windows go out before the new report
+    device_level_flush_errors(me);
 
+    switch (ao_error_agg_add(&me->error_agg, error_code, error_severity, &report))
+    {
+        case AO_ERROR_AGG_PUBLISH:
+        {
+            device_level_publish_error(me, &report);
+            break;
+        }
+        case AO_ERROR_AGG_HELD_FIRST:
+        {
+            AO_TIMER_ARM(&me->error_timer, MS_TO_TICKS(AO_ERROR_AGG_WINDOW_MS));
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
 }
 
 /**
-*   @brief      Returns TRUE if internal bus (DEVICE_LEVEL I2C bus) is ready
-*   @details
-*   @param[in]  i2c_bus_status_t  - internally reported state of i2c bus
-*   @param[in]  nothing
+*   @brief      Publish one error report, single or aggregated
+*   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  report            - report from the aggregator
 *   @param[out] nothing
-*   @return     bool ready(True) or Not Ready (False)
+*   @return     nothing
 */
-static bool device_level_func_is_i2c_bus_enabled(i2c_bus_status_t status)
+static void device_level_publish_error(device_level_t * const me, ao_error_agg_report_t const * const report)
 {
-    return (status == INTERNAL_ONLY_READY) || (status == BOTH_READY);
+    ao_error_agg_event_t * err_evt = Q_NEW(ao_error_agg_event_t, GENERIC_ERROR_REPORT_SIG);
+
+    ao_error_agg_fill(err_evt, report);
+    err_evt->super.ao_name      = DEVICE_LEVEL_NAME;
+    err_evt->super.error_subsys = E_WHOOP_SUBSYS_DEVICE_LEVEL;
+
+    // AO based extra info member
+    err_evt->super.extra_info   = 0u;
+
+    QF_PUBLISH((QEvt*)err_evt, me);
 }
 
 /**
-*   @brief      Publish an error response
-*   @details
+*   @brief      Publish the summaries of the error windows that have closed
 *   @param[in]  device_level_t    - pointer to instance of DEVICE_LEVEL Active Object
-*   @param[in]  error_code  - Reported error
 *   @param[out] nothing
 *   @return     nothing
 */
-static void device_level_publish_error_response(device_level_t * const me, int32_t error_code,
-        whoop_error_severity_t error_severity)
+static void device_level_flush_errors(device_level_t * const me)
 {
-    DEBUG_OUT(2u, "%s: Error reported, error code 0x%02X\n", DEVICE_LEVEL_NAME, error_code);
-    generic_error_signal_t * err_evt = Q_NEW(generic_error_signal_t, GENERIC_ERROR_REPORT_SIG);
-
-    err_evt->error_code     = error_code;
-    err_evt->ao_name        = DEVICE_LEVEL_NAME;
-    err_evt->error_severity = error_severity;
-    err_evt->error_subsys   = E_WHOOP_SUBSYS_DEVICE_LEVEL;
-
-    // AO based extra info member
-    err_evt->extra_info     = 0u;
+    ao_error_agg_report_t report;
 
-    QF_PUBLISH((QEvt*)err_evt, me);
+    while (ao_error_agg_next_report(&me->error_agg, &report))
+    {
+        device_level_publish_error(me, &report);
+    }
 }
 
 /*! @brief      Publish the status of the DEVICE_LEVEL AO
@@ -1144,6 +3086,70 @@ static void device_level_publish_status(device_level_t * const me)
     }
 }
 
+#ifdef DEVICE_LEVEL_COMPONENT
+/**
+*   @brief      Take the component's initial transition
+*   @details    Called by the container from its own initial transition.
+*   @param[in]  None
+*   @param[out] nothing
+*   @return     nothing
+*/
+void device_level_component_init(void)
+{
+    QHSM_INIT(&ao_device_level.super, (void *)0, ao_device_level.container->prio);
+}
+
+/**
+*   @brief      Dispatch an event to the component
+*   @details    Runs inside the container's run-to-completion step.
+*   @param[in]  e           - event owned by the component
+*   @param[out] nothing
+*   @return     nothing
+*/
+void device_level_component_dispatch(QEvt const * const e)
+{
+    QHSM_DISPATCH(&ao_device_level.super, e, ao_device_level.container->prio);
+}
+
+/**
+*   @brief      Tell the container whether an event is for the component
+*   @param[in]  sig         - signal of an event the container received
+*   @param[out] nothing
+*   @return     bool        - true to dispatch it to the component
+*/
+bool device_level_component_owns(QSignal sig)
+{
+    switch (sig)
+    {
+        case DEVICE_LEVEL_ENABLE_SIG:
+        case DEVICE_LEVEL_DISABLE_SIG:
+        case DEVICE_LEVEL_READ_SIG:
+        case DEVICE_LEVEL_WRITE_SIG:
+        case DEVICE_LEVEL_REQ_STAT_SIG:
+        case DEVICE_LEVEL_REQ_TELEMETRY_SIG:
+#ifdef DEVICE_LEVEL_SUSPEND
+        case DEVICE_LEVEL_SUSPEND_SIG:
+        case DEVICE_LEVEL_RESUME_SIG:
+#endif
+#ifdef DEVICE_LEVEL_SCHEDULE
+        case DEVICE_LEVEL_SCHEDULE_START_SIG:
+        case DEVICE_LEVEL_SCHEDULE_STOP_SIG:
+        case DEVICE_LEVEL_REQ_JITTER_SIG:
+#endif
+        case I2C_COMM_COMPLETE_SIG:
+        case I2C_COMM_ERROR_SIG:
+        case I2C_BUS_STATUS_SIG:
+        {
+            return true;
+        }
+        default:
+        {
+            return (sig >= DEVICE_LEVEL_LOCAL_SIG_BASE) &&
+                   (sig < (DEVICE_LEVEL_LOCAL_SIG_BASE + DEVICE_LEVEL_LOCAL_SIG_COUNT));
+        }
+    }
+}
+#else
 /**
 *   @brief      Setup and start the Active Object
 *   @details
@@ -1165,6 +3171,7 @@ void device_level_start(void)
                   0U,                           // stack size [bytes] (not used in QK)
                   (QEvt *)0);                   // initial event (or 0)
 }
+#endif
 
 /**
  * @brief Retrieve device_level status
@@ -1229,33 +3236,375 @@ int32_t device_level_get_last_error(void)
     return ao_device_level.last_error;
 }
 
-/*! @brief      Check the retry counter and try a retry
-*   @param[in]  device_level_t - Pointer to AO structure
+/**
+ * @brief Returns true while the AO is in a busy period
+ *
+ */
+bool device_level_is_busy(void)
+{
+    return ao_duty_cycle_is_busy(&ao_device_level.duty_cycle);
+}
+
+/**
+ * @brief Retrieve the accumulated busy time in timer counts
+ *
+ */
+timer_count_t device_level_get_active_counts(void)
+{
+    return ao_duty_cycle_get_active_counts(&ao_device_level.duty_cycle);
+}
+
+/**
+ * @brief Retrieve a snapshot of the duty cycle telemetry
+ *
+ */
+void device_level_get_duty_cycle(ao_duty_cycle_report_t * const report)
+{
+    ao_duty_cycle_get_report(&ao_device_level.duty_cycle, report);
+}
+
+/**
+ * @brief Retrieve dwell time and transition statistics for one state
+ *
+ */
+bool device_level_get_state_stats(device_level_state_id_t state, ao_state_stats_report_t * const report)
+{
+    return ao_state_stats_get_report(&ao_device_level.state_stats, (uint8_t)state, report);
+}
+
+/**
+ * @brief Number of events of one signal no state handled
+ *
+ */
+uint16_t device_level_get_unhandled_count(QSignal sig)
+{
+    return ao_unhandled_get(&ao_device_level.unhandled, sig);
+}
+
+/**
+ * @brief Number of I2C responses that did not match the transaction in progress
+ *
+ */
+uint32_t device_level_get_mismatch_count(void)
+{
+    return ao_device_level.n_mismatched;
+}
+
+/**
+ * @brief Lockup timeout of the last transfer, ms
+ *
+ */
+uint32_t device_level_get_lockup_ms(void)
+{
+    return ao_device_level.lockup_ms;
+}
+
+/**
+ * @brief Number of transfer errors the retry policy answered with an action
+ *
+ */
+uint32_t device_level_get_retry_decisions(ao_retry_action_t action)
+{
+    return (action < AO_RETRY_ACTION_COUNT) ? ao_device_level.retry_policy.decisions[action] : 0u;
+}
+
+/**
+ * @brief Number of warm restarts, and of those that had to restore the configuration
+ *
+ */
+uint32_t device_level_get_warm_restart_count(uint32_t * const config_replays)
+{
+    if (config_replays != NULL)
+    {
+        *config_replays = ao_device_level.n_config_replays;
+    }
+
+    return ao_device_level.n_warm_restarts;
+}
+
+/**
+ * @brief Time from the enable to a step of the last bring-up, false if not reached
+ *
+ */
+bool device_level_get_startup_step_us(device_level_startup_step_t step, uint32_t * const since_enable_us)
+{
+    return ao_startup_trace_get_us(&ao_device_level.startup_trace, (uint8_t)step, since_enable_us);
+}
+
+#ifdef DEVICE_LEVEL_SUSPEND
+/**
+ * @brief Time from DEVICE_LEVEL_RESUME_SIG to idle of the last resume, and suspends so far
+ *
+ */
+uint32_t device_level_get_resume_us(uint32_t * const suspends)
+{
+    if (suspends != NULL)
+    {
+        *suspends = ao_device_level.n_suspends;
+    }
+
+    return ao_device_level.resume_us;
+}
+#endif
+
+#ifdef DEVICE_LEVEL_SCHEDULE
+/**
+ * @brief Release jitter of the static schedule since it last started
+ *
+ */
+void device_level_get_schedule_report(ao_schedule_report_t * const report)
+{
+    ao_schedule_get_report(&ao_device_level.schedule, report);
+}
+
+/**
+ * @brief Samples published by the static schedule, and batches that failed
+ *
+ */
+uint32_t device_level_get_sample_count(uint32_t * const errors)
+{
+    if (errors != NULL)
+    {
+        *errors = ao_device_level.n_sample_errors;
+    }
+
+    return ao_device_level.n_samples;
+}
+
+/**
+ * @brief Dispatch jitter of one batch of the static schedule
+ *
+ */
+bool device_level_get_jitter(uint8_t batch, ao_jitter_report_t * const report)
+{
+    return ao_schedule_get_jitter(&ao_device_level.schedule, batch, report);
+}
+#endif
+
+#ifdef DEVICE_LEVEL_AUTO_POWER
+/**
+ * @brief Times idle put the device to sleep, and times a request brought the driver up
+ *
+ */
+uint32_t device_level_get_auto_power_count(uint32_t * const lazy_enables)
+{
+    if (lazy_enables != NULL)
+    {
+        *lazy_enables = ao_device_level.n_lazy_enables;
+    }
+
+    return ao_device_level.n_auto_sleeps;
+}
+#endif
+
+#ifdef DEVICE_LEVEL_ID_PROBE
+/**
+ * @brief Identity reads of the last bring-up, and reads that did not match since boot
+ *
+ */
+uint32_t device_level_get_id_polls(uint32_t * const mismatches)
+{
+    if (mismatches != NULL)
+    {
+        *mismatches = ao_device_level.n_id_mismatches;
+    }
+
+    return ao_device_level.n_id_polls;
+}
+#endif
+
+#if defined(DEVICE_LEVEL_FAST_PATH) && !defined(DEVICE_LEVEL_COMPONENT)
+/**
+ * @brief Turn the fast path on or off, for A/B measurements against the state handlers
+ *
+ */
+void device_level_set_fast_path(bool enable)
+{
+    ao_fast_path_enable(&ao_device_level.fast_path, enable);
+}
+
+/**
+ * @brief Number of transfer results answered on the fast path
+ *
+ */
+uint32_t device_level_get_fast_path_hits(void)
+{
+    return ao_device_level.fast_path.hits;
+}
+
+/**
+*   @brief      Fast path action for I2C_COMM_COMPLETE_SIG in the read and write states
+*   @details    Same effect as the state handlers; a mismatched id is left to them.
+*   @param[in]  me          - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  e           - I2C completion event
+*   @param[out] nothing
+*   @return     bool        - false if the event was declined
+*/
+static bool device_level_fast_complete(void * const me, QEvt const * const e)
+{
+    device_level_t * const dl = (device_level_t *)me;
+    i2c_comm_cmpt_event_t * p_evt = (i2c_comm_cmpt_event_t *)e;
+
+    if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, dl->i2c_transaction_id))
+    {
+        return false;
+    }
+
+    device_level_respond(dl);
+    return true;
+}
+
+/**
+*   @brief      Fast path action for I2C_COMM_ERROR_SIG in the read and write states
+*   @details    Same effect as the state handlers; a mismatched id is left to them.
+*   @param[in]  me          - pointer to instance of DEVICE_LEVEL Active Object
+*   @param[in]  e           - I2C error event
 *   @param[out] nothing
-*   @return     bool      - true if retry signal was posted, false otherwise
+*   @return     bool        - false if the event was declined
 */
-static bool device_level_try_retry(device_level_t * const me)
+static bool device_level_fast_error(void * const me, QEvt const * const e)
 {
-    bool retry_ok = true;
+    device_level_t * const dl = (device_level_t *)me;
+    i2c_comm_error_event_t * p_evt = (i2c_comm_error_event_t *)e;
 
-    // Check if we've already used all the retries
-    if (device_level_retry_counter >= DEVICE_LEVEL_I2C_ACTIVE_RETRIES)
+    if (!Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, dl->i2c_transaction_id))
     {
-        DEBUG_OUT(1u, "%s: Maximum number of retries (%u) reached\n", DEVICE_LEVEL_NAME, device_level_retry_counter);
+        return false;
+    }
 
-        retry_ok = false;
+    // Transient errors are retried by the state handlers
+    if (ao_retry_policy_lookup(&dl->retry_policy, p_evt->error_code) != AO_RETRY_FAIL)
+    {
+        return false;
     }
-    // If we still have retries available, then retry
-    else
+
+    uint32_t delay_ms = 0u;
+
+    DEBUG_OUT(1u, "%s: Got communication error\n", DEVICE_LEVEL_NAME);
+    (void)ao_retry_policy_decide(&dl->retry_policy, p_evt->error_code, &delay_ms);
+    device_level_fail(dl, p_evt->error_code);
+    return true;
+}
+#endif
+
+/**
+*   @brief      Apply the retry policy to an error of the current transfer
+*   @details    Transient errors are retried within the request, at once or from
+*               the retry timer. A transient error out of retries answers the
+*               requestor and returns to idle; other errors warm restart the
+*               driver.
+*   @param[in]  device_level_t - Pointer to AO structure
+*   @param[in]  hal_error      - HAL error, E_TIME_OUT for a lockup timeout
+*   @param[out] nothing
+*   @return     QState         - status for the calling state handler
+*/
+static QState device_level_retry_or_fail(device_level_t * const me, int32_t hal_error)
+{
+    uint32_t delay_ms = 0u;
+    ao_retry_action_t const action = ao_retry_policy_decide(&me->retry_policy, hal_error, &delay_ms);
+    QState status = Q_HANDLED();
+
+    AO_TIMER_DISARM(&me->time_event);
+    me->last_hal_error = hal_error;
+
+    switch (action)
     {
-        // Increment the retry counter
-        device_level_retry_counter++;
+        case AO_RETRY_NOW:
+        {
+            static QEvt const retry_evt = {LOCAL_DEVICE_LEVEL_RETRY_SIG, 0, 0};
+            QACTIVE_POST(DEVICE_LEVEL_AO(me), &retry_evt, me);
+            break;
+        }
+
+        case AO_RETRY_RECOVER:
+        {
+            DEVICE_LEVEL_BUS_RECOVER();
+            AO_TIMER_ARM(&me->retry_timer, MS_TO_TICKS(delay_ms));
+            break;
+        }
+
+        case AO_RETRY_BACKOFF:
+        {
+            AO_TIMER_ARM(&me->retry_timer, MS_TO_TICKS(delay_ms));
+            break;
+        }
+
+        case AO_RETRY_GIVE_UP:
+        {
+            int32_t const error_code = (hal_error == E_TIME_OUT) ? E_WHOOP_DEVICE_LEVEL_I2C_TIMEOUT :
+                                                                   E_WHOOP_DEVICE_LEVEL_I2C_ERROR;
+
+            DEBUG_OUT(1u, "%s: Out of retries, error %d\n", DEVICE_LEVEL_NAME, (int)hal_error);
+            device_level_qs_txn(me, DRIVER_QS_TXN_FAILED);
+            me->last_error = error_code;
+            device_level_respond_error(me, me->requestor, me->device_level_req_id, error_code, hal_error);
+
+            status = Q_TRAN(&device_level_idle);
+            break;
+        }
 
-        // Post retry signal
-        static QEvt const retry_evt = {LOCAL_DEVICE_LEVEL_RETRY_SIG, 0, 0};
-        QACTIVE_POST(&me->super, &retry_evt, me);
-        retry_ok = true;
+        default:
+        {
+            device_level_fail(me, hal_error);
+            status = Q_TRAN(&device_level_recovering);
+            break;
+        }
     }
 
-    return retry_ok;
+    return status;
+}
+
+/**
+*   @brief      Emit a transaction lifecycle QS record
+*   @details    See driver_qs_records.h for the record layout. The host analyzer in
+*               tools/qspy_txn_timeline.py rebuilds per-transaction timelines from these.
+*   @param[in]  device_level_t - Pointer to AO structure
+*   @param[in]  record         - One of the DRIVER_QS_TXN_* records
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_qs_txn(device_level_t * const me, uint8_t record)
+{
+    bool const read = (me->i2c_operation == I2C_READ);
+
+    (void)read;     // unused when QS is disabled
+    (void)record;
+
+    QS_BEGIN_ID(record, DEVICE_LEVEL_AO(me)->prio)
+        QS_U32(0, me->txn_seq);
+        QS_U32(0, me->i2c_transaction_id);
+        QS_U8(0, (uint8_t)me->i2c_operation);
+        QS_U16(0, (uint16_t)(read ? me->read_data.address : me->write_data.address));
+        QS_U16(0, (uint16_t)(read ? me->read_data.length : me->write_data.length));
+        QS_U32(0, (uint32_t)AO_CLOCK_NOW());
+    QS_END()
+}
+
+#ifdef DEVICE_LEVEL_I2C_CAPTURE
+/**
+*   @brief      Append a record of the current transaction to the I2C capture
+*   @details    The application installs the capture sink with i2c_capture_init().
+*   @param[in]  device_level_t - Pointer to AO structure
+*   @param[in]  type           - Record type
+*   @param[in]  error          - HAL error code for I2C_CAPTURE_ERROR, 0 otherwise
+*   @param[out] nothing
+*   @return     nothing
+*/
+static void device_level_capture(device_level_t * const me, i2c_capture_type_t type, int32_t error)
+{
+    bool const read = (me->i2c_operation == I2C_READ);
+
+    i2c_capture_record_t const record =
+    {
+        .timestamp  = (uint32_t)AO_CLOCK_NOW(),
+        .type       = (uint8_t)type,
+        .operation  = (uint8_t)me->i2c_operation,
+        .error      = (int8_t)error,
+        .reg        = (uint16_t)(read ? me->read_data.address : me->write_data.address),
+        .length     = (uint16_t)(read ? me->read_data.length : me->write_data.length),
+        .seq        = (uint16_t)me->txn_seq,
+    };
+
+    i2c_capture_record(&record);
 }
+#endif
@@ -1,5 +1,49 @@
 /**
  * @file        device_level.h
+ * @details     Build with DEVICE_LEVEL_COMPONENT to run device_level as an
+ *              orthogonal component (a plain QHsm) inside api_level instead of as
+ *              an AO of its own. The event API does not change: requests are still
+ *              posted to g_ao_device_level, which then names the container AO, and
+ *              the container dispatches them to the component in the same
+ *              run-to-completion step. Calls from api_level become synchronous
+ *              dispatches, and device_level needs no queue and no priority.
+ *
+ *              Build with DEVICE_LEVEL_FAST_PATH to answer transfer completions and
+ *              errors through ao_fast_path.h, a table lookup and a precomputed exit
+ *              and entry path, instead of the state handler switches. AO mode only.
+ *
+ *              Build with DRIVER_FAST_BRINGUP to collapse the bring-up: the enable
+ *              goes straight to idle and publishes the ready report in the same
+ *              run-to-completion step, without the starting state and the
+ *              self-posted transitions to idle. Shared with api_level, so that
+ *              driver stacks enabled back to back come up concurrently.
+ *
+ *              Build with DEVICE_LEVEL_ID_PROBE to read and check the device
+ *              identity in starting, so that the ready report means the device
+ *              answers. See DEVICE_LEVEL_ID_REGISTER in device_level.c.
+ *
+ *              Build with DEVICE_LEVEL_AUTO_POWER to have the first request bring the
+ *              driver up, without DEVICE_LEVEL_ENABLE_SIG, and to put the device to
+ *              sleep and park in disabled after a quiet period in idle. See
+ *              DEVICE_LEVEL_AUTO_SLEEP_MS in device_level.c.
+ *
+ *              Build with DEVICE_LEVEL_SUSPEND to take DEVICE_LEVEL_SUSPEND_SIG and
+ *              DEVICE_LEVEL_RESUME_SIG, which bracket a sleep in which the device
+ *              may lose power. The resume writes the cached
+ *              configuration back in one burst and serves the requests held
+ *              meanwhile.
+ *
+ *              The timers are ao_timer_t, armed through the AO_TIMER_* macros, so
+ *              that DRIVER_TIMER_WHEEL can move them onto the shared timing wheel.
+ *
+ *              Build with DEVICE_LEVEL_SCHEDULE for time-triggered sampling:
+ *              between DEVICE_LEVEL_SCHEDULE_START_SIG and
+ *              DEVICE_LEVEL_SCHEDULE_STOP_SIG the driver reads the register
+ *              batches of a static schedule (ao_schedule.h) from one periodic
+ *              timer, publishes them with DEVICE_LEVEL_SAMPLE_SIG, and refuses
+ *              requests. See DEVICE_LEVEL_SCHEDULE_FRAME_MS in device_level.c.
+ *              DEVICE_LEVEL_REQ_JITTER_SIG publishes the dispatch jitter of each
+ *              batch (ao_jitter.h) with DEVICE_LEVEL_JITTER_REPORT_SIG.
  */
 
 #ifndef device_level_H
@@ -8,11 +52,37 @@
 #include "replyables.h"
 #include "common.h"
 #include "whoop_i2c.h"
+#include "ao_timings.h"
+#include "ao_duty_cycle.h"
+#include "ao_rtc_profiler.h"
+#include "ao_fast_path.h"
+#include "ao_state_stats.h"
+#include "ao_unhandled.h"
+#include "ao_error_agg.h"
+#include "ao_adaptive_timeout.h"
+#include "ao_retry_policy.h"
+#include "ao_config_cache.h"
+#include "ao_config_snapshot.h"
+#include "ao_startup_trace.h"
+#include "ao_timer_wheel.h"
+#include "ao_schedule.h"
 
 #define DEVICE_LEVEL_NUM_REGISTERS   20u
 
 #define DEVICE_LEVEL_BUFFER_SIZE    DEVICE_LEVEL_NUM_REGISTERS
 
+// Requests held while a warm restart runs
+#define DEVICE_LEVEL_DEFERRED_QUEUE_SIZE    4u
+
+// Local signals. As a component they share the container's queue, so they are
+// kept clear of the container's own local signals.
+#ifdef DEVICE_LEVEL_COMPONENT
+#define DEVICE_LEVEL_LOCAL_SIG_BASE     (MAX_SIG + 32u)
+#else
+#define DEVICE_LEVEL_LOCAL_SIG_BASE     MAX_SIG
+#endif
+#define DEVICE_LEVEL_LOCAL_SIG_COUNT    8u
+
 // Enumerated driver status
 typedef enum
 {
@@ -23,27 +93,129 @@ typedef enum
 
 } device_level_status_t;
 
+// State numbers used for dwell time and transition statistics
+typedef enum
+{
+    DEVICE_LEVEL_STATE_DISABLED   = 0,
+    DEVICE_LEVEL_STATE_STARTING   = 1,
+    DEVICE_LEVEL_STATE_ENABLED    = 2,
+    DEVICE_LEVEL_STATE_IDLE       = 3,
+    DEVICE_LEVEL_STATE_BUSY       = 4,
+    DEVICE_LEVEL_STATE_READ       = 5,
+    DEVICE_LEVEL_STATE_WRITE      = 6,
+    DEVICE_LEVEL_STATE_ERROR      = 7,
+    DEVICE_LEVEL_STATE_RECOVERING = 8,
+    DEVICE_LEVEL_STATE_POWERING   = 9,
+    DEVICE_LEVEL_STATE_SUSPENDED  = 10,
+    DEVICE_LEVEL_STATE_RESUMING   = 11,
+    DEVICE_LEVEL_STATE_SCHEDULED  = 12,
+
+    DEVICE_LEVEL_STATE_COUNT,
+} device_level_state_id_t;
+
+// Bring-up steps timestamped in the startup trace
+typedef enum
+{
+    DEVICE_LEVEL_STARTUP_ENABLE       = 0,  /**< DEVICE_LEVEL_ENABLE_SIG received >*/
+    DEVICE_LEVEL_STARTUP_STARTING     = 1,  /**< starting entered >*/
+    DEVICE_LEVEL_STARTUP_ENTER_IDLE   = 2,  /**< Self-posted transition to idle dispatched >*/
+    DEVICE_LEVEL_STARTUP_READY        = 3,  /**< enabled entered, ready report published >*/
+    DEVICE_LEVEL_STARTUP_SETTLED      = 4,  /**< Second self-posted transition to idle dispatched >*/
+
+    DEVICE_LEVEL_STARTUP_STEP_COUNT,
+} device_level_startup_step_t;
+
 /*! @struct device_level_t
 *   @brief  Active Object structure
 */
 typedef struct
 {
+#ifdef DEVICE_LEVEL_COMPONENT
+    QHsm                    super;
+    QActive *               container;                          /**< AO the component runs in >*/
+#else
     QActive                 super;
+#endif
     QActive *               requestor;                          /**< Ptr to AO whose request we're servicing >*/
     uint32_t                device_level_req_id;                /**< I2C Request ID >*/
-    QTimeEvt                time_event;                         /**< Timeout timer. >*/
-    QTimeEvt                startup_timer;                      /**< Timeout timer. >*/
-    QTimeEvt                busy_timer;                         /**< Dedicated Busy State timer. >*/
+    ao_timer_t              time_event;                         /**< Timeout timer. >*/
+    ao_timer_t              busy_timer;                         /**< Dedicated Busy State timer. >*/
+    ao_timer_t              error_timer;                        /**< Collects aggregated error reports >*/
+    ao_timer_t              retry_timer;                        /**< Delayed retries of the current transfer >*/
     uint32_t                i2c_transaction_id;                 /**< I2C request id value >*/
     i2c_ops_t               i2c_operation;                      /**< I2C read or write? >*/
     uint8_t                 write_data[DEVICE_LEVEL_BUFFER_SIZE];     /**< Data Buffer for write requests > */
     uint8_t                 read_data[DEVICE_LEVEL_BUFFER_SIZE];      /**< Data Buffer for read requests > */
     device_level_register_t reg_ptr;                            /**< Register to be read or written to >*/
     uint32_t                data_len;                           /**< Length of data to be read/written >*/
-    uint8_t                 n_retries;                          /**< I2C Retry attempts > */
+    uint8_t                 n_retries;                          /**< Startup retry attempts > */
     uint8_t                 event_req_id;                       /**< Request ID of requests sent to the AO */
+    uint32_t                txn_seq;                            /**< Number of the transaction being serviced >*/
+    uint32_t                n_mismatched;                       /**< I2C responses for another transaction >*/
+    ao_adaptive_timeout_t   lockup;                             /**< Lockup timeout from transfer size and latency >*/
+    uint32_t                lockup_ms;                          /**< Lockup timeout of the current transfer >*/
+    uint32_t                wire_us;                            /**< Wire time of the current transfer >*/
+    timer_count_t           dispatched_at;                      /**< AO clock time the I2C request was posted >*/
+    ao_retry_policy_t       retry_policy;                       /**< Retries per error class >*/
+    ao_config_cache_t       config_cache;                       /**< Configuration restored by a warm restart >*/
+    QEQueue                 deferred_queue;                     /**< Requests held during a warm restart >*/
+    QEvt const *            deferred_queue_buf[DEVICE_LEVEL_DEFERRED_QUEUE_SIZE];
+    uint8_t                 probe_data[AO_CONFIG_CACHE_MAX_LEN];    /**< Read back by the warm restart probe >*/
+    uint8_t                 recovery_step;                      /**< 0 probe, k replays cache entry k - 1 >*/
+    uint8_t                 recovery_attempts;                  /**< Failed warm restart attempts >*/
+    uint32_t                n_warm_restarts;
+    uint32_t                n_config_replays;                   /**< Warm restarts that restored the configuration >*/
+    ao_startup_trace_t      startup_trace;                      /**< Timestamps of the last bring-up >*/
+#ifdef DEVICE_LEVEL_ID_PROBE
+    uint16_t                id_poll_ms;                         /**< Wait before the next identity read >*/
+    uint32_t                n_id_polls;                         /**< Identity reads of the last bring-up >*/
+    uint32_t                n_id_mismatches;                    /**< Identity reads that answered another value >*/
+#endif
+#ifdef DEVICE_LEVEL_AUTO_POWER
+    ao_timer_t              sleep_timer;                        /**< Quiet period in idle before sleeping >*/
+    bool                    asleep;                             /**< Device put to sleep by the driver >*/
+    bool                    power_sleeping;                     /**< Direction of the power register write >*/
+    bool                    parking;                            /**< Entering disabled after a sleep write >*/
+    uint32_t                n_auto_sleeps;
+    uint32_t                n_lazy_enables;                     /**< Bring-ups started by a request >*/
+    uint32_t                n_power_errors;                     /**< Power register writes that failed >*/
+#endif
+#ifdef DEVICE_LEVEL_SUSPEND
+    ao_config_snapshot_t    snapshot;                           /**< Configuration packed at suspend >*/
+    uint8_t                 resume_run;                         /**< First snapshot run of the burst in flight >*/
+    uint8_t                 resume_sent;                        /**< Runs in the burst in flight >*/
+    timer_count_t           resumed_at;                         /**< AO clock time of DEVICE_LEVEL_RESUME_SIG >*/
+    uint32_t                resume_us;                          /**< Duration of the last resume >*/
+    uint32_t                n_suspends;
+#endif
+#ifdef DEVICE_LEVEL_SCHEDULE
+    ao_schedule_t           schedule;                           /**< Static schedule and its release jitter >*/
+    QTimeEvt                frame_timer;                        /**< Periodic, one tick per minor frame >*/
+    bool                    schedule_busy;                      /**< A batch is on the bus >*/
+    bool                    schedule_stopping;                  /**< Stop or suspend received, waiting for the batch >*/
+    bool                    schedule_resume;                    /**< Suspended while running, restart on the resume >*/
+    uint8_t                 sample_batch;                       /**< Batch on the bus >*/
+    uint8_t                 sample_slot;                        /**< Slot that released it >*/
+    uint8_t                 sample_len;
+    uint32_t                sample_frame;                       /**< Frame that released it >*/
+    int32_t                 sample_deviation_us;                /**< Release deviation of that frame >*/
+    uint8_t                 sample_data[AO_SCHEDULE_BATCH_BYTES];
+    uint32_t                n_samples;
+    uint32_t                n_sample_errors;                    /**< Batches dropped on an error or timeout >*/
+#endif
     uint32_t                debug_level;                        /**< Current threshold for gating debug output. >*/
     device_level_status_t   status;                             /**< Current status of the AO. >*/
+    ao_timings_t            ao_timings;                         /**< Timing data >*/
+    ao_duty_cycle_t         duty_cycle;                         /**< Duty cycle telemetry built on ao_timings >*/
+    ao_state_stats_t        state_stats;                        /**< Dwell time and transition counts per state >*/
+    ao_unhandled_t          unhandled;                          /**< Events no state handled, per signal >*/
+    ao_error_agg_t          error_agg;                          /**< Merges repeated error reports >*/
+#if defined(DRIVER_RTC_PROFILER) && !defined(DEVICE_LEVEL_COMPONENT)
+    ao_rtc_profiler_t       rtc_profiler;                       /**< RTC step cost statistics >*/
+#endif
+#if defined(DEVICE_LEVEL_FAST_PATH) && !defined(DEVICE_LEVEL_COMPONENT)
+    ao_fast_path_t          fast_path;                          /**< Table-driven dispatch of transfer results >*/
+#endif
 } device_level_t;
 
 // opaque pointer to internal active object
@@ -116,14 +288,97 @@ typedef struct
     whoop_error_t                   error;        /**<Whoop error information*/
 } device_level_error_event_t;
 
+/**
+    @brief Error response to a read or write request
+    @note  This is a replyable response, posted to the requestor only with
+           DEVICE_LEVEL_ERROR_RESPONSE_SIG. It ends the request like
+           DEVICE_LEVEL_RESPONSE_SIG does.
+*/
+typedef struct
+{
+    /* inherit: */
+    q_event_replyable_response_t    super;        /**<Extend q_event_replyable_response_t */
+
+    /* extend: */
+    int32_t                         error_code;   /**<E_WHOOP_DEVICE_LEVEL_* error */
+    int32_t                         hal_error;    /**<Error from the I2C driver, 0 if none */
+} device_level_error_response_event_t;
+
+/**
+    @brief Registers read by one frame of the static schedule
+    @note  Published with DEVICE_LEVEL_SAMPLE_SIG when built with
+           DEVICE_LEVEL_SCHEDULE
+*/
+typedef struct
+{
+    QEvt                            super;        /**<Extend the QEvent class */
+
+    uint8_t                         batch;        /**<Batch read */
+    uint8_t                         slot;         /**<Slot of the major cycle that read it */
+    uint32_t                        frame;        /**<Frame number since the schedule started */
+    timer_count_t                   released_at;  /**<AO clock time the batch was posted to the bus */
+    int32_t                         deviation_us; /**<Dispatch time minus ideal time of the frame */
+    uint8_t                         length;
+    uint8_t                         data[AO_SCHEDULE_BATCH_BYTES];    /**<The reads of the batch, back to back */
+} device_level_sample_event_t;
+
+/**
+    @brief Dispatch jitter of one batch of the static schedule
+    @note  Published with DEVICE_LEVEL_JITTER_REPORT_SIG, one per batch, in
+           answer to DEVICE_LEVEL_REQ_JITTER_SIG
+*/
+typedef struct
+{
+    QEvt                            super;        /**<Extend the QEvent class */
+
+    uint8_t                         stream;       /**<Batch the report is for */
+    uint8_t                         n_streams;    /**<Reports published for this request */
+    ao_jitter_report_t              report;
+} device_level_jitter_report_event_t;
+
 // Helper functions
+#ifdef DEVICE_LEVEL_COMPONENT
+void device_level_component_ctor(QActive * const container);
+void device_level_component_init(void);
+void device_level_component_dispatch(QEvt const * const e);
+bool device_level_component_owns(QSignal sig);
+#else
 void device_level_ctor(void);
 void device_level_start(void);
+#endif
 device_level_status_t device_level_get_status(void);
 device_level_register_t device_level_get_write_address(void);
 uint8_t * device_level_get_write_data(void);
 device_level_register_t device_level_get_read_address(void);
 uint8_t * device_level_get_read_data(void);
 void device_level_set_debug_level(uint32_t level);
+bool device_level_is_busy(void);
+timer_count_t device_level_get_active_counts(void);
+void device_level_get_duty_cycle(ao_duty_cycle_report_t * const report);
+bool device_level_get_state_stats(device_level_state_id_t state, ao_state_stats_report_t * const report);
+uint16_t device_level_get_unhandled_count(QSignal sig);
+uint32_t device_level_get_mismatch_count(void);
+uint32_t device_level_get_lockup_ms(void);
+uint32_t device_level_get_retry_decisions(ao_retry_action_t action);
+uint32_t device_level_get_warm_restart_count(uint32_t * const config_replays);
+bool device_level_get_startup_step_us(device_level_startup_step_t step, uint32_t * const since_enable_us);
+#ifdef DEVICE_LEVEL_ID_PROBE
+uint32_t device_level_get_id_polls(uint32_t * const mismatches);
+#endif
+#ifdef DEVICE_LEVEL_AUTO_POWER
+uint32_t device_level_get_auto_power_count(uint32_t * const lazy_enables);
+#endif
+#ifdef DEVICE_LEVEL_SUSPEND
+uint32_t device_level_get_resume_us(uint32_t * const suspends);
+#endif
+#ifdef DEVICE_LEVEL_SCHEDULE
+void device_level_get_schedule_report(ao_schedule_report_t * const report);
+uint32_t device_level_get_sample_count(uint32_t * const errors);
+bool device_level_get_jitter(uint8_t batch, ao_jitter_report_t * const report);
+#endif
+#if defined(DEVICE_LEVEL_FAST_PATH) && !defined(DEVICE_LEVEL_COMPONENT)
+void device_level_set_fast_path(bool enable);
+uint32_t device_level_get_fast_path_hits(void);
+#endif
 
 #endif
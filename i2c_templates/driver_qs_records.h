@@ -0,0 +1,81 @@
+/**
+ * @file        driver_qs_records.h
+ * @brief       Application specific QS (QSpy) user records emitted by the drivers
+ * @details     Every driver template shares this single list so that record IDs
+ *              never collide when several drivers are traced in the same capture.
+ *              New records must be appended to the end of the list; QSpy
+ *              captures and host tools rely on the numeric values.
+ *              tools/qspy_txn_timeline.py reads the list from this file.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef DRIVER_QS_RECORDS_H
+#define DRIVER_QS_RECORDS_H
+
+#include "qpc.h"
+
+// QS user record IDs
+enum
+{
+    DRIVER_QS_DUTY_CYCLE = QS_USER,         /**< Duty cycle summary >*/
+    DRIVER_QS_DUTY_CYCLE_HIST,              /**< Busy period histogram >*/
+    DRIVER_QS_RTC_PROFILE,                  /**< RTC step statistics per (state, signal) >*/
+    DRIVER_QS_RTC_PROFILE_HIST,             /**< RTC step cost histogram per (state, signal) >*/
+    DRIVER_QS_RTC_OVERRUN,                  /**< RTC step exceeded its budget >*/
+    DRIVER_QS_STATE_STATS,                  /**< Dwell time and entry count per state >*/
+
+    // Transaction lifecycle. Every record carries: transaction number (U32),
+    // I2C transaction ID (U32), operation (U8), register (U16), length (U16)
+    // and the AO clock timestamp (U32).
+    DRIVER_QS_TXN_ACCEPTED,                 /**< Request accepted from the requestor >*/
+    DRIVER_QS_TXN_QUEUED,                   /**< Request queued for dispatch to the bus >*/
+    DRIVER_QS_TXN_DISPATCHED,               /**< I2C request posted to the bus AO >*/
+    DRIVER_QS_TXN_COMPLETED,                /**< Bus AO reported completion >*/
+    DRIVER_QS_TXN_FAILED,                   /**< Bus AO reported an error >*/
+    DRIVER_QS_TXN_RETRIED,                  /**< Attempt is being retried >*/
+    DRIVER_QS_TXN_TIMED_OUT,                /**< No response within the lockup time >*/
+    DRIVER_QS_TXN_RESPONDED,                /**< Response posted back to the requestor >*/
+
+    DRIVER_QS_STARTUP_STEP,                 /**< Bring-up step timestamp, see ao_startup_trace.h >*/
+    DRIVER_QS_SCHEDULE,                     /**< Release jitter of the static schedule, see ao_schedule.h >*/
+    DRIVER_QS_JITTER,                       /**< Deviation statistics of one stream, see ao_jitter.h >*/
+    DRIVER_QS_JITTER_HIST,                  /**< Absolute deviation histogram of one stream >*/
+    DRIVER_QS_UNHANDLED,                    /**< Unhandled event count of one signal >*/
+    DRIVER_QS_UNHANDLED_TOTAL,              /**< Unhandled event count since reset >*/
+};
+
+/**
+    @brief Register the user record dictionaries with QSpy.
+    Called from the initial state of every driver; repeated registration is
+    harmless.
+*/
+#define DRIVER_QS_USR_DICTIONARIES()                    \
+    do {                                                \
+        QS_USR_DICTIONARY(DRIVER_QS_DUTY_CYCLE);        \
+        QS_USR_DICTIONARY(DRIVER_QS_DUTY_CYCLE_HIST);   \
+        QS_USR_DICTIONARY(DRIVER_QS_RTC_PROFILE);       \
+        QS_USR_DICTIONARY(DRIVER_QS_RTC_PROFILE_HIST);  \
+        QS_USR_DICTIONARY(DRIVER_QS_RTC_OVERRUN);       \
+        QS_USR_DICTIONARY(DRIVER_QS_STATE_STATS);       \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_ACCEPTED);      \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_QUEUED);        \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_DISPATCHED);    \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_COMPLETED);     \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_FAILED);        \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_RETRIED);       \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_TIMED_OUT);     \
+        QS_USR_DICTIONARY(DRIVER_QS_TXN_RESPONDED);     \
+        QS_USR_DICTIONARY(DRIVER_QS_STARTUP_STEP);      \
+        QS_USR_DICTIONARY(DRIVER_QS_SCHEDULE);          \
+        QS_USR_DICTIONARY(DRIVER_QS_JITTER);            \
+        QS_USR_DICTIONARY(DRIVER_QS_JITTER_HIST);       \
+        QS_USR_DICTIONARY(DRIVER_QS_UNHANDLED);         \
+        QS_USR_DICTIONARY(DRIVER_QS_UNHANDLED_TOTAL);   \
+    } while (0)
+
+#endif
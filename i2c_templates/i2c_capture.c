@@ -0,0 +1,183 @@
+/**
+ * @file        i2c_capture.c
+ * @brief       Compact binary capture of the traffic between a driver and i2c_comm_ao
+ * @details     Records are written from the capturing AO only, so the buffer needs
+ *              no locking. If no sink is installed, records are dropped once the
+ *              buffer is full and counted.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ao_clock.h"
+#include "i2c_capture.h"
+
+/*! @struct i2c_capture_t
+*   @brief  Capture buffer state
+*/
+typedef struct
+{
+    i2c_capture_sink_t      sink;                               /**< Where full buffers go >*/
+    bool                    header_sent;                        /**< File header already written >*/
+    uint32_t                n_records;                          /**< Records in the buffer >*/
+    uint32_t                dropped;                            /**< Records lost, buffer full >*/
+    uint8_t                 buffer[I2C_CAPTURE_BUFFER_RECORDS * I2C_CAPTURE_RECORD_SIZE];
+} i2c_capture_t;
+
+static i2c_capture_t l_i2c_capture;
+
+// Private functions
+static void i2c_capture_put_u16(uint8_t * const out, uint16_t value);
+
+static void i2c_capture_put_u32(uint8_t * const out, uint32_t value);
+
+static uint16_t i2c_capture_get_u16(uint8_t const * const in);
+
+static uint32_t i2c_capture_get_u32(uint8_t const * const in);
+
+/**
+*   @brief      Reset the capture buffer
+*   @param[in]  sink        - receives the encoded capture, may be NULL
+*   @param[out] nothing
+*   @return     nothing
+*/
+void i2c_capture_init(i2c_capture_sink_t sink)
+{
+    memset(&l_i2c_capture, 0, sizeof(l_i2c_capture));
+    l_i2c_capture.sink = sink;
+}
+
+/**
+*   @brief      Append one record, flushing first if the buffer is full
+*/
+void i2c_capture_record(i2c_capture_record_t const * const record)
+{
+    if (l_i2c_capture.n_records >= I2C_CAPTURE_BUFFER_RECORDS)
+    {
+        i2c_capture_flush();
+    }
+
+    if (l_i2c_capture.n_records >= I2C_CAPTURE_BUFFER_RECORDS)
+    {
+        l_i2c_capture.dropped++;
+        return;
+    }
+
+    i2c_capture_encode(record, &l_i2c_capture.buffer[l_i2c_capture.n_records * I2C_CAPTURE_RECORD_SIZE]);
+    l_i2c_capture.n_records++;
+}
+
+/**
+*   @brief      Hand the buffered records to the sink
+*   @details    The file header is sent ahead of the first records.
+*/
+void i2c_capture_flush(void)
+{
+    if (l_i2c_capture.sink == NULL)
+    {
+        return;
+    }
+
+    if (!l_i2c_capture.header_sent)
+    {
+        uint8_t header[I2C_CAPTURE_HEADER_SIZE] = {0};
+
+        i2c_capture_put_u32(&header[0], I2C_CAPTURE_MAGIC);
+        header[4] = I2C_CAPTURE_VERSION;
+        header[5] = I2C_CAPTURE_RECORD_SIZE;
+        i2c_capture_put_u32(&header[8], AO_CLOCK_COUNTS_PER_MS);
+
+        l_i2c_capture.sink(header, sizeof(header));
+        l_i2c_capture.header_sent = true;
+    }
+
+    if (l_i2c_capture.n_records > 0u)
+    {
+        l_i2c_capture.sink(l_i2c_capture.buffer, l_i2c_capture.n_records * I2C_CAPTURE_RECORD_SIZE);
+        l_i2c_capture.n_records = 0u;
+    }
+}
+
+/**
+*   @brief      Number of records lost because the buffer was full
+*/
+uint32_t i2c_capture_get_dropped(void)
+{
+    return l_i2c_capture.dropped;
+}
+
+/**
+*   @brief      Encode a record into I2C_CAPTURE_RECORD_SIZE bytes
+*/
+void i2c_capture_encode(i2c_capture_record_t const * const record, uint8_t * const out)
+{
+    i2c_capture_put_u32(&out[0], record->timestamp);
+    out[4] = (uint8_t)((record->type << 4) | (record->operation & 0x0Fu));
+    out[5] = (uint8_t)record->error;
+    i2c_capture_put_u16(&out[6], record->reg);
+    i2c_capture_put_u16(&out[8], record->length);
+    i2c_capture_put_u16(&out[10], record->seq);
+}
+
+/**
+*   @brief      Decode a record from I2C_CAPTURE_RECORD_SIZE bytes
+*/
+void i2c_capture_decode(uint8_t const * const in, i2c_capture_record_t * const record)
+{
+    record->timestamp = i2c_capture_get_u32(&in[0]);
+    record->type      = (uint8_t)(in[4] >> 4);
+    record->operation = (uint8_t)(in[4] & 0x0Fu);
+    record->error     = (int8_t)in[5];
+    record->reg       = i2c_capture_get_u16(&in[6]);
+    record->length    = i2c_capture_get_u16(&in[8]);
+    record->seq       = i2c_capture_get_u16(&in[10]);
+}
+
+/**
+*   @brief      Check a file header
+*   @param[in]  in              - I2C_CAPTURE_HEADER_SIZE bytes
+*   @param[out] counts_per_ms   - timestamp resolution of the capture
+*   @return     bool            - false if this is not a supported capture
+*/
+bool i2c_capture_decode_header(uint8_t const * const in, uint32_t * const counts_per_ms)
+{
+    if ((i2c_capture_get_u32(&in[0]) != I2C_CAPTURE_MAGIC) ||
+        (in[4] != I2C_CAPTURE_VERSION) ||
+        (in[5] != I2C_CAPTURE_RECORD_SIZE))
+    {
+        return false;
+    }
+
+    *counts_per_ms = i2c_capture_get_u32(&in[8]);
+
+    return (*counts_per_ms != 0u);
+}
+
+static void i2c_capture_put_u16(uint8_t * const out, uint16_t value)
+{
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void i2c_capture_put_u32(uint8_t * const out, uint32_t value)
+{
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static uint16_t i2c_capture_get_u16(uint8_t const * const in)
+{
+    return (uint16_t)(in[0] | ((uint16_t)in[1] << 8));
+}
+
+static uint32_t i2c_capture_get_u32(uint8_t const * const in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file        i2c_capture.h
+ * @brief       Compact binary capture of the traffic between a driver and i2c_comm_ao
+ * @details     Enabled in device_level by building with DEVICE_LEVEL_I2C_CAPTURE.
+ *              Records are appended to a RAM buffer and handed to a sink (flash
+ *              log, UART, ...) whenever the buffer fills up or on
+ *              i2c_capture_flush(). The host simulator replays the resulting
+ *              file (see sim/sim_replay.h).
+ *
+ *              File layout, all fields little-endian:
+ *
+ *              Header (12 bytes)
+ *                  u32 magic           I2C_CAPTURE_MAGIC
+ *                  u8  version         I2C_CAPTURE_VERSION
+ *                  u8  record_size     I2C_CAPTURE_RECORD_SIZE
+ *                  u16 reserved
+ *                  u32 counts_per_ms   AO_CLOCK_COUNTS_PER_MS of the capturing build
+ *
+ *              Record (12 bytes)
+ *                  u32 timestamp       AO clock counts
+ *                  u8  type:4 | op:4   i2c_capture_type_t in the upper nibble,
+ *                                      i2c_ops_t in the lower nibble
+ *                  i8  error           HAL error code, ERROR records only
+ *                  u16 reg             register address
+ *                  u16 length          data length
+ *                  u16 seq             driver transaction number, truncated
+ *
+ *              Retries show up as repeated REQUEST records with the same seq.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef I2C_CAPTURE_H
+#define I2C_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_CAPTURE_MAGIC               0x43433249u     // "I2CC"
+#define I2C_CAPTURE_VERSION             1u
+#define I2C_CAPTURE_HEADER_SIZE         12u
+#define I2C_CAPTURE_RECORD_SIZE         12u
+
+// RAM buffer size, in records
+#ifndef I2C_CAPTURE_BUFFER_RECORDS
+#define I2C_CAPTURE_BUFFER_RECORDS      64u
+#endif
+
+// Record types
+typedef enum
+{
+    I2C_CAPTURE_REQUEST     = 1,    /**< Request posted to i2c_comm_ao >*/
+    I2C_CAPTURE_COMPLETE    = 2,    /**< Completion received from i2c_comm_ao >*/
+    I2C_CAPTURE_ERROR       = 3,    /**< Error received from i2c_comm_ao >*/
+    I2C_CAPTURE_TIMEOUT     = 4,    /**< No answer within the lockup time >*/
+} i2c_capture_type_t;
+
+/*! @struct i2c_capture_record_t
+*   @brief  Decoded capture record
+*/
+typedef struct
+{
+    uint32_t                timestamp;                          /**< AO clock counts >*/
+    uint8_t                 type;                               /**< i2c_capture_type_t >*/
+    uint8_t                 operation;                          /**< i2c_ops_t >*/
+    int8_t                  error;                              /**< HAL error code >*/
+    uint16_t                reg;                                /**< Register address >*/
+    uint16_t                length;                             /**< Data length >*/
+    uint16_t                seq;                                /**< Driver transaction number >*/
+} i2c_capture_record_t;
+
+/**
+    @brief Capture sink.
+    Receives encoded bytes: the file header first, then whole records.
+*/
+typedef void (*i2c_capture_sink_t)(uint8_t const * data, uint32_t len);
+
+void i2c_capture_init(i2c_capture_sink_t sink);
+
+void i2c_capture_record(i2c_capture_record_t const * const record);
+
+void i2c_capture_flush(void);
+
+uint32_t i2c_capture_get_dropped(void);
+
+void i2c_capture_encode(i2c_capture_record_t const * const record, uint8_t * const out);
+
+void i2c_capture_decode(uint8_t const * const in, i2c_capture_record_t * const record);
+
+bool i2c_capture_decode_header(uint8_t const * const in, uint32_t * const counts_per_ms);
+
+#endif
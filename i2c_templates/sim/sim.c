@@ -0,0 +1,444 @@
+/**
+ * @file        sim.c
+ * @brief       Deterministic virtual-time simulation harness for the driver templates
+ * @details     The run loop alternates between two phases:
+ *
+ *              1. Dispatch: run every ready AO to completion, highest priority
+ *                 first, exactly as the QV kernel would. No virtual time passes.
+ *              2. Advance: move the clock to the earlier of the next QF tick and
+ *                 the next scheduled callback, and fire it.
+ *
+ *              Callbacks due at the same time fire in insertion order, which
+ *              keeps runs reproducible.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "qpc.h"
+#include "timer.h"
+#include "sim.h"
+
+Q_DEFINE_THIS_FILE
+
+#define SIM_TICK_PERIOD_US              (SIM_US_PER_SEC / SIM_TICKS_PER_SEC)
+
+/*! @struct sim_event_t
+*   @brief  Pending scheduler callback
+*/
+typedef struct
+{
+    sim_time_t              time;                               /**< Virtual time to fire at >*/
+    uint64_t                seq;                                /**< Insertion order, breaks ties >*/
+    sim_callback_t          callback;                           /**< Function to call >*/
+    void *                  arg;                                /**< Callback argument >*/
+} sim_event_t;
+
+/*! @struct sim_t
+*   @brief  Harness state
+*/
+typedef struct
+{
+    sim_time_t              now;                                /**< Current virtual time >*/
+    sim_time_t              next_tick;                          /**< Virtual time of the next QF tick >*/
+    uint64_t                next_seq;                           /**< Next insertion number >*/
+    uint64_t                rng;                                /**< PRNG state >*/
+    uint32_t                n_events;                           /**< Entries in the heap >*/
+    sim_event_t             heap[SIM_MAX_EVENTS];               /**< Min-heap ordered by (time, seq) >*/
+    sim_stats_t             stats;                              /**< Harness counters >*/
+} sim_t;
+
+static sim_t l_sim;
+
+// Sender of the QF ticks, for QS
+static uint8_t const l_sim_tick_sender = 0u;
+
+// Private functions
+static bool sim_event_before(sim_event_t const * const a, sim_event_t const * const b);
+
+static void sim_heap_pop(sim_event_t * const out);
+
+static bool sim_dispatch_one(void);
+
+static void sim_dispatch_all(void);
+
+static bool sim_step(sim_time_t limit);
+
+static int sim_latency_compare(void const * a, void const * b);
+
+/**
+*   @brief      Reset virtual time, the scheduler and the random generator
+*   @details    Call before QF_init() and before any AO is started.
+*   @param[in]  seed        - random seed, runs with the same seed are identical
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_init(uint64_t seed)
+{
+    memset(&l_sim, 0, sizeof(l_sim));
+
+    // xorshift must not start from zero
+    l_sim.rng       = (seed != 0u) ? seed : 0x9E3779B97F4A7C15u;
+    l_sim.next_tick = SIM_TICK_PERIOD_US;
+}
+
+/**
+*   @brief      Current virtual time in microseconds
+*/
+sim_time_t sim_now(void)
+{
+    return l_sim.now;
+}
+
+/**
+*   @brief      Virtual clock as seen by AO_CLOCK_NOW(), in microseconds
+*/
+timer_count_t timer_get_count(void)
+{
+    return (timer_count_t)l_sim.now;
+}
+
+/**
+*   @brief      Schedule a callback at an absolute virtual time
+*   @param[in]  time        - virtual time to fire at, clamped to now
+*   @param[in]  callback    - function to call
+*   @param[in]  arg         - callback argument
+*   @param[out] nothing
+*   @return     bool        - false if the scheduler is full
+*/
+bool sim_schedule_at(sim_time_t time, sim_callback_t callback, void * arg)
+{
+    if (l_sim.n_events >= SIM_MAX_EVENTS)
+    {
+        return false;
+    }
+
+    sim_event_t evt =
+    {
+        .time     = (time < l_sim.now) ? l_sim.now : time,
+        .seq      = l_sim.next_seq++,
+        .callback = callback,
+        .arg      = arg,
+    };
+
+    // Sift up
+    uint32_t i = l_sim.n_events++;
+    while (i > 0u)
+    {
+        uint32_t parent = (i - 1u) / 2u;
+
+        if (!sim_event_before(&evt, &l_sim.heap[parent]))
+        {
+            break;
+        }
+
+        l_sim.heap[i] = l_sim.heap[parent];
+        i = parent;
+    }
+    l_sim.heap[i] = evt;
+
+    return true;
+}
+
+/**
+*   @brief      Schedule a callback relative to the current virtual time
+*/
+bool sim_schedule_in(sim_time_t delay, sim_callback_t callback, void * arg)
+{
+    return sim_schedule_at(l_sim.now + delay, callback, arg);
+}
+
+/**
+*   @brief      Run the simulation for a span of virtual time
+*   @param[in]  duration    - virtual time to run for, in microseconds
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_run_for(sim_time_t duration)
+{
+    sim_time_t const limit = l_sim.now + duration;
+
+    while (sim_step(limit))
+    {
+    }
+
+    l_sim.now = limit;
+}
+
+/**
+*   @brief      Run until nothing is left to do
+*   @details    Stops once every AO queue is empty, no callback is scheduled and
+*               no QTimeEvt is armed, or when the limit is reached.
+*   @param[in]  limit       - maximum virtual time to run for, in microseconds
+*   @param[out] nothing
+*   @return     bool        - true if the system went idle before the limit
+*/
+bool sim_run_until_idle(sim_time_t limit)
+{
+    sim_time_t const end = l_sim.now + limit;
+
+    for (;;)
+    {
+        sim_dispatch_all();
+
+        if ((l_sim.n_events == 0u) && QF_noTimeEvtsActiveX(0U))
+        {
+            return true;
+        }
+
+        if (!sim_step(end))
+        {
+            l_sim.now = end;
+            return false;
+        }
+    }
+}
+
+/**
+*   @brief      Next number from the seeded generator (xorshift64*)
+*/
+uint32_t sim_rand(void)
+{
+    l_sim.rng ^= l_sim.rng >> 12;
+    l_sim.rng ^= l_sim.rng << 25;
+    l_sim.rng ^= l_sim.rng >> 27;
+
+    return (uint32_t)((l_sim.rng * 0x2545F4914F6CDD1Du) >> 32);
+}
+
+/**
+*   @brief      Uniform random number in [lo, hi]
+*/
+uint32_t sim_rand_range(uint32_t lo, uint32_t hi)
+{
+    if (hi <= lo)
+    {
+        return lo;
+    }
+
+    return lo + (uint32_t)(((uint64_t)sim_rand() * ((uint64_t)(hi - lo) + 1u)) >> 32);
+}
+
+/**
+*   @brief      Returns true with the given probability, in parts per million
+*/
+bool sim_rand_chance(uint32_t per_million)
+{
+    return (per_million > 0u) && (sim_rand_range(0u, 999999u) < per_million);
+}
+
+/**
+*   @brief      Harness counters
+*/
+sim_stats_t const * sim_get_stats(void)
+{
+    return &l_sim.stats;
+}
+
+/**
+*   @brief      Sort the samples in place and summarize them
+*   @param[in]  samples     - latencies in microseconds, reordered
+*   @param[in]  n           - number of samples
+*   @param[out] out         - summary, all zero if there are no samples
+*   @return     nothing
+*/
+void sim_latency_summarize(sim_time_t * const samples, uint32_t n, sim_latency_t * const out)
+{
+    uint64_t total = 0u;
+
+    memset(out, 0, sizeof(*out));
+    out->n = n;
+
+    if (n == 0u)
+    {
+        return;
+    }
+
+    qsort(samples, n, sizeof(sim_time_t), &sim_latency_compare);
+
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        total += samples[i];
+    }
+
+    out->mean = total / n;
+    out->p50  = samples[((n - 1u) * 50u) / 100u];
+    out->p99  = samples[((n - 1u) * 99u) / 100u];
+    out->max  = samples[n - 1u];
+}
+
+static int sim_latency_compare(void const * a, void const * b)
+{
+    sim_time_t const x = *(sim_time_t const *)a;
+    sim_time_t const y = *(sim_time_t const *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+*   @brief      Heap ordering: earlier time first, then insertion order
+*/
+static bool sim_event_before(sim_event_t const * const a, sim_event_t const * const b)
+{
+    return (a->time < b->time) || ((a->time == b->time) && (a->seq < b->seq));
+}
+
+/**
+*   @brief      Remove the earliest event from the heap
+*/
+static void sim_heap_pop(sim_event_t * const out)
+{
+    *out = l_sim.heap[0];
+
+    sim_event_t const last = l_sim.heap[--l_sim.n_events];
+    uint32_t i = 0u;
+
+    // Sift down
+    for (;;)
+    {
+        uint32_t child = (2u * i) + 1u;
+
+        if (child >= l_sim.n_events)
+        {
+            break;
+        }
+        if (((child + 1u) < l_sim.n_events) && sim_event_before(&l_sim.heap[child + 1u], &l_sim.heap[child]))
+        {
+            child++;
+        }
+        if (!sim_event_before(&l_sim.heap[child], &last))
+        {
+            break;
+        }
+
+        l_sim.heap[i] = l_sim.heap[child];
+        i = child;
+    }
+    l_sim.heap[i] = last;
+}
+
+/**
+*   @brief      Dispatch one event to the highest priority ready AO
+*   @details    Mirrors one iteration of the QV scheduler loop.
+*   @return     bool        - false if no AO had an event
+*/
+static bool sim_dispatch_one(void)
+{
+    QF_CRIT_STAT_
+
+    QF_CRIT_E_();
+    if (QPSet_notEmpty(&QF_readySet_))
+    {
+        uint_fast8_t p;
+        QPSet_findMax(&QF_readySet_, p);
+        QActive * const a = QF_active_[p];
+        QF_CRIT_X_();
+
+        QEvt const * const e = QActive_get_(a);
+        QHSM_DISPATCH(&a->super, e, a->prio);
+        QF_gc(e);
+
+        l_sim.stats.dispatches++;
+        return true;
+    }
+    QF_CRIT_X_();
+
+    return false;
+}
+
+/**
+*   @brief      Run every ready AO to completion
+*/
+static void sim_dispatch_all(void)
+{
+    while (sim_dispatch_one())
+    {
+    }
+}
+
+/**
+*   @brief      Dispatch, then advance the clock to the next tick or callback
+*   @param[in]  limit       - do not advance past this time
+*   @return     bool        - false once nothing is left before the limit
+*/
+static bool sim_step(sim_time_t limit)
+{
+    sim_dispatch_all();
+
+    sim_time_t next_event = (l_sim.n_events > 0u) ? l_sim.heap[0].time : limit;
+
+    // Ticks have no effect while no timer is armed: jump straight to the first
+    // tick at or after the next thing that can happen
+    if (QF_noTimeEvtsActiveX(0U) && (l_sim.next_tick < next_event))
+    {
+        sim_time_t skipped = (next_event - l_sim.next_tick) / SIM_TICK_PERIOD_US;
+
+        l_sim.next_tick          += skipped * SIM_TICK_PERIOD_US;
+        l_sim.stats.ticks_skipped += skipped;
+    }
+
+    if ((l_sim.next_tick <= next_event) && (l_sim.next_tick <= limit))
+    {
+        l_sim.now        = l_sim.next_tick;
+        l_sim.next_tick += SIM_TICK_PERIOD_US;
+        l_sim.stats.ticks++;
+
+        QF_TICK_X(0U, &l_sim_tick_sender);
+        return true;
+    }
+
+    if ((l_sim.n_events > 0u) && (next_event <= limit))
+    {
+        sim_event_t evt;
+
+        sim_heap_pop(&evt);
+        l_sim.now = evt.time;
+        l_sim.stats.callbacks++;
+
+        evt.callback(evt.arg);
+        return true;
+    }
+
+    return false;
+}
+
+/************************************************************************************/
+/***    QF PORT CALLBACKS                                                         ***/
+/************************************************************************************/
+
+/**
+*   @brief      Nothing to start, ticks come from the virtual clock
+*/
+void QF_onStartup(void)
+{
+}
+
+/**
+*   @brief      Nothing to clean up
+*/
+void QF_onCleanup(void)
+{
+}
+
+/**
+*   @brief      Unused, ticks come from the virtual clock
+*/
+void QF_onClockTick(void)
+{
+}
+
+/**
+*   @brief      Report the failed assertion with the virtual time and stop
+*/
+Q_NORETURN Q_onAssert(char const * const module, int_t const location)
+{
+    fprintf(stderr, "ASSERT %s:%d at t=%llu us\n", module, (int)location, (unsigned long long)l_sim.now);
+    exit(-1);
+}
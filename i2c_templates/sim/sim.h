@@ -0,0 +1,105 @@
+/**
+ * @file        sim.h
+ * @brief       Deterministic virtual-time simulation harness for the driver templates
+ * @details     Host only. The harness replaces the real-time QP port loop with a
+ *              discrete-event scheduler:
+ *
+ *              - virtual time only advances when every AO queue is empty
+ *              - QF ticks are generated from the virtual clock and are skipped
+ *                entirely while no QTimeEvt is armed
+ *              - model callbacks (bus transfers, scripted traffic) are scheduled
+ *                at absolute virtual times and run in (time, insertion) order
+ *              - all randomness comes from one seeded generator
+ *
+ *              A run is therefore a pure function of its seed and scenario, and
+ *              runs as fast as the host can dispatch events.
+ *
+ *              Requirements on the host build:
+ *              - QP/C with the cooperative QV kernel (posix-qv port); QF_run()
+ *                must not be called, sim_run_for() drives the framework instead
+ *              - AO_CLOCK_COUNTS_PER_MS=1000, since timer_get_count() returns
+ *                virtual microseconds
+ *              - SIM_TICKS_PER_SEC matching the rate MS_TO_TICKS() assumes
+ *              - DEVICE_LEVEL_BUS_RECOVER=sim_i2c_bus_recover, the bus recovery
+ *                of the bus model
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qpc.h"
+
+// QF tick rate driven from the virtual clock
+#ifndef SIM_TICKS_PER_SEC
+#define SIM_TICKS_PER_SEC               1000u
+#endif
+
+// Maximum number of pending scheduler callbacks
+#ifndef SIM_MAX_EVENTS
+#define SIM_MAX_EVENTS                  256u
+#endif
+
+#define SIM_US_PER_MS                   1000u
+#define SIM_US_PER_SEC                  1000000u
+
+// Virtual time in microseconds
+typedef uint64_t sim_time_t;
+
+// Scheduler callback
+typedef void (*sim_callback_t)(void * arg);
+
+/*! @struct sim_stats_t
+*   @brief  Harness counters, useful to check a run did what was expected
+*/
+typedef struct
+{
+    uint64_t                dispatches;                         /**< Events dispatched to AOs >*/
+    uint64_t                ticks;                              /**< QF ticks generated >*/
+    uint64_t                ticks_skipped;                      /**< Ticks skipped with no armed timers >*/
+    uint64_t                callbacks;                          /**< Scheduler callbacks run >*/
+} sim_stats_t;
+
+/*! @struct sim_latency_t
+*   @brief  Latency summary, in microseconds
+*/
+typedef struct
+{
+    uint32_t                n;                                  /**< Samples >*/
+    uint64_t                mean;
+    uint64_t                p50;
+    uint64_t                p99;
+    uint64_t                max;
+} sim_latency_t;
+
+void sim_init(uint64_t seed);
+
+sim_time_t sim_now(void);
+
+bool sim_schedule_at(sim_time_t time, sim_callback_t callback, void * arg);
+
+bool sim_schedule_in(sim_time_t delay, sim_callback_t callback, void * arg);
+
+void sim_run_for(sim_time_t duration);
+
+bool sim_run_until_idle(sim_time_t limit);
+
+uint32_t sim_rand(void);
+
+uint32_t sim_rand_range(uint32_t lo, uint32_t hi);
+
+bool sim_rand_chance(uint32_t per_million);
+
+sim_stats_t const * sim_get_stats(void);
+
+void sim_latency_summarize(sim_time_t * const samples, uint32_t n, sim_latency_t * const out);
+
+#endif
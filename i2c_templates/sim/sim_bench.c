@@ -0,0 +1,769 @@
+/**
+ * @file        sim_bench.c
+ * @brief       Host benchmark suite for the driver templates
+ * @details     Runs a fixed set of scenarios against device_level on the simulated
+ *              bus, writes the results as JSON and compares them with the committed
+ *              baseline (sim/bench_baseline.txt):
+ *
+ *              read_latency    -   single register reads, back to back
+ *              burst_read      -   32 byte reads, back to back
+ *              burst_write     -   32 byte writes, back to back
+ *              mixed           -   random reads and writes of 1 to 16 bytes
+ *                                  arriving every 500us on average
+ *              error_storm     -   back to back, 5% of transfers lose arbitration
+ *              timeout_storm   -   back to back, 2% of transfers are never answered
+ *              fault_*         -   back to back, one fault profile each (NAK,
+ *                                  stuck-low, corrupted data, delayed and duplicated
+ *                                  completions), and one scripted sequence
+ *              startup         -   enable to DEVICE_LEVEL_READY_REPORT_SIG
+ *              dispatch_fast   -   single register reads, back to back, transfer
+ *                                  results on the fast path (DEVICE_LEVEL_FAST_PATH)
+ *              dispatch_switch -   the same with the fast path turned off, so
+ *                                  every step goes through the state handlers
+ *
+ *              Fault scenarios report recovery latency: first failure to the next
+ *              answered request. Every fault scenario gates its throughput and
+ *              its worst recovery, and --update-baseline refuses to record a
+ *              fault scenario that injected no faults.
+ *
+ *              Virtual time results are exact for a given seed, so the baseline
+ *              tolerances only need to absorb intended small changes. A gated
+ *              metric whose baseline is "-" has not been recorded yet: it is
+ *              listed as NOT RECORDED and only fails the gate with
+ *              --require-baseline, since the baseline only holds values measured
+ *              by --update-baseline. A scenario that does not run or does not
+ *              report a gated metric always fails. Host CPU time
+ *              (wall_ns_per_txn) is reported but never gated; compare it between
+ *              dispatch_fast and dispatch_switch to see what the fast path saves.
+ *
+ *              Each scenario runs in a child process, since QF cannot be restarted.
+ *
+ *              Usage: sim_bench [--scenario NAME] [--seed N] [--json FILE]
+ *                               [--baseline FILE] [--update-baseline]
+ *                               [--require-baseline] [--list]
+ *
+ *              Exit status: 0 when no gated metric regressed, 1 on a regression,
+ *              a missing metric or, with --require-baseline, an unrecorded gated
+ *              metric, 2 on a usage or I/O error.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "sim_i2c_faults.h"
+#include "sim_i2c_bus.h"
+#include "sim_load.h"
+#include "sim_system.h"
+
+#include "device_level.h"
+
+#define SIM_BENCH_DEFAULT_SEED          1u
+#define SIM_BENCH_DEFAULT_BASELINE      "sim/bench_baseline.txt"
+
+// Virtual time a scenario may take before it is declared stuck
+#define SIM_BENCH_RUN_LIMIT_US          (600u * SIM_US_PER_SEC)
+#define SIM_BENCH_RUN_SLICE_US          (10u * SIM_US_PER_MS)
+
+#define SIM_BENCH_MAX_METRICS           24u
+#define SIM_BENCH_MAX_BASELINE          64u
+#define SIM_BENCH_NAME_SIZE             64u
+
+/*! @struct sim_bench_fault_t
+*   @brief  A scripted fault
+*/
+typedef struct
+{
+    sim_time_t              at;                                 /**< Virtual time, us >*/
+    sim_i2c_fault_t         fault;
+} sim_bench_fault_t;
+
+/*! @struct sim_bench_scenario_t
+*   @brief  One benchmark scenario
+*/
+typedef struct
+{
+    char const *            name;
+    sim_load_config_t       load;                               /**< Workload >*/
+    sim_i2c_bus_config_t    bus;                                /**< Bus model and random faults >*/
+    sim_bench_fault_t const * script;                           /**< Scripted faults, may be NULL >*/
+    uint32_t                n_script;
+    bool                    state_handlers;                     /**< Turn the device_level fast path off >*/
+} sim_bench_scenario_t;
+
+/*! @struct sim_bench_metric_t
+*   @brief  One measured value
+*/
+typedef struct
+{
+    char                    name[SIM_BENCH_NAME_SIZE];
+    double                  value;
+} sim_bench_metric_t;
+
+/*! @struct sim_bench_result_t
+*   @brief  Metrics of one scenario
+*/
+typedef struct
+{
+    bool                    ok;                                 /**< The child ran to the end >*/
+    uint32_t                n_metrics;
+    sim_bench_metric_t      metrics[SIM_BENCH_MAX_METRICS];
+} sim_bench_result_t;
+
+/*! @struct sim_bench_baseline_t
+*   @brief  One gated metric: regression once the result is worse than
+*           value by more than tolerance_pct. A value of "-" marks a metric
+*           to record with the next --update-baseline; until then it fails.
+*/
+typedef struct
+{
+    char                    key[SIM_BENCH_NAME_SIZE];           /**< scenario.metric >*/
+    double                  value;
+    double                  tolerance_pct;
+    bool                    higher_is_better;
+    bool                    pending;                            /**< Listed with value "-", not recorded yet >*/
+} sim_bench_baseline_t;
+
+// 400kHz bus with one kind of random fault, SIM_I2C_FAULT_NONE for a clean bus
+#define SIM_BENCH_BUS(fault_, per_million_) { .bus_hz = 400000u, .overhead_us = 50u, .jitter_us = 0u, \
+                                              .faults = { .per_million = { [(fault_)] = (per_million_) } } }
+
+// Faults across the run of the fault_script scenario
+static sim_bench_fault_t const l_sim_bench_script[] =
+{
+    { .at = 100u * SIM_US_PER_MS,   .fault = SIM_I2C_FAULT_STUCK_LOW },
+    { .at = 200u * SIM_US_PER_MS,   .fault = SIM_I2C_FAULT_ARBITRATION },
+    { .at = 300u * SIM_US_PER_MS,   .fault = SIM_I2C_FAULT_TIMEOUT },
+    { .at = 400u * SIM_US_PER_MS,   .fault = SIM_I2C_FAULT_NAK },
+    { .at = 400u * SIM_US_PER_MS,   .fault = SIM_I2C_FAULT_NAK },
+};
+
+// Common workload of the fault scenarios
+#define SIM_BENCH_FAULT_LOAD            { .n_requests = 1000u, .read_percent = 50u, .min_length = 1u, .max_length = 4u, \
+                                          .n_registers = 252u, .interval_us = 0u, .watchdog_ms = 200u }
+
+static sim_bench_scenario_t const l_sim_bench_scenarios[] =
+{
+    {
+        .name = "read_latency",
+        .load = { .n_requests = 1000u, .read_percent = 100u, .min_length = 1u, .max_length = 1u,
+                  .n_registers = 256u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+    },
+    {
+        .name = "burst_read",
+        .load = { .n_requests = 1000u, .read_percent = 100u, .min_length = 32u, .max_length = 32u,
+                  .n_registers = 224u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+    },
+    {
+        .name = "burst_write",
+        .load = { .n_requests = 1000u, .read_percent = 0u, .min_length = 32u, .max_length = 32u,
+                  .n_registers = 224u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+    },
+    {
+        .name = "mixed",
+        .load = { .n_requests = 5000u, .read_percent = 70u, .min_length = 1u, .max_length = 16u,
+                  .n_registers = 240u, .interval_us = 500u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+    },
+    {
+        .name = "error_storm",
+        .load = { .n_requests = 2000u, .read_percent = 50u, .min_length = 1u, .max_length = 4u,
+                  .n_registers = 252u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_ARBITRATION, 50000u),
+    },
+    {
+        .name = "timeout_storm",
+        .load = { .n_requests = 500u, .read_percent = 50u, .min_length = 1u, .max_length = 4u,
+                  .n_registers = 252u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_TIMEOUT, 20000u),
+    },
+    {
+        .name = "fault_nak",
+        .load = SIM_BENCH_FAULT_LOAD,
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NAK, 20000u),
+    },
+    {
+        .name = "fault_stuck_low",
+        .load = SIM_BENCH_FAULT_LOAD,
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_STUCK_LOW, 5000u),
+    },
+    {
+        .name = "fault_corrupt",
+        .load = SIM_BENCH_FAULT_LOAD,
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_CORRUPT, 20000u),
+    },
+    {
+        .name = "fault_delayed",
+        .load = SIM_BENCH_FAULT_LOAD,
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_DELAYED, 20000u),
+    },
+    {
+        .name = "fault_duplicate",
+        .load = SIM_BENCH_FAULT_LOAD,
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_DUPLICATE, 20000u),
+    },
+    {
+        .name = "fault_script",
+        .load = SIM_BENCH_FAULT_LOAD,
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+        .script   = l_sim_bench_script,
+        .n_script = sizeof(l_sim_bench_script) / sizeof(l_sim_bench_script[0]),
+    },
+    {
+        .name = "dispatch_fast",
+        .load = { .n_requests = 5000u, .read_percent = 100u, .min_length = 1u, .max_length = 1u,
+                  .n_registers = 256u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+    },
+    {
+        .name = "dispatch_switch",
+        .load = { .n_requests = 5000u, .read_percent = 100u, .min_length = 1u, .max_length = 1u,
+                  .n_registers = 256u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+        .state_handlers = true,
+    },
+    {
+        .name = "startup",
+        .load = { .n_requests = 1u, .read_percent = 100u, .min_length = 1u, .max_length = 1u,
+                  .n_registers = 1u, .interval_us = 0u, .watchdog_ms = 200u },
+        .bus  = SIM_BENCH_BUS(SIM_I2C_FAULT_NONE, 0u),
+    },
+};
+
+#define SIM_BENCH_N_SCENARIOS           (sizeof(l_sim_bench_scenarios) / sizeof(l_sim_bench_scenarios[0]))
+
+static sim_bench_result_t l_sim_bench_results[SIM_BENCH_N_SCENARIOS];
+
+static sim_bench_baseline_t l_sim_bench_baseline[SIM_BENCH_MAX_BASELINE];
+static uint32_t l_sim_bench_n_baseline;
+
+// Private functions
+static void sim_bench_run_child(sim_bench_scenario_t const * const scenario, uint64_t seed, FILE * const out);
+
+static bool sim_bench_run(sim_bench_scenario_t const * const scenario, uint64_t seed,
+                          sim_bench_result_t * const result);
+
+static bool sim_bench_find(char const * const key, double * const value);
+
+static bool sim_bench_load_baseline(char const * const path);
+
+static bool sim_bench_save_baseline(char const * const path);
+
+static bool sim_bench_write_json(char const * const path, uint64_t seed, bool const * const selected);
+
+static uint32_t sim_bench_compare(bool const * const selected, uint32_t * const unrecorded);
+
+static bool sim_bench_faults_injected(void);
+
+static uint64_t sim_bench_wall_ns(void);
+
+/**
+*   @brief      Run one scenario and print its metrics as "name value" lines
+*/
+static void sim_bench_run_child(sim_bench_scenario_t const * const scenario, uint64_t seed, FILE * const out)
+{
+    sim_load_report_t report;
+
+    sim_system_start(seed, &scenario->bus);
+
+#if defined(DEVICE_LEVEL_FAST_PATH) && !defined(DEVICE_LEVEL_COMPONENT)
+    device_level_set_fast_path(!scenario->state_handlers);
+#endif
+
+    for (uint32_t i = 0u; i < scenario->n_script; i++)
+    {
+        (void)sim_i2c_bus_script_fault(scenario->script[i].at, scenario->script[i].fault);
+    }
+
+    sim_load_start(SIM_CLIENT_PRIORITY, &scenario->load);
+
+    uint64_t const wall_start = sim_bench_wall_ns();
+
+    while (!sim_load_is_done() && (sim_now() < SIM_BENCH_RUN_LIMIT_US))
+    {
+        sim_run_for(SIM_BENCH_RUN_SLICE_US);
+    }
+
+    uint64_t const wall_ns = sim_bench_wall_ns() - wall_start;
+
+    sim_load_get_report(&report);
+
+    uint32_t const answered = (report.completed > 0u) ? report.completed : 1u;
+    uint32_t faults         = 0u;
+
+    for (uint32_t f = SIM_I2C_FAULT_NONE + 1u; f < SIM_I2C_FAULT_COUNT; f++)
+    {
+        faults += sim_i2c_faults_get_injected((sim_i2c_fault_t)f);
+    }
+    double const elapsed_s  = (double)report.elapsed_us / SIM_US_PER_SEC;
+
+    fprintf(out, "completed %u\n", report.completed);
+    fprintf(out, "failed %u\n", report.failed);
+    fprintf(out, "lost %u\n", report.lost);
+    fprintf(out, "recoveries %u\n", report.recoveries);
+    fprintf(out, "lat_mean_us %llu\n", (unsigned long long)report.latency.mean);
+    fprintf(out, "lat_p50_us %llu\n", (unsigned long long)report.latency.p50);
+    fprintf(out, "lat_p99_us %llu\n", (unsigned long long)report.latency.p99);
+    fprintf(out, "lat_max_us %llu\n", (unsigned long long)report.latency.max);
+    fprintf(out, "txn_per_s %.2f\n", (elapsed_s > 0.0) ? (report.completed / elapsed_s) : 0.0);
+    fprintf(out, "bytes_per_s %.2f\n", (elapsed_s > 0.0) ? (report.bytes / elapsed_s) : 0.0);
+    fprintf(out, "dispatches_per_txn %.2f\n", (double)report.dispatches / answered);
+    fprintf(out, "recovery_p50_us %llu\n", (unsigned long long)report.recovery.p50);
+    fprintf(out, "recovery_max_us %llu\n", (unsigned long long)report.recovery.max);
+    fprintf(out, "faults_injected %u\n", faults);
+    fprintf(out, "startup_us %llu\n", (unsigned long long)report.startup_us);
+    fprintf(out, "startup_dispatches %llu\n", (unsigned long long)report.startup_dispatches);
+    fprintf(out, "wall_ns_per_txn %llu\n", (unsigned long long)(wall_ns / answered));
+#if defined(DEVICE_LEVEL_FAST_PATH) && !defined(DEVICE_LEVEL_COMPONENT)
+    fprintf(out, "fast_path_hits %u\n", device_level_get_fast_path_hits());
+#else
+    fprintf(out, "fast_path_hits 0\n");
+#endif
+    fprintf(out, "done %d\n", sim_load_is_done() ? 1 : 0);
+}
+
+/**
+*   @brief      Run a scenario in a child process and collect its metrics
+*   @return     bool        - false if the child failed or did not finish
+*/
+static bool sim_bench_run(sim_bench_scenario_t const * const scenario, uint64_t seed,
+                          sim_bench_result_t * const result)
+{
+    int fds[2];
+    int status = 0;
+    char line[128];
+
+    memset(result, 0, sizeof(*result));
+
+    if (pipe(fds) != 0)
+    {
+        return false;
+    }
+
+    fflush(NULL);
+    pid_t const pid = fork();
+
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        FILE * const out = fdopen(fds[1], "w");
+
+        close(fds[0]);
+        sim_bench_run_child(scenario, seed, out);
+        fclose(out);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    FILE * const in = fdopen(fds[0], "r");
+    double done = 0.0;
+
+    while ((in != NULL) && (fgets(line, sizeof(line), in) != NULL))
+    {
+        sim_bench_metric_t metric;
+
+        if (sscanf(line, "%63s %lf", metric.name, &metric.value) != 2)
+        {
+            continue;
+        }
+
+        if (strcmp(metric.name, "done") == 0)
+        {
+            done = metric.value;
+        }
+        else if (result->n_metrics < SIM_BENCH_MAX_METRICS)
+        {
+            result->metrics[result->n_metrics++] = metric;
+        }
+    }
+
+    if (in != NULL)
+    {
+        fclose(in);
+    }
+    waitpid(pid, &status, 0);
+
+    result->ok = WIFEXITED(status) && (WEXITSTATUS(status) == 0) && (done != 0.0);
+
+    return result->ok;
+}
+
+/**
+*   @brief      Look up a result by "scenario.metric"
+*/
+static bool sim_bench_find(char const * const key, double * const value)
+{
+    for (uint32_t s = 0u; s < SIM_BENCH_N_SCENARIOS; s++)
+    {
+        size_t const len = strlen(l_sim_bench_scenarios[s].name);
+
+        if ((strncmp(key, l_sim_bench_scenarios[s].name, len) != 0) || (key[len] != '.'))
+        {
+            continue;
+        }
+
+        for (uint32_t m = 0u; m < l_sim_bench_results[s].n_metrics; m++)
+        {
+            if (strcmp(&key[len + 1u], l_sim_bench_results[s].metrics[m].name) == 0)
+            {
+                *value = l_sim_bench_results[s].metrics[m].value;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+*   @brief      Read the baseline: "scenario.metric value tolerance_pct lower|higher"
+*/
+static bool sim_bench_load_baseline(char const * const path)
+{
+    char line[256];
+    FILE * const in = fopen(path, "r");
+
+    l_sim_bench_n_baseline = 0u;
+
+    if (in == NULL)
+    {
+        return false;
+    }
+
+    while ((fgets(line, sizeof(line), in) != NULL) && (l_sim_bench_n_baseline < SIM_BENCH_MAX_BASELINE))
+    {
+        sim_bench_baseline_t * const b = &l_sim_bench_baseline[l_sim_bench_n_baseline];
+        char value[32];
+        char better[16];
+
+        if ((line[0] == '#') ||
+            (sscanf(line, "%63s %31s %lf %15s", b->key, value, &b->tolerance_pct, better) != 4))
+        {
+            continue;
+        }
+
+        b->pending          = (strcmp(value, "-") == 0);
+        b->value            = b->pending ? 0.0 : strtod(value, NULL);
+        b->higher_is_better = (strcmp(better, "higher") == 0);
+        l_sim_bench_n_baseline++;
+    }
+
+    fclose(in);
+
+    return true;
+}
+
+/**
+*   @brief      Replace the baseline values with the current results
+*   @details    The set of gated metrics and their tolerances are kept.
+*/
+static bool sim_bench_save_baseline(char const * const path)
+{
+    FILE * const out = fopen(path, "w");
+
+    if (out == NULL)
+    {
+        return false;
+    }
+
+    fprintf(out, "# sim_bench baseline, see sim/sim_bench.c. Refresh with --update-baseline\n");
+    fprintf(out, "# after an intended performance change and commit it with the change.\n");
+    fprintf(out, "# scenario.metric value tolerance_pct better, value \"-\" is not recorded yet\n");
+
+    for (uint32_t i = 0u; i < l_sim_bench_n_baseline; i++)
+    {
+        sim_bench_baseline_t * const b = &l_sim_bench_baseline[i];
+
+        if (sim_bench_find(b->key, &b->value))
+        {
+            b->pending = false;
+        }
+
+        if (b->pending)
+        {
+            fprintf(out, "%-36s %12s %6.1f %s\n", b->key, "-", b->tolerance_pct,
+                    b->higher_is_better ? "higher" : "lower");
+        }
+        else
+        {
+            fprintf(out, "%-36s %12.2f %6.1f %s\n", b->key, b->value, b->tolerance_pct,
+                    b->higher_is_better ? "higher" : "lower");
+        }
+    }
+
+    fclose(out);
+
+    return true;
+}
+
+/**
+*   @brief      Write the results of the selected scenarios as JSON
+*/
+static bool sim_bench_write_json(char const * const path, uint64_t seed, bool const * const selected)
+{
+    FILE * const out = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    bool first = true;
+
+    if (out == NULL)
+    {
+        return false;
+    }
+
+    fprintf(out, "{\n  \"seed\": %llu,\n  \"results\": {", (unsigned long long)seed);
+
+    for (uint32_t s = 0u; s < SIM_BENCH_N_SCENARIOS; s++)
+    {
+        if (!selected[s])
+        {
+            continue;
+        }
+
+        fprintf(out, "%s\n    \"%s\": {\"ok\": %s", first ? "" : ",", l_sim_bench_scenarios[s].name,
+                l_sim_bench_results[s].ok ? "true" : "false");
+
+        for (uint32_t m = 0u; m < l_sim_bench_results[s].n_metrics; m++)
+        {
+            fprintf(out, ", \"%s\": %.2f", l_sim_bench_results[s].metrics[m].name,
+                    l_sim_bench_results[s].metrics[m].value);
+        }
+
+        fprintf(out, "}");
+        first = false;
+    }
+
+    fprintf(out, "\n  }\n}\n");
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    return true;
+}
+
+/**
+*   @brief      Print the baseline comparison
+*   @param[in]  selected    - scenarios that ran
+*   @param[out] unrecorded  - number of gated metrics without a baseline value
+*   @return     uint32_t    - number of regressed or missing metrics
+*/
+static uint32_t sim_bench_compare(bool const * const selected, uint32_t * const unrecorded)
+{
+    uint32_t regressions = 0u;
+
+    *unrecorded = 0u;
+
+    printf("%-36s %12s %12s %8s  %s\n", "metric", "baseline", "result", "delta%", "status");
+
+    for (uint32_t i = 0u; i < l_sim_bench_n_baseline; i++)
+    {
+        sim_bench_baseline_t const * const b = &l_sim_bench_baseline[i];
+        double value = 0.0;
+        bool in_scope = false;
+
+        for (uint32_t s = 0u; s < SIM_BENCH_N_SCENARIOS; s++)
+        {
+            size_t const len = strlen(l_sim_bench_scenarios[s].name);
+
+            in_scope = in_scope || (selected[s] && (strncmp(b->key, l_sim_bench_scenarios[s].name, len) == 0) &&
+                                    (b->key[len] == '.'));
+        }
+
+        if (!in_scope)
+        {
+            continue;
+        }
+
+        if (!sim_bench_find(b->key, &value))
+        {
+            printf("%-36s %12.2f %12s %8s  MISSING\n", b->key, b->value, "-", "-");
+            regressions++;
+            continue;
+        }
+
+        if (b->pending)
+        {
+            printf("%-36s %12s %12.2f %8s  NOT RECORDED\n", b->key, "-", value, "-");
+            (*unrecorded)++;
+            continue;
+        }
+
+        double const limit = b->higher_is_better ? (b->value * (1.0 - (b->tolerance_pct / 100.0)))
+                                                 : (b->value * (1.0 + (b->tolerance_pct / 100.0)));
+        bool const regressed = b->higher_is_better ? (value < limit) : (value > limit);
+        double const delta = (b->value != 0.0) ? (((value - b->value) * 100.0) / b->value) : 0.0;
+
+        printf("%-36s %12.2f %12.2f %+8.1f  %s\n", b->key, b->value, value, delta, regressed ? "REGRESSED" : "ok");
+
+        if (regressed)
+        {
+            regressions++;
+        }
+    }
+
+    return regressions;
+}
+
+/**
+*   @brief      Check that every fault scenario saw its faults
+*   @details    Without them its recovery figures would be those of a clean bus.
+*/
+static bool sim_bench_faults_injected(void)
+{
+    bool ok = true;
+
+    for (uint32_t s = 0u; s < SIM_BENCH_N_SCENARIOS; s++)
+    {
+        char key[SIM_BENCH_NAME_SIZE + 16u];
+        double injected = 0.0;
+
+        if (strncmp(l_sim_bench_scenarios[s].name, "fault_", 6u) != 0)
+        {
+            continue;
+        }
+
+        snprintf(key, sizeof(key), "%s.faults_injected", l_sim_bench_scenarios[s].name);
+
+        if (!sim_bench_find(key, &injected) || (injected == 0.0))
+        {
+            fprintf(stderr, "%s injected no faults\n", l_sim_bench_scenarios[s].name);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+/**
+*   @brief      Host monotonic time, to report CPU cost per transaction
+*/
+static uint64_t sim_bench_wall_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char * argv[])
+{
+    char const * scenario  = NULL;
+    char const * json_path = NULL;
+    char const * baseline  = SIM_BENCH_DEFAULT_BASELINE;
+    uint64_t seed          = SIM_BENCH_DEFAULT_SEED;
+    bool update            = false;
+    bool require_baseline  = false;
+    bool selected[SIM_BENCH_N_SCENARIOS];
+    bool runs_ok           = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--scenario") == 0) && ((i + 1) < argc))
+        {
+            scenario = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc))
+        {
+            seed = strtoull(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "--json") == 0) && ((i + 1) < argc))
+        {
+            json_path = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--baseline") == 0) && ((i + 1) < argc))
+        {
+            baseline = argv[++i];
+        }
+        else if (strcmp(argv[i], "--update-baseline") == 0)
+        {
+            update = true;
+        }
+        else if (strcmp(argv[i], "--require-baseline") == 0)
+        {
+            require_baseline = true;
+        }
+        else if (strcmp(argv[i], "--list") == 0)
+        {
+            for (uint32_t s = 0u; s < SIM_BENCH_N_SCENARIOS; s++)
+            {
+                printf("%s\n", l_sim_bench_scenarios[s].name);
+            }
+            return 0;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--scenario NAME] [--seed N] [--json FILE] "
+                            "[--baseline FILE] [--update-baseline] [--require-baseline] [--list]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t s = 0u; s < SIM_BENCH_N_SCENARIOS; s++)
+    {
+        selected[s] = (scenario == NULL) || (strcmp(scenario, l_sim_bench_scenarios[s].name) == 0);
+
+        if (selected[s] && !sim_bench_run(&l_sim_bench_scenarios[s], seed, &l_sim_bench_results[s]))
+        {
+            fprintf(stderr, "scenario %s did not complete\n", l_sim_bench_scenarios[s].name);
+            runs_ok = false;
+        }
+    }
+
+    if ((json_path != NULL) && !sim_bench_write_json(json_path, seed, selected))
+    {
+        fprintf(stderr, "cannot write %s\n", json_path);
+        return 2;
+    }
+
+    if (!sim_bench_load_baseline(baseline))
+    {
+        fprintf(stderr, "cannot read %s\n", baseline);
+        return 2;
+    }
+
+    if (update)
+    {
+        if (!runs_ok || (scenario != NULL) || !sim_bench_faults_injected() || !sim_bench_save_baseline(baseline))
+        {
+            fprintf(stderr, "baseline not updated: needs a complete run of every scenario\n");
+            return 2;
+        }
+        return 0;
+    }
+
+    uint32_t unrecorded = 0u;
+    uint32_t const regressions = sim_bench_compare(selected, &unrecorded);
+
+    if (regressions > 0u)
+    {
+        fprintf(stderr, "%u gated metrics regressed or are missing, see above\n", (unsigned)regressions);
+    }
+
+    if (unrecorded > 0u)
+    {
+        fprintf(stderr, "%u gated metrics have no baseline value, record them with --update-baseline\n",
+                (unsigned)unrecorded);
+    }
+
+    return ((regressions > 0u) || (require_baseline && (unrecorded > 0u)) || !runs_ok) ? 1 : 0;
+}
@@ -0,0 +1,341 @@
+/**
+ * @file        sim_device_table.c
+ * @brief       Compact device_level model for simulating very many devices
+ * @details     Requests are closed loop: a device issues its next request as soon
+ *              as the previous one is answered. The random draws come from the
+ *              seeded sim generator, so a table run is reproducible from the seed
+ *              given to sim_init().
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_i2c_faults.h"
+#include "sim_i2c_bus.h"
+#include "sim_device_table.h"
+
+#define SIM_DEVICE_TABLE_NEVER          UINT32_MAX
+
+// Private functions
+static uint32_t sim_device_table_ticks(sim_device_table_t const * const me, sim_time_t us);
+
+static void sim_device_table_issue(sim_device_table_t * const me, uint32_t i);
+
+static void sim_device_table_next_request(sim_device_table_t * const me, uint32_t i);
+
+static void sim_device_table_fail(sim_device_table_t * const me, uint32_t i);
+
+static void sim_device_table_step(sim_device_table_t * const me, uint32_t i);
+
+/**
+*   @brief      Microseconds to ticks, rounded up
+*/
+static uint32_t sim_device_table_ticks(sim_device_table_t const * const me, sim_time_t us)
+{
+    return (uint32_t)((us + me->config.tick_us - 1u) / me->config.tick_us);
+}
+
+/**
+*   @brief      Put the current request of a device on its bus
+*   @details    The fault engine decides the outcome up front, so the device only
+*               needs one deadline: the answer, the error or the lockup timeout.
+*/
+static void sim_device_table_issue(sim_device_table_t * const me, uint32_t i)
+{
+    sim_device_cold_t const * const cold = &me->cold[i];
+    uint32_t const bits = sim_i2c_bus_transaction_bits(true, cold->read ? 0u : cold->length,
+                                                       cold->read ? cold->length : 0u);
+    sim_time_t answer_us = (((uint64_t)bits * SIM_US_PER_SEC) + me->config.bus_hz - 1u) / me->config.bus_hz;
+
+    answer_us += me->config.overhead_us;
+    me->txn_id[i]++;
+
+    switch (sim_i2c_faults_next())
+    {
+        case SIM_I2C_FAULT_NAK:
+        case SIM_I2C_FAULT_ARBITRATION:
+        {
+            me->state[i] = SIM_DEVICE_BUSY_ERROR;
+            break;
+        }
+        case SIM_I2C_FAULT_TIMEOUT:
+        case SIM_I2C_FAULT_STUCK_LOW:
+        {
+            me->state[i] = SIM_DEVICE_BUSY_LOST;
+            answer_us    = me->config.lockup_us;
+            break;
+        }
+        case SIM_I2C_FAULT_DELAYED:
+        {
+            answer_us += sim_i2c_faults_get_delay_us();
+            me->state[i] = (answer_us < me->config.lockup_us) ? SIM_DEVICE_BUSY : SIM_DEVICE_BUSY_LOST;
+
+            if (me->state[i] == SIM_DEVICE_BUSY_LOST)
+            {
+                answer_us = me->config.lockup_us;
+            }
+            break;
+        }
+        default:
+        {
+            me->state[i] = SIM_DEVICE_BUSY;
+            break;
+        }
+    }
+
+    me->deadline[i] = me->now + sim_device_table_ticks(me, answer_us);
+}
+
+/**
+*   @brief      Draw and issue the next request of a device, or retire it
+*/
+static void sim_device_table_next_request(sim_device_table_t * const me, uint32_t i)
+{
+    sim_device_cold_t * const cold = &me->cold[i];
+
+    if (cold->served >= me->config.n_requests)
+    {
+        me->state[i]    = SIM_DEVICE_DONE;
+        me->deadline[i] = SIM_DEVICE_TABLE_NEVER;
+        me->n_done++;
+        return;
+    }
+
+    cold->read      = (sim_rand_range(0u, 99u) < me->config.read_percent);
+    cold->length    = (uint16_t)sim_rand_range(me->config.min_length, me->config.max_length);
+    cold->reg       = (uint8_t)sim_rand_range(0u, 0xFFu);
+    cold->issued_at = (sim_time_t)me->now * me->config.tick_us;
+    me->retries[i]  = 0u;
+
+    sim_device_table_issue(me, i);
+}
+
+/**
+*   @brief      End the current request in an error and start the recovery
+*/
+static void sim_device_table_fail(sim_device_table_t * const me, uint32_t i)
+{
+    me->cold[i].failed++;
+    me->cold[i].served++;
+    me->cold[i].recoveries++;
+
+    me->state[i]    = SIM_DEVICE_ERROR;
+    me->deadline[i] = me->now + sim_device_table_ticks(me, me->config.recovery_us);
+}
+
+/**
+*   @brief      Handle a device whose deadline has come
+*/
+static void sim_device_table_step(sim_device_table_t * const me, uint32_t i)
+{
+    sim_device_cold_t * const cold = &me->cold[i];
+
+    me->transitions++;
+
+    switch (me->state[i])
+    {
+        case SIM_DEVICE_STARTING:
+        {
+            sim_device_table_next_request(me, i);
+            break;
+        }
+        case SIM_DEVICE_BUSY:
+        {
+            sim_time_t const latency = ((sim_time_t)me->now * me->config.tick_us) - cold->issued_at;
+            uint32_t bin = 0u;
+
+            while (((latency >> (bin + 1u)) != 0u) && (bin < (SIM_LOAD_HIST_BINS - 1u)))
+            {
+                bin++;
+            }
+            me->histogram[bin]++;
+
+            if (latency > cold->latency_max_us)
+            {
+                cold->latency_max_us = (uint32_t)latency;
+            }
+
+            cold->completed++;
+            cold->served++;
+            me->bytes += cold->length;
+
+            sim_device_table_next_request(me, i);
+            break;
+        }
+        case SIM_DEVICE_BUSY_ERROR:
+        {
+            sim_device_table_fail(me, i);
+            break;
+        }
+        case SIM_DEVICE_BUSY_LOST:
+        {
+            cold->lost++;
+
+            if (me->retries[i] < me->config.max_retries)
+            {
+                me->retries[i]++;
+                sim_device_table_issue(me, i);
+            }
+            else
+            {
+                sim_device_table_fail(me, i);
+            }
+            break;
+        }
+        case SIM_DEVICE_ERROR:
+        {
+            me->state[i]    = SIM_DEVICE_STARTING;
+            me->deadline[i] = me->now + sim_device_table_ticks(me, me->config.startup_us);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**
+*   @brief      Allocate a table and start every device
+*   @param[in]  me          - table
+*   @param[in]  config      - parameters shared by the devices
+*   @param[out] nothing
+*   @return     bool        - false if the table could not be allocated
+*/
+bool sim_device_table_init(sim_device_table_t * const me, sim_device_table_config_t const * const config)
+{
+    memset(me, 0, sizeof(*me));
+
+    me->config = *config;
+
+    if (me->config.tick_us == 0u)
+    {
+        me->config.tick_us = 1u;
+    }
+
+    uint32_t const n = me->config.n_devices;
+
+    me->state    = calloc(n, sizeof(me->state[0]));
+    me->deadline = calloc(n, sizeof(me->deadline[0]));
+    me->txn_id   = calloc(n, sizeof(me->txn_id[0]));
+    me->retries  = calloc(n, sizeof(me->retries[0]));
+    me->cold     = calloc(n, sizeof(me->cold[0]));
+
+    if ((me->state == NULL) || (me->deadline == NULL) || (me->txn_id == NULL) ||
+        (me->retries == NULL) || (me->cold == NULL))
+    {
+        sim_device_table_free(me);
+        return false;
+    }
+
+    sim_i2c_faults_init(&me->config.faults);
+
+    uint32_t const startup = sim_device_table_ticks(me, me->config.startup_us);
+
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        me->state[i]    = SIM_DEVICE_STARTING;
+        me->deadline[i] = startup;
+    }
+
+    return true;
+}
+
+/**
+*   @brief      Release the storage of a table
+*/
+void sim_device_table_free(sim_device_table_t * const me)
+{
+    free(me->state);
+    free(me->deadline);
+    free(me->txn_id);
+    free(me->retries);
+    free(me->cold);
+
+    me->state    = NULL;
+    me->deadline = NULL;
+    me->txn_id   = NULL;
+    me->retries  = NULL;
+    me->cold     = NULL;
+}
+
+/**
+*   @brief      Run until every device is done or a time limit
+*   @param[in]  me          - table
+*   @param[in]  limit_us    - virtual time limit
+*   @param[out] nothing
+*   @return     bool        - true if every device served all its requests
+*/
+bool sim_device_table_run(sim_device_table_t * const me, sim_time_t limit_us)
+{
+    uint32_t const n     = me->config.n_devices;
+    uint32_t const limit = sim_device_table_ticks(me, limit_us);
+
+    while (me->n_done < n)
+    {
+        uint32_t next = SIM_DEVICE_TABLE_NEVER;
+
+        for (uint32_t i = 0u; i < n; i++)
+        {
+            if (me->deadline[i] <= me->now)
+            {
+                sim_device_table_step(me, i);
+            }
+            if (me->deadline[i] < next)
+            {
+                next = me->deadline[i];
+            }
+        }
+
+        if (me->n_done >= n)
+        {
+            break;
+        }
+        if (next > limit)
+        {
+            me->now = limit;
+            return false;
+        }
+
+        me->now = next;
+    }
+
+    return true;
+}
+
+/**
+*   @brief      Sum the per-device counters
+*/
+void sim_device_table_get_report(sim_device_table_t const * const me, sim_device_table_report_t * const report)
+{
+    memset(report, 0, sizeof(*report));
+
+    report->devices     = me->config.n_devices;
+    report->done        = me->n_done;
+    report->bytes       = me->bytes;
+    report->transitions = me->transitions;
+    report->elapsed_us  = (sim_time_t)me->now * me->config.tick_us;
+    memcpy(report->histogram, me->histogram, sizeof(report->histogram));
+
+    for (uint32_t i = 0u; i < me->config.n_devices; i++)
+    {
+        sim_device_cold_t const * const cold = &me->cold[i];
+
+        report->completed  += cold->completed;
+        report->failed     += cold->failed;
+        report->lost       += cold->lost;
+        report->recoveries += cold->recoveries;
+
+        if (cold->latency_max_us > report->latency_max_us)
+        {
+            report->latency_max_us = cold->latency_max_us;
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/**
+ * @file        sim_device_table.h
+ * @brief       Compact device_level model for simulating very many devices
+ * @details     A full device_level instance is an AO with three time events and
+ *              its own buffers, and a sim process holds only one. This table
+ *              models the same transaction lifecycle for many devices at once,
+ *              each on its own bus, without QF:
+ *
+ *              STARTING -> IDLE -> BUSY -> IDLE ...
+ *                                   |  lockup timeout: retry, up to max_retries
+ *                                   |  error or retries used up: ERROR
+ *              ERROR    -> STARTING after recovery_us (the supervisor re-enable)
+ *
+ *              The state is kept as a structure of arrays. What the step loop
+ *              touches for every device (state, deadline, transaction ID, retry
+ *              count) lives in small contiguous arrays; per-device counters and
+ *              the current request are cold and only touched on a transition.
+ *
+ *              Time advances in ticks of tick_us; deadlines are stored in ticks.
+ *              Each step scans the deadline array once and jumps to the earliest
+ *              deadline, so idle stretches cost one scan.
+ *
+ *              Bus faults come from the sim_i2c_faults profile: NAK and
+ *              ARBITRATION end the request in an error, TIMEOUT and STUCK_LOW leave
+ *              it unanswered, DELAYED adds delay_us to the answer, CORRUPT and
+ *              DUPLICATE are invisible at this level. Scripted faults are not used.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_DEVICE_TABLE_H
+#define SIM_DEVICE_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim.h"
+#include "sim_i2c_faults.h"
+#include "sim_load.h"
+
+// Device states
+typedef enum
+{
+    SIM_DEVICE_STARTING         = 0,                            /**< Waiting for the startup delay >*/
+    SIM_DEVICE_BUSY,                                            /**< Answer due at the deadline >*/
+    SIM_DEVICE_BUSY_ERROR,                                      /**< Error response due at the deadline >*/
+    SIM_DEVICE_BUSY_LOST,                                       /**< Lockup timeout at the deadline >*/
+    SIM_DEVICE_ERROR,                                           /**< Recovering until the deadline >*/
+    SIM_DEVICE_DONE,                                            /**< All requests served >*/
+} sim_device_state_t;
+
+/*! @struct sim_device_table_config_t
+*   @brief  Parameters shared by every device of a table
+*/
+typedef struct
+{
+    uint32_t                n_devices;
+    uint32_t                n_requests;                         /**< Requests per device >*/
+    uint32_t                read_percent;                       /**< Share of reads, 0 to 100 >*/
+    uint16_t                min_length;                         /**< Shortest transfer, bytes >*/
+    uint16_t                max_length;                         /**< Longest transfer, bytes >*/
+    uint32_t                bus_hz;                             /**< SCL frequency >*/
+    uint32_t                overhead_us;                        /**< Fixed cost per transaction >*/
+    uint32_t                tick_us;                            /**< Time resolution, 0 for 1us >*/
+    uint32_t                startup_us;                         /**< Enable to ready >*/
+    uint32_t                lockup_us;                          /**< Request timeout >*/
+    uint32_t                recovery_us;                        /**< Error to re-enable >*/
+    uint8_t                 max_retries;                        /**< Re-issues after a lockup timeout >*/
+    sim_i2c_fault_profile_t faults;                             /**< Random fault rates >*/
+} sim_device_table_config_t;
+
+/*! @struct sim_device_cold_t
+*   @brief  Per-device data touched only on transitions
+*/
+typedef struct
+{
+    sim_time_t              issued_at;                          /**< Current request, first issue >*/
+    uint32_t                served;                             /**< Requests completed or failed >*/
+    uint32_t                completed;
+    uint32_t                failed;
+    uint32_t                lost;                               /**< Lockup timeouts >*/
+    uint32_t                recoveries;
+    uint32_t                latency_max_us;
+    uint16_t                length;                             /**< Current request length >*/
+    uint8_t                 reg;                                /**< Current request register >*/
+    bool                    read;                               /**< Current request is a read >*/
+} sim_device_cold_t;
+
+/*! @struct sim_device_table_t
+*   @brief  Device table
+*/
+typedef struct
+{
+    sim_device_table_config_t   config;
+    uint32_t                    now;                            /**< Ticks >*/
+    uint32_t                    n_done;                         /**< Devices in DONE >*/
+
+    // Hot, one entry per device
+    uint8_t *                   state;                          /**< sim_device_state_t >*/
+    uint32_t *                  deadline;                       /**< Ticks >*/
+    uint16_t *                  txn_id;
+    uint8_t *                   retries;
+
+    // Cold
+    sim_device_cold_t *         cold;
+
+    // Whole-table results
+    uint64_t                    transitions;
+    uint64_t                    bytes;
+    uint32_t                    histogram[SIM_LOAD_HIST_BINS];  /**< Latency of the answered requests >*/
+} sim_device_table_t;
+
+/*! @struct sim_device_table_report_t
+*   @brief  Totals over the devices of a table
+*/
+typedef struct
+{
+    uint32_t                devices;
+    uint32_t                done;                               /**< Devices that served every request >*/
+    uint64_t                completed;
+    uint64_t                failed;
+    uint64_t                lost;
+    uint64_t                recoveries;
+    uint64_t                bytes;
+    uint64_t                transitions;
+    sim_time_t              elapsed_us;
+    uint32_t                latency_max_us;
+    uint32_t                histogram[SIM_LOAD_HIST_BINS];
+} sim_device_table_report_t;
+
+// Default configuration, the timing of sim_i2c_bus and device_level
+#define SIM_DEVICE_TABLE_DEFAULT_CONFIG                                                 \
+{                                                                                       \
+    .n_devices = 100000u, .n_requests = 100u, .read_percent = 50u,                      \
+    .min_length = 1u, .max_length = 4u, .bus_hz = 400000u, .overhead_us = 50u,          \
+    .tick_us = 10u, .startup_us = 0u, .lockup_us = 20u * SIM_US_PER_MS,                 \
+    .recovery_us = 1u * SIM_US_PER_MS, .max_retries = 3u,                               \
+}
+
+bool sim_device_table_init(sim_device_table_t * const me, sim_device_table_config_t const * const config);
+
+void sim_device_table_free(sim_device_table_t * const me);
+
+bool sim_device_table_run(sim_device_table_t * const me, sim_time_t limit_us);
+
+void sim_device_table_get_report(sim_device_table_t const * const me, sim_device_table_report_t * const report);
+
+#endif
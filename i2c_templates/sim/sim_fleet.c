@@ -0,0 +1,620 @@
+/**
+ * @file        sim_fleet.c
+ * @brief       Fleet runner: many independent simulated devices across all cores
+ * @details     Every instance is a full bus model, device_level and load generator
+ *              triple with its own seed and fault profile. Instances are spread
+ *              over the fault profiles round robin, so a fault matrix is one run.
+ *
+ *              QF and the driver AOs are process-wide singletons, so an instance
+ *              is a forked process. A pool of worker processes claims instances
+ *              from a shared counter as they become free, which balances the load
+ *              the way work stealing would: a worker that drew quick instances
+ *              simply claims more. Reports land in shared memory and are merged
+ *              per profile once every worker is done.
+ *
+ *              Usage: sim_fleet [--instances N] [--workers N] [--requests N]
+ *                               [--seed N] [--profile FAULT:PER_MILLION]...
+ *                               [--compact] [--json FILE]
+ *
+ *              FAULT is a name from sim_i2c_faults_get_name(), "none" for a clean
+ *              bus. Without --profile every instance runs on a clean bus.
+ *
+ *              With --compact, instances are rows of a sim_device_table instead of
+ *              full driver processes. Each worker runs one table per profile with
+ *              its share of the instances, which reaches hundreds of thousands of
+ *              devices per core at the cost of modelling device_level's lifecycle
+ *              rather than running it.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "sim_i2c_faults.h"
+#include "sim_i2c_bus.h"
+#include "sim_load.h"
+#include "sim_system.h"
+#include "sim_device_table.h"
+
+#define SIM_FLEET_DEFAULT_INSTANCES     1024u
+#define SIM_FLEET_DEFAULT_REQUESTS      500u
+#define SIM_FLEET_DEFAULT_SEED          1u
+#define SIM_FLEET_MAX_PROFILES          16u
+
+// Virtual time an instance may take before it is declared stuck
+#define SIM_FLEET_RUN_LIMIT_US          (600u * SIM_US_PER_SEC)
+#define SIM_FLEET_RUN_SLICE_US          (10u * SIM_US_PER_MS)
+
+/*! @struct sim_fleet_profile_t
+*   @brief  One column of the fault matrix
+*/
+typedef struct
+{
+    sim_i2c_fault_t         fault;
+    uint32_t                per_million;
+} sim_fleet_profile_t;
+
+/*! @struct sim_fleet_result_t
+*   @brief  Outcome of one instance, written by the instance process
+*/
+typedef struct
+{
+    bool                    ok;                                 /**< Ran to the end >*/
+    sim_load_report_t       report;
+} sim_fleet_result_t;
+
+/*! @struct sim_fleet_shared_t
+*   @brief  Shared between all processes
+*/
+typedef struct
+{
+    uint32_t                next;                               /**< Next instance to claim >*/
+    sim_fleet_result_t      results[];                          /**< One per instance >*/
+} sim_fleet_shared_t;
+
+/*! @struct sim_fleet_aggregate_t
+*   @brief  Merged results of one profile
+*/
+typedef struct
+{
+    uint32_t                instances;
+    uint32_t                stuck;                              /**< Instances that did not finish >*/
+    uint64_t                completed;
+    uint64_t                failed;
+    uint64_t                lost;
+    uint64_t                recoveries;
+    sim_time_t              elapsed_us;                         /**< Sum over instances >*/
+    uint64_t                histogram[SIM_LOAD_HIST_BINS];
+    sim_latency_t           instance_p99;                       /**< Spread of the per-instance p99 >*/
+    sim_latency_t           instance_recovery_max;              /**< Spread of the per-instance worst recovery >*/
+    uint32_t                worst;                              /**< Instance with the highest p99 >*/
+} sim_fleet_aggregate_t;
+
+static sim_load_config_t const l_sim_fleet_load =
+{
+    .n_requests = SIM_FLEET_DEFAULT_REQUESTS, .read_percent = 50u, .min_length = 1u, .max_length = 4u,
+    .n_registers = 252u, .interval_us = 0u, .watchdog_ms = 200u,
+};
+
+/*! @struct sim_fleet_compact_shared_t
+*   @brief  Compact mode results, one per worker and profile
+*/
+typedef struct
+{
+    uint64_t                wall_ns[SIM_FLEET_MAX_PROFILES];    /**< Host time per table, indexed by profile >*/
+    sim_device_table_report_t reports[];                        /**< [worker * SIM_FLEET_MAX_PROFILES + profile] >*/
+} sim_fleet_compact_shared_t;
+
+static sim_fleet_profile_t l_sim_fleet_profiles[SIM_FLEET_MAX_PROFILES];
+static uint32_t l_sim_fleet_n_profiles;
+
+// Private functions
+static void sim_fleet_run_instance(uint32_t index, uint64_t seed, sim_load_config_t const * const load,
+                                   sim_fleet_result_t * const result);
+
+static void sim_fleet_worker(sim_fleet_shared_t * const shared, uint32_t n_instances, uint64_t seed,
+                             sim_load_config_t const * const load);
+
+static void sim_fleet_aggregate(sim_fleet_shared_t const * const shared, uint32_t n_instances,
+                                uint32_t profile, sim_fleet_aggregate_t * const agg);
+
+static uint64_t sim_fleet_hist_percentile(uint64_t const * const histogram, uint32_t percent);
+
+static int sim_fleet_run_compact(uint32_t n_instances, long n_workers, uint64_t seed, uint32_t n_requests,
+                                 char const * const json_path);
+
+static bool sim_fleet_parse_profile(char const * const arg);
+
+static uint64_t sim_fleet_wall_ns(void);
+
+/**
+*   @brief      Run one instance to the end, in the calling process
+*/
+static void sim_fleet_run_instance(uint32_t index, uint64_t seed, sim_load_config_t const * const load,
+                                   sim_fleet_result_t * const result)
+{
+    sim_fleet_profile_t const * const profile = &l_sim_fleet_profiles[index % l_sim_fleet_n_profiles];
+    sim_i2c_bus_config_t bus = SIM_I2C_BUS_DEFAULT_CONFIG;
+
+    bus.faults.per_million[profile->fault] = profile->per_million;
+
+    sim_system_start(seed + index, &bus);
+    sim_load_start(SIM_CLIENT_PRIORITY, load);
+
+    while (!sim_load_is_done() && (sim_now() < SIM_FLEET_RUN_LIMIT_US))
+    {
+        sim_run_for(SIM_FLEET_RUN_SLICE_US);
+    }
+
+    sim_load_get_report(&result->report);
+    result->ok = sim_load_is_done();
+}
+
+/**
+*   @brief      Claim instances until none are left, each in its own process
+*/
+static void sim_fleet_worker(sim_fleet_shared_t * const shared, uint32_t n_instances, uint64_t seed,
+                             sim_load_config_t const * const load)
+{
+    for (;;)
+    {
+        uint32_t const index = __atomic_fetch_add(&shared->next, 1u, __ATOMIC_RELAXED);
+
+        if (index >= n_instances)
+        {
+            break;
+        }
+
+        pid_t const pid = fork();
+
+        if (pid == 0)
+        {
+            sim_fleet_run_instance(index, seed, load, &shared->results[index]);
+            _exit(0);
+        }
+
+        if (pid > 0)
+        {
+            int status = 0;
+
+            waitpid(pid, &status, 0);
+
+            // An instance that asserted leaves ok cleared
+            if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+            {
+                shared->results[index].ok = false;
+            }
+        }
+    }
+}
+
+/**
+*   @brief      Merge the results of the instances that ran one profile
+*/
+static void sim_fleet_aggregate(sim_fleet_shared_t const * const shared, uint32_t n_instances,
+                                uint32_t profile, sim_fleet_aggregate_t * const agg)
+{
+    sim_time_t * const p99s     = calloc(n_instances, sizeof(sim_time_t));
+    sim_time_t * const recovery = calloc(n_instances, sizeof(sim_time_t));
+    sim_time_t worst_p99 = 0u;
+    uint32_t n = 0u;
+
+    memset(agg, 0, sizeof(*agg));
+
+    for (uint32_t i = profile; (p99s != NULL) && (recovery != NULL) && (i < n_instances); i += l_sim_fleet_n_profiles)
+    {
+        sim_fleet_result_t const * const r = &shared->results[i];
+
+        agg->instances++;
+
+        if (!r->ok)
+        {
+            agg->stuck++;
+        }
+
+        agg->completed  += r->report.completed;
+        agg->failed     += r->report.failed;
+        agg->lost       += r->report.lost;
+        agg->recoveries += r->report.recoveries;
+        agg->elapsed_us += r->report.elapsed_us;
+
+        for (uint32_t b = 0u; b < SIM_LOAD_HIST_BINS; b++)
+        {
+            agg->histogram[b] += r->report.histogram[b];
+        }
+
+        if ((n == 0u) || (r->report.latency.p99 > worst_p99))
+        {
+            worst_p99  = r->report.latency.p99;
+            agg->worst = i;
+        }
+
+        p99s[n]     = r->report.latency.p99;
+        recovery[n] = r->report.recovery.max;
+        n++;
+    }
+
+    if ((p99s != NULL) && (recovery != NULL))
+    {
+        sim_latency_summarize(p99s, n, &agg->instance_p99);
+        sim_latency_summarize(recovery, n, &agg->instance_recovery_max);
+    }
+
+    free(p99s);
+    free(recovery);
+}
+
+/**
+*   @brief      Upper bound of the histogram bin holding a percentile
+*/
+static uint64_t sim_fleet_hist_percentile(uint64_t const * const histogram, uint32_t percent)
+{
+    uint64_t total = 0u;
+    uint64_t seen  = 0u;
+
+    for (uint32_t b = 0u; b < SIM_LOAD_HIST_BINS; b++)
+    {
+        total += histogram[b];
+    }
+
+    for (uint32_t b = 0u; b < SIM_LOAD_HIST_BINS; b++)
+    {
+        seen += histogram[b];
+
+        if ((total > 0u) && ((seen * 100u) >= (total * percent)))
+        {
+            return (2ull << b) - 1u;
+        }
+    }
+
+    return 0u;
+}
+
+/**
+*   @brief      Run the fleet as device tables, one per worker and profile
+*   @return     int         - exit status, 1 if a device did not finish
+*/
+static int sim_fleet_run_compact(uint32_t n_instances, long n_workers, uint64_t seed, uint32_t n_requests,
+                                 char const * const json_path)
+{
+    size_t const shared_size = sizeof(sim_fleet_compact_shared_t) +
+                               ((size_t)n_workers * SIM_FLEET_MAX_PROFILES * sizeof(sim_device_table_report_t));
+    sim_fleet_compact_shared_t * const shared = mmap(NULL, shared_size, PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (shared == MAP_FAILED)
+    {
+        fprintf(stderr, "cannot map %zu bytes\n", shared_size);
+        return 2;
+    }
+
+    uint64_t const wall_start = sim_fleet_wall_ns();
+
+    fflush(NULL);
+    for (long w = 0; w < n_workers; w++)
+    {
+        if (fork() != 0)
+        {
+            continue;
+        }
+
+        for (uint32_t p = 0u; p < l_sim_fleet_n_profiles; p++)
+        {
+            // Instances p, p + n_profiles, ... split evenly over the workers
+            uint32_t const in_profile = (n_instances / l_sim_fleet_n_profiles) +
+                                        ((p < (n_instances % l_sim_fleet_n_profiles)) ? 1u : 0u);
+            sim_device_table_config_t config = SIM_DEVICE_TABLE_DEFAULT_CONFIG;
+            sim_device_table_t table;
+
+            config.n_devices  = (uint32_t)(((uint64_t)in_profile * (uint64_t)(w + 1)) / (uint64_t)n_workers) -
+                                (uint32_t)(((uint64_t)in_profile * (uint64_t)w) / (uint64_t)n_workers);
+            config.n_requests = n_requests;
+            config.faults.per_million[l_sim_fleet_profiles[p].fault] = l_sim_fleet_profiles[p].per_million;
+
+            sim_init(seed + ((uint64_t)w * SIM_FLEET_MAX_PROFILES) + p);
+
+            if ((config.n_devices > 0u) && sim_device_table_init(&table, &config))
+            {
+                uint64_t const start = sim_fleet_wall_ns();
+
+                sim_device_table_run(&table, SIM_FLEET_RUN_LIMIT_US);
+                sim_device_table_get_report(&table, &shared->reports[(w * SIM_FLEET_MAX_PROFILES) + p]);
+                sim_device_table_free(&table);
+
+                __atomic_fetch_add(&shared->wall_ns[p], sim_fleet_wall_ns() - start, __ATOMIC_RELAXED);
+            }
+        }
+        _exit(0);
+    }
+
+    while (wait(NULL) > 0)
+    {
+    }
+
+    double const wall_s = (double)(sim_fleet_wall_ns() - wall_start) / 1e9;
+    FILE * const json   = (json_path != NULL) ? fopen(json_path, "w") : NULL;
+    uint32_t stuck      = 0u;
+
+    printf("%u compact instances on %ld workers in %.2f s (%.0f instances/s)\n\n",
+           n_instances, n_workers, wall_s, (wall_s > 0.0) ? (n_instances / wall_s) : 0.0);
+    printf("%-20s %8s %6s %10s %8s %8s %8s %9s %9s %9s %9s %12s\n", "profile", "inst", "stuck",
+           "completed", "failed", "lost", "recov", "txn/s", "p50<=us", "p99<=us", "max us", "txn/core-s");
+
+    if (json != NULL)
+    {
+        fprintf(json, "{\n  \"instances\": %u,\n  \"workers\": %ld,\n  \"wall_s\": %.3f,\n  \"compact\": true,\n"
+                      "  \"profiles\": [", n_instances, n_workers, wall_s);
+    }
+
+    for (uint32_t p = 0u; p < l_sim_fleet_n_profiles; p++)
+    {
+        sim_device_table_report_t total;
+        double device_us = 0.0;
+        uint64_t histogram[SIM_LOAD_HIST_BINS] = { 0u };
+        char name[48];
+
+        memset(&total, 0, sizeof(total));
+
+        for (long w = 0; w < n_workers; w++)
+        {
+            sim_device_table_report_t const * const r = &shared->reports[(w * SIM_FLEET_MAX_PROFILES) + p];
+
+            total.devices     += r->devices;
+            total.done        += r->done;
+            total.completed   += r->completed;
+            total.failed      += r->failed;
+            total.lost        += r->lost;
+            total.recoveries  += r->recoveries;
+            total.transitions += r->transitions;
+            device_us         += (double)r->devices * (double)r->elapsed_us;
+
+            if (r->latency_max_us > total.latency_max_us)
+            {
+                total.latency_max_us = r->latency_max_us;
+            }
+            for (uint32_t b = 0u; b < SIM_LOAD_HIST_BINS; b++)
+            {
+                histogram[b] += r->histogram[b];
+            }
+        }
+
+        stuck += total.devices - total.done;
+
+        snprintf(name, sizeof(name), "%s:%u", sim_i2c_faults_get_name(l_sim_fleet_profiles[p].fault),
+                 l_sim_fleet_profiles[p].per_million);
+
+        // Simulated rate per device, and host rate per core spent on this profile
+        double const tps      = (device_us > 0.0) ? ((double)total.completed * SIM_US_PER_SEC / device_us) : 0.0;
+        double const per_core = (shared->wall_ns[p] > 0u) ? ((double)total.completed * 1e9 / shared->wall_ns[p]) : 0.0;
+        uint64_t const p50    = sim_fleet_hist_percentile(histogram, 50u);
+        uint64_t const p99    = sim_fleet_hist_percentile(histogram, 99u);
+
+        printf("%-20s %8u %6u %10llu %8llu %8llu %8llu %9.1f %9llu %9llu %9u %12.0f\n", name,
+               total.devices, total.devices - total.done, (unsigned long long)total.completed,
+               (unsigned long long)total.failed, (unsigned long long)total.lost,
+               (unsigned long long)total.recoveries, tps, (unsigned long long)p50, (unsigned long long)p99,
+               total.latency_max_us, per_core);
+
+        if (json != NULL)
+        {
+            fprintf(json, "%s\n    {\"profile\": \"%s\", \"instances\": %u, \"stuck\": %u, \"completed\": %llu, "
+                          "\"failed\": %llu, \"lost\": %llu, \"recoveries\": %llu, \"txn_per_s\": %.2f, "
+                          "\"lat_p50_le_us\": %llu, \"lat_p99_le_us\": %llu, \"lat_max_us\": %u, "
+                          "\"txn_per_core_s\": %.0f}",
+                    (p == 0u) ? "" : ",", name, total.devices, total.devices - total.done,
+                    (unsigned long long)total.completed, (unsigned long long)total.failed,
+                    (unsigned long long)total.lost, (unsigned long long)total.recoveries, tps,
+                    (unsigned long long)p50, (unsigned long long)p99, total.latency_max_us, per_core);
+        }
+    }
+
+    if (json != NULL)
+    {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+
+    munmap(shared, shared_size);
+
+    return (stuck > 0u) ? 1 : 0;
+}
+
+/**
+*   @brief      Add a "fault:per_million" profile
+*/
+static bool sim_fleet_parse_profile(char const * const arg)
+{
+    char const * const colon = strchr(arg, ':');
+
+    if ((colon == NULL) || (l_sim_fleet_n_profiles >= SIM_FLEET_MAX_PROFILES))
+    {
+        return false;
+    }
+
+    for (uint32_t f = 0u; f < SIM_I2C_FAULT_COUNT; f++)
+    {
+        char const * const name = sim_i2c_faults_get_name((sim_i2c_fault_t)f);
+
+        if ((strlen(name) == (size_t)(colon - arg)) && (strncmp(arg, name, strlen(name)) == 0))
+        {
+            l_sim_fleet_profiles[l_sim_fleet_n_profiles].fault       = (sim_i2c_fault_t)f;
+            l_sim_fleet_profiles[l_sim_fleet_n_profiles].per_million = (uint32_t)strtoul(colon + 1, NULL, 0);
+            l_sim_fleet_n_profiles++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+*   @brief      Host monotonic time
+*/
+static uint64_t sim_fleet_wall_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t n_instances        = SIM_FLEET_DEFAULT_INSTANCES;
+    long     n_workers          = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed               = SIM_FLEET_DEFAULT_SEED;
+    char const * json_path      = NULL;
+    bool compact                = false;
+    sim_load_config_t load      = l_sim_fleet_load;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--instances") == 0) && ((i + 1) < argc))
+        {
+            n_instances = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "--workers") == 0) && ((i + 1) < argc))
+        {
+            n_workers = strtol(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "--requests") == 0) && ((i + 1) < argc))
+        {
+            load.n_requests = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc))
+        {
+            seed = strtoull(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "--profile") == 0) && ((i + 1) < argc) && sim_fleet_parse_profile(argv[i + 1]))
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--compact") == 0)
+        {
+            compact = true;
+        }
+        else if ((strcmp(argv[i], "--json") == 0) && ((i + 1) < argc))
+        {
+            json_path = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--instances N] [--workers N] [--requests N] [--seed N] "
+                            "[--profile FAULT:PER_MILLION]... [--compact] [--json FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (l_sim_fleet_n_profiles == 0u)
+    {
+        l_sim_fleet_n_profiles = 1u;
+    }
+    if (n_workers < 1)
+    {
+        n_workers = 1;
+    }
+    if (compact)
+    {
+        return sim_fleet_run_compact(n_instances, n_workers, seed, load.n_requests, json_path);
+    }
+
+    size_t const shared_size = sizeof(sim_fleet_shared_t) + (n_instances * sizeof(sim_fleet_result_t));
+    sim_fleet_shared_t * const shared = mmap(NULL, shared_size, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (shared == MAP_FAILED)
+    {
+        fprintf(stderr, "cannot map %zu bytes\n", shared_size);
+        return 2;
+    }
+
+    uint64_t const wall_start = sim_fleet_wall_ns();
+
+    fflush(NULL);
+    for (long w = 0; w < n_workers; w++)
+    {
+        if (fork() == 0)
+        {
+            sim_fleet_worker(shared, n_instances, seed, &load);
+            _exit(0);
+        }
+    }
+
+    while (wait(NULL) > 0)
+    {
+    }
+
+    double const wall_s = (double)(sim_fleet_wall_ns() - wall_start) / 1e9;
+    FILE * const json   = (json_path != NULL) ? fopen(json_path, "w") : NULL;
+    uint32_t stuck      = 0u;
+
+    printf("%u instances on %ld workers in %.2f s (%.0f instances/s)\n\n",
+           n_instances, n_workers, wall_s, (wall_s > 0.0) ? (n_instances / wall_s) : 0.0);
+    printf("%-20s %6s %6s %9s %8s %8s %8s %9s %9s %9s %11s %8s\n", "profile", "inst", "stuck",
+           "completed", "failed", "lost", "recov", "txn/s", "p50<=us", "p99<=us", "inst p99 max", "worst");
+
+    if (json != NULL)
+    {
+        fprintf(json, "{\n  \"instances\": %u,\n  \"workers\": %ld,\n  \"wall_s\": %.3f,\n  \"profiles\": [",
+                n_instances, n_workers, wall_s);
+    }
+
+    for (uint32_t p = 0u; p < l_sim_fleet_n_profiles; p++)
+    {
+        sim_fleet_aggregate_t agg;
+        char name[48];
+
+        sim_fleet_aggregate(shared, n_instances, p, &agg);
+        stuck += agg.stuck;
+
+        snprintf(name, sizeof(name), "%s:%u", sim_i2c_faults_get_name(l_sim_fleet_profiles[p].fault),
+                 l_sim_fleet_profiles[p].per_million);
+
+        double const tps   = (agg.elapsed_us > 0u) ? ((double)agg.completed * SIM_US_PER_SEC / agg.elapsed_us) : 0.0;
+        uint64_t const p50 = sim_fleet_hist_percentile(agg.histogram, 50u);
+        uint64_t const p99 = sim_fleet_hist_percentile(agg.histogram, 99u);
+
+        printf("%-20s %6u %6u %9llu %8llu %8llu %8llu %9.1f %9llu %9llu %11llu %8u\n", name,
+               agg.instances, agg.stuck, (unsigned long long)agg.completed, (unsigned long long)agg.failed,
+               (unsigned long long)agg.lost, (unsigned long long)agg.recoveries, tps,
+               (unsigned long long)p50, (unsigned long long)p99,
+               (unsigned long long)agg.instance_p99.max, agg.worst);
+
+        if (json != NULL)
+        {
+            fprintf(json, "%s\n    {\"profile\": \"%s\", \"instances\": %u, \"stuck\": %u, \"completed\": %llu, "
+                          "\"failed\": %llu, \"lost\": %llu, \"recoveries\": %llu, \"txn_per_s\": %.2f, "
+                          "\"lat_p50_le_us\": %llu, \"lat_p99_le_us\": %llu, \"instance_p99_p50_us\": %llu, "
+                          "\"instance_p99_max_us\": %llu, \"recovery_max_p50_us\": %llu, "
+                          "\"recovery_max_max_us\": %llu, \"worst_instance\": %u}",
+                    (p == 0u) ? "" : ",", name, agg.instances, agg.stuck, (unsigned long long)agg.completed,
+                    (unsigned long long)agg.failed, (unsigned long long)agg.lost,
+                    (unsigned long long)agg.recoveries, tps, (unsigned long long)p50, (unsigned long long)p99,
+                    (unsigned long long)agg.instance_p99.p50, (unsigned long long)agg.instance_p99.max,
+                    (unsigned long long)agg.instance_recovery_max.p50,
+                    (unsigned long long)agg.instance_recovery_max.max, agg.worst);
+        }
+    }
+
+    if (json != NULL)
+    {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+
+    munmap(shared, shared_size);
+
+    return (stuck > 0u) ? 1 : 0;
+}
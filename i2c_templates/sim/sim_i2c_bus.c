@@ -0,0 +1,543 @@
+/**
+ * @file        sim_i2c_bus.c
+ * @brief       Simulated I2C bus AO standing in for i2c_comm_ao on the host
+ * @details     The bus model is a QP Active Object with a single state:
+ *
+ *              sim_i2c_bus_initial     -   The initial state as required by QP
+ *              sim_i2c_bus_active      -   Queues requests and serves them one at
+ *                                          a time. The transfer time is spent on the
+ *                                          virtual clock through the sim scheduler,
+ *                                          which posts LOCAL_SIM_I2C_BUS_DONE_SIG
+ *                                          back to the AO when the transfer ends.
+ *
+ *              The fault engine (sim_i2c_faults.h) decides how each finished
+ *              transfer is answered.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "qpc.h"
+#include "common.h"
+#include "events.h"
+#include "signals.h"
+#include "replyables.h"
+#include "whoop_i2c.h"
+#include "mxc_errors.h"
+
+#include "sim.h"
+#include "sim_i2c_faults.h"
+#include "sim_i2c_bus.h"
+
+Q_DEFINE_THIS_FILE
+
+// Bits on the wire for one byte: 8 data bits and the ACK/NAK bit
+#define SIM_I2C_BUS_BITS_PER_BYTE       9u
+
+// Start and stop conditions, counted as one bit time each
+#define SIM_I2C_BUS_FRAMING_BITS        2u
+
+// Bus recovery: nine SCL pulses and a stop condition
+#define SIM_I2C_BUS_RECOVER_BITS        10u
+
+// AO event queue: room for the pending requests plus done and status events
+#define SIM_I2C_BUS_EVT_QUEUE_SIZE      (SIM_I2C_BUS_QUEUE_SIZE + 4u)
+
+/*! @struct sim_i2c_bus_pending_t
+*   @brief  A request waiting for, or using, the bus
+*/
+typedef struct
+{
+    i2c_comm_req_event_t    req;                                /**< Copy of the request event >*/
+} sim_i2c_bus_pending_t;
+
+/*! @struct sim_i2c_bus_reply_t
+*   @brief  A completion held back by a DELAYED fault
+*/
+typedef struct
+{
+    QActive *               requestor;                          /**< NULL while the slot is free >*/
+    uint32_t                id;                                 /**< Request ID to answer >*/
+} sim_i2c_bus_reply_t;
+
+/*! @struct sim_i2c_bus_t
+*   @brief  Active Object structure
+*/
+typedef struct
+{
+    QActive                 super;
+    sim_i2c_bus_config_t    config;                             /**< Bus model parameters >*/
+    bool                    busy;                               /**< A transfer is in progress >*/
+    sim_time_t              transfer_start;                     /**< Virtual time the transfer started >*/
+    sim_time_t              stuck_until;                        /**< Virtual time a stuck-low bus is released >*/
+    uint8_t                 head;                               /**< Index of the oldest pending request >*/
+    uint8_t                 count;                              /**< Number of pending requests >*/
+    sim_i2c_bus_pending_t   pending[SIM_I2C_BUS_QUEUE_SIZE];    /**< Pending requests, head is on the bus >*/
+    uint8_t                 registers[SIM_I2C_BUS_NUM_REGISTERS]; /**< Simulated device register file >*/
+    sim_i2c_bus_reply_t     delayed[SIM_I2C_BUS_QUEUE_SIZE];    /**< Completions held back >*/
+    sim_i2c_bus_stats_t     stats;                              /**< Counters >*/
+} sim_i2c_bus_t;
+
+// Signals for use in local context only
+enum
+{
+    LOCAL_SIM_I2C_BUS_DONE_SIG = MAX_SIG,   /**< Current transfer finished on the wire >*/
+};
+
+static sim_i2c_bus_t l_sim_i2c_bus;
+
+static QEvt const * sim_i2c_bus_que_sto[SIM_I2C_BUS_EVT_QUEUE_SIZE];
+
+// Stand in for the real I2C driver
+QActive * const i2c_comm_ao = &l_sim_i2c_bus.super;
+
+// state functions
+static QState sim_i2c_bus_initial   (sim_i2c_bus_t * const me, QEvt const * const e);
+static QState sim_i2c_bus_active    (sim_i2c_bus_t * const me, QEvt const * const e);
+
+// Private functions
+static void sim_i2c_bus_start_next(sim_i2c_bus_t * const me);
+
+static void sim_i2c_bus_finish(sim_i2c_bus_t * const me);
+
+static void sim_i2c_bus_apply(sim_i2c_bus_t * const me, i2c_comm_req_event_t const * const req, bool corrupt);
+
+static void sim_i2c_bus_post_complete(sim_i2c_bus_t * const me, QActive * const requestor, uint32_t id);
+
+static void sim_i2c_bus_post_error(sim_i2c_bus_t * const me, QActive * const requestor, uint32_t id,
+                                   int32_t error_code);
+
+static void sim_i2c_bus_post_delayed(sim_i2c_bus_t * const me, QActive * const requestor, uint32_t id);
+
+static void sim_i2c_bus_delayed_done(void * arg);
+
+static sim_time_t sim_i2c_bus_transfer_time(sim_i2c_bus_t const * const me,
+                                            i2c_comm_req_event_t const * const req);
+
+static void sim_i2c_bus_transfer_done(void * arg);
+
+/************************************************************************************/
+/***    START OF HSM                                                              ***/
+/************************************************************************************/
+
+/**
+*   @brief      Initial state as required by QP
+*/
+static QState sim_i2c_bus_initial(sim_i2c_bus_t * const me, QEvt const * const e)
+{
+    (void)e;    // avoid compiler warning
+
+    QS_OBJ_DICTIONARY(me);
+    QS_FUN_DICTIONARY(&sim_i2c_bus_initial);
+    QS_FUN_DICTIONARY(&sim_i2c_bus_active);
+
+    return Q_TRAN(&sim_i2c_bus_active);
+}
+
+/**
+*   @brief      Serve I2C requests on the virtual clock
+*/
+static QState sim_i2c_bus_active(sim_i2c_bus_t * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&QHsm_top);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            // The internal bus is always available
+            i2c_comm_status_event_t * stat_evt = Q_NEW(i2c_comm_status_event_t, I2C_BUS_STATUS_SIG);
+            stat_evt->status = BOTH_READY;
+            QF_PUBLISH((QEvt *)stat_evt, me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case I2C_COMM_REQUEST_SIG:
+        {
+            me->stats.requests++;
+
+            if (me->count >= SIM_I2C_BUS_QUEUE_SIZE)
+            {
+                // The requestor will see a lockup timeout, as with a wedged driver
+                me->stats.dropped++;
+            }
+            else
+            {
+                uint8_t tail = (uint8_t)((me->head + me->count) % SIM_I2C_BUS_QUEUE_SIZE);
+
+                me->pending[tail].req = *(i2c_comm_req_event_t const *)e;
+                me->count++;
+
+                if (!me->busy)
+                {
+                    sim_i2c_bus_start_next(me);
+                }
+            }
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_SIM_I2C_BUS_DONE_SIG:
+        {
+            sim_i2c_bus_finish(me);
+            sim_i2c_bus_start_next(me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+/************************************************************************************/
+/***    END OF HSM                                                                ***/
+/************************************************************************************/
+
+/**
+*   @brief      Put the oldest pending request on the bus
+*/
+static void sim_i2c_bus_start_next(sim_i2c_bus_t * const me)
+{
+    if (me->count == 0u)
+    {
+        me->busy = false;
+        return;
+    }
+
+    sim_time_t duration = sim_i2c_bus_transfer_time(me, &me->pending[me->head].req);
+
+    // A stuck-low bus delays the start until the line is released
+    if (me->stuck_until > sim_now())
+    {
+        duration += me->stuck_until - sim_now();
+    }
+
+    me->busy           = true;
+    me->transfer_start = sim_now();
+
+    Q_ALLEGE(sim_schedule_in(duration, &sim_i2c_bus_transfer_done, me));
+}
+
+/**
+*   @brief      End the transfer on the bus and answer it, as the fault engine decides
+*   @details    The request is removed from the queue first; the copy stays valid
+*               until the next request is accepted, which cannot happen before this
+*               returns.
+*/
+static void sim_i2c_bus_finish(sim_i2c_bus_t * const me)
+{
+    i2c_comm_req_event_t * const req = &me->pending[me->head].req;
+    QActive * const requestor        = Q_GET_REPLYABLE_REQUEST_REQUESTOR(req);
+    uint32_t const id                = Q_GET_REPLYABLE_REQUEST_ID(req);
+
+    me->stats.busy_us += sim_now() - me->transfer_start;
+    me->head = (uint8_t)((me->head + 1u) % SIM_I2C_BUS_QUEUE_SIZE);
+    me->count--;
+
+    sim_i2c_fault_t const fault = sim_i2c_faults_next();
+
+    switch (fault)
+    {
+        case SIM_I2C_FAULT_NAK:
+        {
+            sim_i2c_bus_post_error(me, requestor, id, E_NO_RESPONSE);
+            break;
+        }
+
+        case SIM_I2C_FAULT_ARBITRATION:
+        {
+            sim_i2c_bus_post_error(me, requestor, id, E_COMM_ERR);
+            break;
+        }
+
+        case SIM_I2C_FAULT_STUCK_LOW:
+        {
+            // Nothing moves on the bus until the line is released
+            me->stuck_until = sim_now() + sim_i2c_faults_get_stuck_us();
+            me->stats.lost++;
+            break;
+        }
+
+        case SIM_I2C_FAULT_TIMEOUT:
+        {
+            // The requestor will see a lockup timeout
+            me->stats.lost++;
+            break;
+        }
+
+        case SIM_I2C_FAULT_DELAYED:
+        {
+            sim_i2c_bus_apply(me, req, false);
+            sim_i2c_bus_post_delayed(me, requestor, id);
+            break;
+        }
+
+        case SIM_I2C_FAULT_DUPLICATE:
+        {
+            sim_i2c_bus_apply(me, req, false);
+            sim_i2c_bus_post_complete(me, requestor, id);
+            sim_i2c_bus_post_complete(me, requestor, id);
+            break;
+        }
+
+        default:
+        {
+            sim_i2c_bus_apply(me, req, (fault == SIM_I2C_FAULT_CORRUPT));
+            sim_i2c_bus_post_complete(me, requestor, id);
+            break;
+        }
+    }
+}
+
+/**
+*   @brief      Apply a transfer to the register file
+*   @param[in]  req         - the request
+*   @param[in]  corrupt     - flip one bit of the data read back
+*/
+static void sim_i2c_bus_apply(sim_i2c_bus_t * const me, i2c_comm_req_event_t const * const req, bool corrupt)
+{
+    for (uint8_t i = 0u; i < req->num_transactions; i++)
+    {
+        i2c_transaction_data_t const * const t = &req->transactions[i];
+
+        // Register addresses wrap around the register file, transfers stop at its end
+        uint32_t const reg = t->reg_addr % SIM_I2C_BUS_NUM_REGISTERS;
+
+        if ((t->send_data != NULL) && (t->send_data_len > 0u))
+        {
+            uint32_t len = t->send_data_len;
+
+            if ((reg + len) > SIM_I2C_BUS_NUM_REGISTERS)
+            {
+                len = SIM_I2C_BUS_NUM_REGISTERS - reg;
+            }
+            memcpy(&me->registers[reg], t->send_data, len);
+            me->stats.bytes += len;
+        }
+
+        if ((t->rec_data != NULL) && (t->rec_data_len > 0u))
+        {
+            uint32_t len = t->rec_data_len;
+
+            if ((reg + len) > SIM_I2C_BUS_NUM_REGISTERS)
+            {
+                len = SIM_I2C_BUS_NUM_REGISTERS - reg;
+            }
+            memcpy(t->rec_data, &me->registers[reg], len);
+            me->stats.bytes += len;
+
+            if (corrupt)
+            {
+                t->rec_data[sim_rand_range(0u, len - 1u)] ^= (uint8_t)(1u << sim_rand_range(0u, 7u));
+                corrupt = false;
+            }
+        }
+    }
+}
+
+/**
+*   @brief      Post a completion to the requestor
+*/
+static void sim_i2c_bus_post_complete(sim_i2c_bus_t * const me, QActive * const requestor, uint32_t id)
+{
+    i2c_comm_cmpt_event_t * rsp_evt = Q_NEW(i2c_comm_cmpt_event_t, I2C_COMM_COMPLETE_SIG);
+    QACTIVE_POST_REPLYABLE_RESPONSE(requestor, id, rsp_evt, me);
+
+    me->stats.completed++;
+}
+
+/**
+*   @brief      Post an error to the requestor
+*/
+static void sim_i2c_bus_post_error(sim_i2c_bus_t * const me, QActive * const requestor, uint32_t id,
+                                   int32_t error_code)
+{
+    i2c_comm_error_event_t * err_evt = Q_NEW(i2c_comm_error_event_t, I2C_COMM_ERROR_SIG);
+    err_evt->error_code = error_code;
+    QACTIVE_POST_REPLYABLE_RESPONSE(requestor, id, err_evt, me);
+
+    me->stats.errors++;
+}
+
+/**
+*   @brief      Post a completion later, while the bus goes on with the next transfer
+*   @details    Falls back to an immediate completion if every slot is taken.
+*/
+static void sim_i2c_bus_post_delayed(sim_i2c_bus_t * const me, QActive * const requestor, uint32_t id)
+{
+    for (uint8_t i = 0u; i < SIM_I2C_BUS_QUEUE_SIZE; i++)
+    {
+        sim_i2c_bus_reply_t * const reply = &me->delayed[i];
+
+        if (reply->requestor == NULL)
+        {
+            reply->requestor = requestor;
+            reply->id        = id;
+
+            if (sim_schedule_in(sim_i2c_faults_get_delay_us(), &sim_i2c_bus_delayed_done, reply))
+            {
+                return;
+            }
+
+            reply->requestor = NULL;
+            break;
+        }
+    }
+
+    sim_i2c_bus_post_complete(me, requestor, id);
+}
+
+/**
+*   @brief      Scheduler callback: deliver a delayed completion
+*/
+static void sim_i2c_bus_delayed_done(void * arg)
+{
+    sim_i2c_bus_reply_t * const reply = (sim_i2c_bus_reply_t *)arg;
+
+    sim_i2c_bus_post_complete(&l_sim_i2c_bus, reply->requestor, reply->id);
+    reply->requestor = NULL;
+}
+
+/**
+*   @brief      Time the request occupies the bus
+*   @details    Address and register bytes, a repeated start plus address for reads,
+*               the data bytes, framing, and the configured overhead and jitter.
+*/
+static sim_time_t sim_i2c_bus_transfer_time(sim_i2c_bus_t const * const me,
+                                            i2c_comm_req_event_t const * const req)
+{
+    uint64_t bits = 0u;
+
+    for (uint8_t i = 0u; i < req->num_transactions; i++)
+    {
+        i2c_transaction_data_t const * const t = &req->transactions[i];
+
+        bits += sim_i2c_bus_transaction_bits(t->reg_addr_md == I2C_USE_REG_ADDR, t->send_data_len, t->rec_data_len);
+    }
+
+    sim_time_t wire_us = (sim_time_t)(((bits * SIM_US_PER_SEC) + me->config.bus_hz - 1u) / me->config.bus_hz);
+
+    return wire_us + me->config.overhead_us + sim_rand_range(0u, me->config.jitter_us);
+}
+
+/**
+*   @brief      Scheduler callback: hand the end of the transfer back to the AO
+*/
+static void sim_i2c_bus_transfer_done(void * arg)
+{
+    sim_i2c_bus_t * const me = (sim_i2c_bus_t *)arg;
+
+    static QEvt const done_evt = {LOCAL_SIM_I2C_BUS_DONE_SIG, 0u, 0u};
+    QACTIVE_POST(&me->super, &done_evt, (void *)0);
+}
+
+/**
+*   @brief      Setup and start the bus model
+*   @param[in]  priority    - unique QP priority, must be above the drivers
+*   @param[in]  config      - bus model parameters, NULL for the defaults
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_i2c_bus_start(uint8_t priority, sim_i2c_bus_config_t const * const config)
+{
+    static sim_i2c_bus_config_t const default_config = SIM_I2C_BUS_DEFAULT_CONFIG;
+    sim_i2c_bus_t * const me = &l_sim_i2c_bus;
+
+    memset(me, 0, sizeof(*me));
+    me->config = (config != NULL) ? *config : default_config;
+
+    sim_i2c_faults_init(&me->config.faults);
+
+    QActive_ctor(&me->super, (QStateHandler)&sim_i2c_bus_initial);
+
+    QACTIVE_START(&me->super,
+                  priority,
+                  sim_i2c_bus_que_sto,
+                  Q_DIM(sim_i2c_bus_que_sto),
+                  (void *)0,
+                  0U,
+                  (QEvt *)0);
+}
+
+/**
+*   @brief      Direct access to the simulated register file, for scenario setup
+*/
+uint8_t * sim_i2c_bus_get_registers(void)
+{
+    return l_sim_i2c_bus.registers;
+}
+
+/**
+*   @brief      Bus model counters
+*/
+sim_i2c_bus_stats_t const * sim_i2c_bus_get_stats(void)
+{
+    return &l_sim_i2c_bus.stats;
+}
+
+/**
+*   @brief      Inject a fault into the first transfer finishing at or after a time
+*   @details    Call after sim_i2c_bus_start(), which resets the fault engine.
+*/
+bool sim_i2c_bus_script_fault(sim_time_t at, sim_i2c_fault_t fault)
+{
+    return sim_i2c_faults_script(at, fault);
+}
+
+/**
+*   @brief      Bit times one transaction occupies the wire
+*   @details    Framing and address, the register byte, a repeated start plus
+*               address for the read phase, and the data bytes.
+*   @param[in]  reg_addr    - a register address byte is sent
+*   @param[in]  send_len    - bytes written
+*   @param[in]  rec_len     - bytes read
+*   @return     uint32_t    - bit times
+*/
+uint32_t sim_i2c_bus_transaction_bits(bool reg_addr, uint32_t send_len, uint32_t rec_len)
+{
+    uint32_t bits = SIM_I2C_BUS_FRAMING_BITS + SIM_I2C_BUS_BITS_PER_BYTE;
+
+    if (reg_addr)
+    {
+        bits += SIM_I2C_BUS_BITS_PER_BYTE;
+    }
+    if (rec_len > 0u)
+    {
+        // Repeated start and address for the read phase
+        bits += 1u + SIM_I2C_BUS_BITS_PER_BYTE;
+    }
+
+    return bits + (SIM_I2C_BUS_BITS_PER_BYTE * (send_len + rec_len));
+}
+
+/**
+*   @brief      Clock a stuck-low bus free, DEVICE_LEVEL_BUS_RECOVER of the host build
+*   @details    The device lets go of the bus after the recovery pulses instead of
+*               at the end of its stuck time. Transfers already on the bus keep
+*               the delay they started with.
+*/
+void sim_i2c_bus_recover(void)
+{
+    sim_i2c_bus_t * const me = &l_sim_i2c_bus;
+    sim_time_t const release = sim_now() + (((SIM_I2C_BUS_RECOVER_BITS * SIM_US_PER_SEC) + me->config.bus_hz - 1u)
+                                            / me->config.bus_hz);
+
+    if (me->stuck_until > release)
+    {
+        me->stuck_until = release;
+        me->stats.recoveries++;
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file        sim_i2c_bus.h
+ * @brief       Simulated I2C bus AO standing in for i2c_comm_ao on the host
+ * @details     Defines the i2c_comm_ao symbol, so linking this module instead of
+ *              the real I2C driver is all a host build needs to do. Requests are
+ *              served one at a time, in arrival order. Each transfer takes the
+ *              time the bytes need on the wire at the configured bus speed, plus a
+ *              fixed per-transaction overhead. The device itself is modelled as a
+ *              256 byte register file. Faults are injected through the
+ *              profile in the configuration and sim_i2c_bus_script_fault().
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_I2C_BUS_H
+#define SIM_I2C_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qpc.h"
+#include "sim.h"
+#include "sim_i2c_faults.h"
+
+#define SIM_I2C_BUS_NUM_REGISTERS       256u
+
+// Requests waiting for the bus
+#define SIM_I2C_BUS_QUEUE_SIZE          8u
+
+/*! @struct sim_i2c_bus_config_t
+*   @brief  Bus model parameters
+*/
+typedef struct
+{
+    uint32_t                bus_hz;                             /**< SCL frequency >*/
+    uint32_t                overhead_us;                        /**< Fixed cost per transaction (driver, ISR) >*/
+    uint32_t                jitter_us;                          /**< Uniform random extra latency, 0 to disable >*/
+    sim_i2c_fault_profile_t faults;                             /**< Random fault rates >*/
+} sim_i2c_bus_config_t;
+
+/*! @struct sim_i2c_bus_stats_t
+*   @brief  Bus model counters
+*/
+typedef struct
+{
+    uint32_t                requests;                           /**< Requests received >*/
+    uint32_t                completed;                          /**< Completions posted >*/
+    uint32_t                dropped;                            /**< Requests dropped, queue full >*/
+    uint32_t                errors;                             /**< Error responses posted >*/
+    uint32_t                lost;                               /**< Transfers left unanswered >*/
+    uint32_t                recoveries;                         /**< Stuck-low bus clocked free >*/
+    uint64_t                bytes;                              /**< Data bytes transferred >*/
+    sim_time_t              busy_us;                            /**< Time the bus was driven >*/
+} sim_i2c_bus_stats_t;
+
+// Default configuration: 400kHz fast mode, 50us driver overhead, no jitter, no faults
+#define SIM_I2C_BUS_DEFAULT_CONFIG      { .bus_hz = 400000u, .overhead_us = 50u, .jitter_us = 0u }
+
+void sim_i2c_bus_start(uint8_t priority, sim_i2c_bus_config_t const * const config);
+
+uint8_t * sim_i2c_bus_get_registers(void);
+
+sim_i2c_bus_stats_t const * sim_i2c_bus_get_stats(void);
+
+bool sim_i2c_bus_script_fault(sim_time_t at, sim_i2c_fault_t fault);
+
+uint32_t sim_i2c_bus_transaction_bits(bool reg_addr, uint32_t send_len, uint32_t rec_len);
+
+void sim_i2c_bus_recover(void);
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file        sim_i2c_faults.c
+ * @brief       Fault injection engine for the simulated I2C bus
+ * @details     Profile faults are drawn in a fixed order, one random number per
+ *              non-zero rate, so adding a rate to a profile does not disturb the
+ *              draws of the others.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "sim.h"
+#include "sim_i2c_faults.h"
+
+/*! @struct sim_i2c_faults_scripted_t
+*   @brief  A fault waiting for its time
+*/
+typedef struct
+{
+    sim_time_t              at;                                 /**< Virtual time it becomes due >*/
+    sim_i2c_fault_t         fault;                              /**< What to inject >*/
+} sim_i2c_faults_scripted_t;
+
+/*! @struct sim_i2c_faults_engine_t
+*   @brief  Engine state
+*/
+typedef struct
+{
+    sim_i2c_fault_profile_t     profile;                        /**< Random rates and parameters >*/
+    uint32_t                    n_scripted;                     /**< Pending scripted faults >*/
+    sim_i2c_faults_scripted_t   script[SIM_I2C_FAULTS_SCRIPT_SIZE]; /**< Pending, sorted by time >*/
+    uint32_t                    injected[SIM_I2C_FAULT_COUNT];  /**< Faults injected per kind >*/
+} sim_i2c_faults_engine_t;
+
+static sim_i2c_faults_engine_t l_sim_i2c_faults;
+
+static char const * const l_sim_i2c_fault_names[SIM_I2C_FAULT_COUNT] =
+{
+    [SIM_I2C_FAULT_NONE]        = "none",
+    [SIM_I2C_FAULT_NAK]         = "nak",
+    [SIM_I2C_FAULT_TIMEOUT]     = "timeout",
+    [SIM_I2C_FAULT_ARBITRATION] = "arbitration",
+    [SIM_I2C_FAULT_STUCK_LOW]   = "stuck_low",
+    [SIM_I2C_FAULT_CORRUPT]     = "corrupt",
+    [SIM_I2C_FAULT_DELAYED]     = "delayed",
+    [SIM_I2C_FAULT_DUPLICATE]   = "duplicate",
+};
+
+/**
+*   @brief      Reset the engine
+*   @param[in]  profile     - random fault rates, NULL for a fault-free bus
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_i2c_faults_init(sim_i2c_fault_profile_t const * const profile)
+{
+    memset(&l_sim_i2c_faults, 0, sizeof(l_sim_i2c_faults));
+
+    if (profile != NULL)
+    {
+        l_sim_i2c_faults.profile = *profile;
+    }
+
+    if (l_sim_i2c_faults.profile.stuck_us == 0u)
+    {
+        l_sim_i2c_faults.profile.stuck_us = SIM_I2C_FAULTS_DEFAULT_STUCK_US;
+    }
+    if (l_sim_i2c_faults.profile.delay_us == 0u)
+    {
+        l_sim_i2c_faults.profile.delay_us = SIM_I2C_FAULTS_DEFAULT_DELAY_US;
+    }
+}
+
+/**
+*   @brief      Inject a fault into the first transfer finishing at or after a time
+*   @param[in]  at          - virtual time in microseconds
+*   @param[in]  fault       - fault to inject
+*   @param[out] nothing
+*   @return     bool        - false if the script is full
+*/
+bool sim_i2c_faults_script(sim_time_t at, sim_i2c_fault_t fault)
+{
+    sim_i2c_faults_engine_t * const me = &l_sim_i2c_faults;
+
+    if ((me->n_scripted >= SIM_I2C_FAULTS_SCRIPT_SIZE) || (fault == SIM_I2C_FAULT_NONE) ||
+        (fault >= SIM_I2C_FAULT_COUNT))
+    {
+        return false;
+    }
+
+    // Insertion sort, equal times keep their scripting order
+    uint32_t i = me->n_scripted++;
+    while ((i > 0u) && (me->script[i - 1u].at > at))
+    {
+        me->script[i] = me->script[i - 1u];
+        i--;
+    }
+    me->script[i].at    = at;
+    me->script[i].fault = fault;
+
+    return true;
+}
+
+/**
+*   @brief      Decide the fate of the transfer finishing now
+*   @return     sim_i2c_fault_t - fault to inject, SIM_I2C_FAULT_NONE for a clean transfer
+*/
+sim_i2c_fault_t sim_i2c_faults_next(void)
+{
+    sim_i2c_faults_engine_t * const me = &l_sim_i2c_faults;
+    sim_i2c_fault_t fault = SIM_I2C_FAULT_NONE;
+
+    for (uint32_t f = SIM_I2C_FAULT_NONE + 1u; f < SIM_I2C_FAULT_COUNT; f++)
+    {
+        if (me->profile.per_million[f] > 0u)
+        {
+            bool const hit = sim_rand_chance(me->profile.per_million[f]);
+
+            if (hit && (fault == SIM_I2C_FAULT_NONE))
+            {
+                fault = (sim_i2c_fault_t)f;
+            }
+        }
+    }
+
+    if ((me->n_scripted > 0u) && (me->script[0].at <= sim_now()))
+    {
+        fault = me->script[0].fault;
+
+        me->n_scripted--;
+        memmove(&me->script[0], &me->script[1], me->n_scripted * sizeof(me->script[0]));
+    }
+
+    me->injected[fault]++;
+
+    return fault;
+}
+
+/**
+*   @brief      How long a stuck-low fault holds the bus
+*/
+sim_time_t sim_i2c_faults_get_stuck_us(void)
+{
+    return l_sim_i2c_faults.profile.stuck_us;
+}
+
+/**
+*   @brief      How late a delayed completion arrives
+*/
+sim_time_t sim_i2c_faults_get_delay_us(void)
+{
+    return l_sim_i2c_faults.profile.delay_us;
+}
+
+/**
+*   @brief      Number of transfers that got a given fault
+*/
+uint32_t sim_i2c_faults_get_injected(sim_i2c_fault_t fault)
+{
+    return (fault < SIM_I2C_FAULT_COUNT) ? l_sim_i2c_faults.injected[fault] : 0u;
+}
+
+/**
+*   @brief      Short name of a fault kind, for reports
+*/
+char const * sim_i2c_faults_get_name(sim_i2c_fault_t fault)
+{
+    return (fault < SIM_I2C_FAULT_COUNT) ? l_sim_i2c_fault_names[fault] : "?";
+}
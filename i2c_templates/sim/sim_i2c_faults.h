@@ -0,0 +1,89 @@
+/**
+ * @file        sim_i2c_faults.h
+ * @brief       Fault injection engine for the simulated I2C bus
+ * @details     Decides, for every transfer the bus model finishes, whether it
+ *              goes wrong and how. Faults come from two sources:
+ *
+ *              - a profile of probabilities, one per fault kind, drawn from the
+ *                seeded sim generator so runs stay reproducible
+ *              - a script of faults at given virtual times; a scripted fault hits
+ *                the first transfer finishing at or after its time and takes
+ *                precedence over the profile
+ *
+ *              Fault kinds and what the requestor sees:
+ *
+ *              NAK             -   I2C_COMM_ERROR_SIG with E_NO_RESPONSE
+ *              TIMEOUT         -   no answer, the requestor's lockup timer fires
+ *              ARBITRATION     -   I2C_COMM_ERROR_SIG with E_COMM_ERR
+ *              STUCK_LOW       -   no answer, and the bus stays unusable for
+ *                                  stuck_us; queued transfers wait for it
+ *              CORRUPT         -   normal completion, one bit of the read data
+ *                                  flipped
+ *              DELAYED         -   normal completion, posted delay_us late while
+ *                                  the bus serves the next transfer
+ *              DUPLICATE       -   normal completion, posted twice
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_I2C_FAULTS_H
+#define SIM_I2C_FAULTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim.h"
+
+// Scripted faults that can be pending at once
+#ifndef SIM_I2C_FAULTS_SCRIPT_SIZE
+#define SIM_I2C_FAULTS_SCRIPT_SIZE      16u
+#endif
+
+// Fault kinds
+typedef enum
+{
+    SIM_I2C_FAULT_NONE          = 0,
+    SIM_I2C_FAULT_NAK,
+    SIM_I2C_FAULT_TIMEOUT,
+    SIM_I2C_FAULT_ARBITRATION,
+    SIM_I2C_FAULT_STUCK_LOW,
+    SIM_I2C_FAULT_CORRUPT,
+    SIM_I2C_FAULT_DELAYED,
+    SIM_I2C_FAULT_DUPLICATE,
+
+    SIM_I2C_FAULT_COUNT,
+} sim_i2c_fault_t;
+
+/*! @struct sim_i2c_fault_profile_t
+*   @brief  Random fault rates and fault parameters
+*/
+typedef struct
+{
+    uint32_t                per_million[SIM_I2C_FAULT_COUNT];   /**< Probability per transfer, NONE is ignored >*/
+    uint32_t                stuck_us;                           /**< How long a stuck-low bus stays stuck >*/
+    uint32_t                delay_us;                           /**< Extra latency of a delayed completion >*/
+} sim_i2c_fault_profile_t;
+
+// Parameters used when a profile leaves them at zero
+#define SIM_I2C_FAULTS_DEFAULT_STUCK_US     (10u * SIM_US_PER_MS)
+#define SIM_I2C_FAULTS_DEFAULT_DELAY_US     (5u * SIM_US_PER_MS)
+
+void sim_i2c_faults_init(sim_i2c_fault_profile_t const * const profile);
+
+bool sim_i2c_faults_script(sim_time_t at, sim_i2c_fault_t fault);
+
+sim_i2c_fault_t sim_i2c_faults_next(void);
+
+sim_time_t sim_i2c_faults_get_stuck_us(void);
+
+sim_time_t sim_i2c_faults_get_delay_us(void);
+
+uint32_t sim_i2c_faults_get_injected(sim_i2c_fault_t fault);
+
+char const * sim_i2c_faults_get_name(sim_i2c_fault_t fault);
+
+#endif
@@ -0,0 +1,460 @@
+/**
+ * @file        sim_load.c
+ * @brief       Synthetic load generator for device_level on the simulated bus
+ * @details     The load AO has a single state:
+ *
+ *              sim_load_initial        -   The initial state as required by QP
+ *              sim_load_active         -   Issues arrived requests one at a time and
+ *                                          supervises device_level
+ *
+ *              Open loop arrivals are chained through the sim scheduler, one
+ *              callback at a time.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "qpc.h"
+#include "common.h"
+#include "events.h"
+#include "signals.h"
+#include "replyables.h"
+#include "whoop_i2c.h"
+#include "whoop_qp_time.h"
+#include "device_level.h"
+
+#include "sim.h"
+#include "sim_i2c_bus.h"
+#include "sim_load.h"
+
+Q_DEFINE_THIS_FILE
+
+#define SIM_LOAD_QUEUE_SIZE             8u
+
+/*! @struct sim_load_t
+*   @brief  Active Object structure
+*/
+typedef struct
+{
+    QActive                 super;
+    QTimeEvt                watchdog;                           /**< Supervisor timeout on the outstanding request >*/
+    sim_load_config_t       config;                             /**< Workload >*/
+    sim_time_t *            arrivals;                           /**< Arrival time per request >*/
+    sim_time_t *            latencies;                          /**< Latency per answered request >*/
+    sim_time_t *            recoveries;                         /**< Recovery latency per run of failures >*/
+    uint32_t                n_recoveries;                       /**< Samples in recoveries >*/
+    bool                    failing;                            /**< The last request failed >*/
+    sim_time_t              failing_since;                      /**< Virtual time of the first failure >*/
+    uint32_t                n_arrived;                          /**< Requests that have arrived >*/
+    bool                    ready;                              /**< device_level reported ready >*/
+    bool                    in_flight;                          /**< A request is outstanding >*/
+    bool                    started;                            /**< First ready report seen >*/
+    uint32_t                request_id;                         /**< Replyable request ID >*/
+    uint16_t                length;                             /**< Length of the outstanding request >*/
+    sim_time_t              enabled_at;                         /**< Virtual time of the first enable >*/
+    uint64_t                enabled_dispatches;                 /**< Dispatch count at the first enable >*/
+    sim_time_t              first_arrival;                      /**< Virtual time of the first arrival >*/
+    uint64_t                first_dispatches;                   /**< Dispatch count at the first arrival >*/
+    sim_time_t              last_answer;                        /**< Virtual time of the last answer >*/
+    uint64_t                last_dispatches;                    /**< Dispatch count at the last answer >*/
+    sim_load_report_t       report;                             /**< Counters >*/
+    uint8_t                 buffer[SIM_I2C_BUS_NUM_REGISTERS];  /**< Data for the requests >*/
+} sim_load_t;
+
+// Signals for use in local context only
+enum
+{
+    LOCAL_SIM_LOAD_ARRIVAL_SIG = MAX_SIG,   /**< The next request arrived >*/
+    LOCAL_SIM_LOAD_WATCHDOG_SIG,            /**< The outstanding request got no answer >*/
+    LOCAL_SIM_LOAD_RESUME_SIG,              /**< Carry on after a failed request >*/
+};
+
+static sim_load_t l_sim_load;
+
+static QEvt const * sim_load_que_sto[SIM_LOAD_QUEUE_SIZE];
+
+// state functions
+static QState sim_load_initial      (sim_load_t * const me, QEvt const * const e);
+static QState sim_load_active       (sim_load_t * const me, QEvt const * const e);
+
+// Private functions
+static void sim_load_arrival(void * arg);
+
+static void sim_load_issue(sim_load_t * const me);
+
+static void sim_load_answered(sim_load_t * const me, bool ok);
+
+static void sim_load_restart_device_level(sim_load_t * const me, bool disable_first);
+
+static void sim_load_failed(sim_load_t * const me);
+
+/************************************************************************************/
+/***    START OF HSM                                                              ***/
+/************************************************************************************/
+
+/**
+*   @brief      Initial state as required by QP
+*/
+static QState sim_load_initial(sim_load_t * const me, QEvt const * const e)
+{
+    (void)e;    // avoid compiler warning
+
+    QS_OBJ_DICTIONARY(me);
+    QS_FUN_DICTIONARY(&sim_load_initial);
+    QS_FUN_DICTIONARY(&sim_load_active);
+
+    QActive_subscribe(&me->super, DEVICE_LEVEL_READY_REPORT_SIG);
+    QActive_subscribe(&me->super, DEVICE_LEVEL_ERROR_REPORT_SIG);
+
+    return Q_TRAN(&sim_load_active);
+}
+
+/**
+*   @brief      Generate the workload and supervise device_level
+*/
+static QState sim_load_active(sim_load_t * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&QHsm_top);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            me->enabled_at         = sim_now();
+            me->enabled_dispatches = sim_get_stats()->dispatches;
+
+            sim_load_restart_device_level(me, false);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_READY_REPORT_SIG:
+        {
+            me->ready = true;
+
+            if (!me->started)
+            {
+                me->started                   = true;
+                me->report.startup_us         = sim_now() - me->enabled_at;
+                me->report.startup_dispatches = sim_get_stats()->dispatches - me->enabled_dispatches;
+                me->first_arrival             = sim_now();
+                me->first_dispatches          = sim_get_stats()->dispatches;
+
+                if (me->config.interval_us == 0u)
+                {
+                    // Closed loop: every request is ready to go, latency counts from issue
+                    me->n_arrived = me->config.n_requests;
+                }
+                else
+                {
+                    sim_load_arrival(me);
+                }
+            }
+
+            sim_load_issue(me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_SIM_LOAD_ARRIVAL_SIG:
+        {
+            me->arrivals[me->n_arrived++] = sim_now();
+
+            if (me->n_arrived < me->config.n_requests)
+            {
+                uint32_t const gap = sim_rand_range(me->config.interval_us / 2u,
+                                                    me->config.interval_us + (me->config.interval_us / 2u));
+                Q_ALLEGE(sim_schedule_in(gap, &sim_load_arrival, me));
+            }
+
+            sim_load_issue(me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_RESPONSE_SIG:
+        {
+            device_level_response_event_t * p_evt = (device_level_response_event_t *)e;
+
+            if (me->in_flight && Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->request_id))
+            {
+                sim_load_answered(me, true);
+                sim_load_issue(me);
+            }
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_ERROR_RESPONSE_SIG:
+        {
+            device_level_error_response_event_t * p_evt = (device_level_error_response_event_t *)e;
+
+            if (me->in_flight && Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->request_id))
+            {
+                sim_load_answered(me, false);
+
+                // An error report may be queued behind this one, check for it first
+                static QEvt const resume_evt = {LOCAL_SIM_LOAD_RESUME_SIG, 0u, 0u};
+                QACTIVE_POST(&me->super, &resume_evt, me);
+            }
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_SIM_LOAD_RESUME_SIG:
+        {
+            sim_load_issue(me);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_ERROR_REPORT_SIG:
+        {
+            if (me->in_flight)
+            {
+                sim_load_answered(me, false);
+            }
+
+            me->report.recoveries++;
+            sim_load_restart_device_level(me, false);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_SIM_LOAD_WATCHDOG_SIG:
+        {
+            if (me->in_flight)
+            {
+                // Give up on the request and restart the driver from scratch
+                sim_load_failed(me);
+                me->in_flight = false;
+                me->report.lost++;
+                me->report.recoveries++;
+
+                sim_load_restart_device_level(me, true);
+            }
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+/************************************************************************************/
+/***    END OF HSM                                                                ***/
+/************************************************************************************/
+
+/**
+*   @brief      Scheduler callback: hand the arrival to the AO
+*/
+static void sim_load_arrival(void * arg)
+{
+    sim_load_t * const me = (sim_load_t *)arg;
+
+    static QEvt const arrival_evt = {LOCAL_SIM_LOAD_ARRIVAL_SIG, 0u, 0u};
+    QACTIVE_POST(&me->super, &arrival_evt, (void *)0);
+}
+
+/**
+*   @brief      Send the oldest arrived request to device_level, if it can take it
+*/
+static void sim_load_issue(sim_load_t * const me)
+{
+    if (!me->ready || me->in_flight || (me->report.issued >= me->n_arrived))
+    {
+        return;
+    }
+
+    if (me->config.interval_us == 0u)
+    {
+        me->arrivals[me->report.issued] = sim_now();
+    }
+
+    bool const read                 = sim_rand_chance(me->config.read_percent * 10000u);
+    device_level_register_t reg     = (device_level_register_t)sim_rand_range(0u, me->config.n_registers - 1u);
+
+    me->length     = (uint16_t)sim_rand_range(me->config.min_length, me->config.max_length);
+    me->in_flight  = true;
+    me->request_id++;
+    me->report.issued++;
+
+    whoop_qp_time_safe_arm(&me->watchdog, MS_TO_TICKS(me->config.watchdog_ms), 0u);
+
+    if (read)
+    {
+        device_level_read_request_event_t * req = Q_NEW(device_level_read_request_event_t, DEVICE_LEVEL_READ_SIG);
+        req->buffer.address = reg;
+        req->buffer.p_data  = me->buffer;
+        req->buffer.length  = me->length;
+        QACTIVE_POST_REPLYABLE_REQUEST(g_ao_device_level, me->request_id, req, me);
+    }
+    else
+    {
+        device_level_write_request_event_t * req = Q_NEW(device_level_write_request_event_t, DEVICE_LEVEL_WRITE_SIG);
+        req->buffer.address = reg;
+        req->buffer.p_data  = me->buffer;
+        req->buffer.length  = me->length;
+        QACTIVE_POST_REPLYABLE_REQUEST(g_ao_device_level, me->request_id, req, me);
+    }
+}
+
+/**
+*   @brief      Close the outstanding request
+*/
+static void sim_load_answered(sim_load_t * const me, bool ok)
+{
+    QTimeEvt_disarm(&me->watchdog);
+
+    if (ok)
+    {
+        me->latencies[me->report.completed++] = sim_now() - me->arrivals[me->report.issued - 1u];
+        me->report.bytes += me->length;
+
+        if (me->failing)
+        {
+            me->recoveries[me->n_recoveries++] = sim_now() - me->failing_since;
+            me->failing = false;
+        }
+    }
+    else
+    {
+        sim_load_failed(me);
+        me->report.failed++;
+    }
+
+    me->in_flight       = false;
+    me->last_answer     = sim_now();
+    me->last_dispatches = sim_get_stats()->dispatches;
+}
+
+/**
+*   @brief      Start timing a recovery, unless one is already running
+*/
+static void sim_load_failed(sim_load_t * const me)
+{
+    if (!me->failing)
+    {
+        me->failing       = true;
+        me->failing_since = sim_now();
+    }
+}
+
+/**
+*   @brief      Enable device_level, optionally after forcing it to disabled
+*/
+static void sim_load_restart_device_level(sim_load_t * const me, bool disable_first)
+{
+    me->ready = false;
+
+    if (disable_first)
+    {
+        static QEvt const disable_evt = {DEVICE_LEVEL_DISABLE_SIG, 0u, 0u};
+        QACTIVE_POST(g_ao_device_level, &disable_evt, me);
+    }
+
+    static QEvt const enable_evt = {DEVICE_LEVEL_ENABLE_SIG, 0u, 0u};
+    QACTIVE_POST(g_ao_device_level, &enable_evt, me);
+}
+
+/**
+*   @brief      Setup and start the load generator
+*   @details    Call after sim_system_start().
+*   @param[in]  priority    - unique QP priority, below device_level
+*   @param[in]  config      - workload parameters
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_load_start(uint8_t priority, sim_load_config_t const * const config)
+{
+    sim_load_t * const me = &l_sim_load;
+    uint32_t const n = (config->n_requests > 0u) ? config->n_requests : 1u;
+
+    free(me->arrivals);
+    free(me->latencies);
+    free(me->recoveries);
+    memset(me, 0, sizeof(*me));
+
+    me->config     = *config;
+    me->arrivals   = calloc(n, sizeof(sim_time_t));
+    me->latencies  = calloc(n, sizeof(sim_time_t));
+    me->recoveries = calloc(n, sizeof(sim_time_t));
+    Q_ASSERT((me->arrivals != NULL) && (me->latencies != NULL) && (me->recoveries != NULL));
+    Q_ASSERT((config->n_registers > 0u) && (config->max_length <= SIM_I2C_BUS_NUM_REGISTERS));
+
+    QActive_ctor(&me->super, (QStateHandler)&sim_load_initial);
+    QTimeEvt_ctorX(&me->watchdog, &me->super, LOCAL_SIM_LOAD_WATCHDOG_SIG, 0U);
+
+    QACTIVE_START(&me->super,
+                  priority,
+                  sim_load_que_sto,
+                  Q_DIM(sim_load_que_sto),
+                  (void *)0,
+                  0U,
+                  (QEvt *)0);
+}
+
+/**
+*   @brief      True once every request has been answered, failed or abandoned
+*/
+bool sim_load_is_done(void)
+{
+    return l_sim_load.started && !l_sim_load.in_flight &&
+           (l_sim_load.report.issued >= l_sim_load.config.n_requests);
+}
+
+/**
+*   @brief      Snapshot of the run so far
+*/
+void sim_load_get_report(sim_load_report_t * const report)
+{
+    sim_load_t * const me = &l_sim_load;
+    sim_time_t * samples = malloc(((me->config.n_requests > 0u) ? me->config.n_requests : 1u) * sizeof(sim_time_t));
+
+    Q_ASSERT(samples != NULL);
+
+    *report = me->report;
+
+    if (me->last_answer > me->first_arrival)
+    {
+        report->elapsed_us = me->last_answer - me->first_arrival;
+        report->dispatches = me->last_dispatches - me->first_dispatches;
+    }
+
+    for (uint32_t i = 0u; i < me->report.completed; i++)
+    {
+        uint32_t bin = 0u;
+
+        while (((me->latencies[i] >> (bin + 1u)) != 0u) && (bin < (SIM_LOAD_HIST_BINS - 1u)))
+        {
+            bin++;
+        }
+        report->histogram[bin]++;
+    }
+
+    // Summarize a copy, the run may go on
+    memcpy(samples, me->latencies, me->report.completed * sizeof(sim_time_t));
+    sim_latency_summarize(samples, me->report.completed, &report->latency);
+
+    memcpy(samples, me->recoveries, me->n_recoveries * sizeof(sim_time_t));
+    sim_latency_summarize(samples, me->n_recoveries, &report->recovery);
+
+    free(samples);
+}
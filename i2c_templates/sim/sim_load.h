@@ -0,0 +1,77 @@
+/**
+ * @file        sim_load.h
+ * @brief       Synthetic load generator for device_level on the simulated bus
+ * @details     The load AO plays the upper layer driver and the supervisor. It
+ *              enables device_level, then issues a random mix of reads and writes,
+ *              one at a time, either back to back (closed loop) or as they arrive
+ *              at a jittered interval (open loop). Requests that arrive while one
+ *              is outstanding wait in arrival order.
+ *
+ *              As the supervisor it re-enables device_level after an error report,
+ *              and disables and re-enables it when a request gets no answer within
+ *              the watchdog time.
+ *
+ *              Latency is measured from arrival to the DEVICE_LEVEL_RESPONSE_SIG.
+ *              Recovery latency is measured from the first failed or abandoned
+ *              request of a run of failures to the next answered request.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_LOAD_H
+#define SIM_LOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim.h"
+
+// Latency histogram bins: bin n counts latencies in [2^n, 2^(n+1)) us, bin 0 also
+// counts zero. Histograms of separate runs add up.
+#define SIM_LOAD_HIST_BINS              32u
+
+/*! @struct sim_load_config_t
+*   @brief  Workload parameters
+*/
+typedef struct
+{
+    uint32_t                n_requests;                         /**< Requests to issue >*/
+    uint32_t                read_percent;                       /**< Share of reads, 0 to 100 >*/
+    uint16_t                min_length;                         /**< Shortest transfer, bytes >*/
+    uint16_t                max_length;                         /**< Longest transfer, bytes >*/
+    uint16_t                n_registers;                        /**< Registers addressed, from 0 >*/
+    uint32_t                interval_us;                        /**< Mean time between arrivals, 0 for closed loop >*/
+    uint32_t                watchdog_ms;                        /**< Supervisor timeout per request >*/
+} sim_load_config_t;
+
+/*! @struct sim_load_report_t
+*   @brief  Outcome of a run
+*/
+typedef struct
+{
+    uint32_t                issued;                             /**< Requests sent to device_level >*/
+    uint32_t                completed;                          /**< Requests answered >*/
+    uint32_t                failed;                             /**< Requests that ended in an error >*/
+    uint32_t                lost;                               /**< Requests abandoned by the watchdog >*/
+    uint32_t                recoveries;                         /**< Times device_level was restarted >*/
+    uint64_t                bytes;                              /**< Data bytes of the answered requests >*/
+    sim_time_t              startup_us;                         /**< Enable to the first ready report >*/
+    uint64_t                startup_dispatches;                 /**< Dispatches during startup >*/
+    sim_time_t              elapsed_us;                         /**< First arrival to the last answer >*/
+    uint64_t                dispatches;                         /**< Dispatches over elapsed_us >*/
+    sim_latency_t           latency;                            /**< Latency of the answered requests >*/
+    sim_latency_t           recovery;                           /**< First failure to the next answered request >*/
+    uint32_t                histogram[SIM_LOAD_HIST_BINS];      /**< Latency of the answered requests >*/
+} sim_load_report_t;
+
+void sim_load_start(uint8_t priority, sim_load_config_t const * const config);
+
+bool sim_load_is_done(void);
+
+void sim_load_get_report(sim_load_report_t * const report);
+
+#endif
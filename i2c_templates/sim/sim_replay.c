@@ -0,0 +1,539 @@
+/**
+ * @file        sim_replay.c
+ * @brief       Replay an I2C capture against device_level on the simulated bus
+ * @details     The replay AO has a single state:
+ *
+ *              sim_replay_initial      -   The initial state as required by QP
+ *              sim_replay_active       -   Issues due requests one at a time and
+ *                                          collects the responses
+ *
+ *              Requests fall due through the sim scheduler, one callback at a
+ *              time, so captures of any length fit in a fixed size scheduler.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "qpc.h"
+#include "common.h"
+#include "events.h"
+#include "signals.h"
+#include "replyables.h"
+#include "whoop_i2c.h"
+#include "device_level.h"
+
+#include "sim.h"
+#include "sim_replay.h"
+
+Q_DEFINE_THIS_FILE
+
+#define SIM_REPLAY_QUEUE_SIZE           8u
+
+// Largest register range a replayed request can touch
+#define SIM_REPLAY_BUFFER_SIZE          256u
+
+/*! @struct sim_replay_item_t
+*   @brief  One request extracted from the capture
+*/
+typedef struct
+{
+    sim_time_t              offset;                             /**< Time since the first request, us >*/
+    sim_time_t              recorded_latency;                   /**< Request to last answer in the capture, us >*/
+    bool                    recorded_answered;                  /**< The capture holds an answer >*/
+    uint16_t                seq;                                /**< Driver transaction number >*/
+    uint8_t                 operation;                          /**< i2c_ops_t >*/
+    uint16_t                reg;                                /**< Register address >*/
+    uint16_t                length;                             /**< Data length >*/
+    sim_time_t              due;                                /**< Virtual time it fell due during replay >*/
+} sim_replay_item_t;
+
+/*! @struct sim_replay_t
+*   @brief  Active Object structure
+*/
+typedef struct
+{
+    QActive                 super;
+    sim_replay_item_t *     items;                              /**< Workload >*/
+    uint32_t                n_items;                            /**< Number of requests >*/
+    uint32_t                speed_percent;                      /**< Time compression, see SIM_REPLAY_SPEED_* >*/
+    uint32_t                next_due;                           /**< First item not yet due >*/
+    uint32_t                next_issue;                         /**< First item not yet issued >*/
+    bool                    ready;                              /**< device_level reported ready >*/
+    bool                    in_flight;                          /**< A request is outstanding >*/
+    uint32_t                request_id;                         /**< Replyable request ID >*/
+    sim_time_t              recorded_span;                      /**< First request to last answer in the capture, us >*/
+    sim_time_t              start;                              /**< Virtual time the replay started >*/
+    sim_time_t              end;                                /**< Virtual time of the last answer >*/
+    sim_time_t *            latencies;                          /**< Replayed latency per answered request >*/
+    uint32_t                completed;
+    uint32_t                failed;
+    uint32_t                recoveries;
+    uint8_t                 buffer[SIM_REPLAY_BUFFER_SIZE];     /**< Data for replayed requests >*/
+} sim_replay_t;
+
+// Signals for use in local context only
+enum
+{
+    LOCAL_SIM_REPLAY_DUE_SIG = MAX_SIG,     /**< The next capture request fell due >*/
+    LOCAL_SIM_REPLAY_RESUME_SIG,            /**< Carry on after a failed request >*/
+};
+
+static sim_replay_t l_sim_replay;
+
+static QEvt const * sim_replay_que_sto[SIM_REPLAY_QUEUE_SIZE];
+
+// state functions
+static QState sim_replay_initial    (sim_replay_t * const me, QEvt const * const e);
+static QState sim_replay_active     (sim_replay_t * const me, QEvt const * const e);
+
+// Private functions
+static void sim_replay_schedule_next(sim_replay_t * const me);
+
+static void sim_replay_due(void * arg);
+
+static void sim_replay_issue(sim_replay_t * const me);
+
+static void sim_replay_answered(sim_replay_t * const me, bool ok);
+
+
+/************************************************************************************/
+/***    START OF HSM                                                              ***/
+/************************************************************************************/
+
+/**
+*   @brief      Initial state as required by QP
+*/
+static QState sim_replay_initial(sim_replay_t * const me, QEvt const * const e)
+{
+    (void)e;    // avoid compiler warning
+
+    QS_OBJ_DICTIONARY(me);
+    QS_FUN_DICTIONARY(&sim_replay_initial);
+    QS_FUN_DICTIONARY(&sim_replay_active);
+
+    QActive_subscribe(&me->super, DEVICE_LEVEL_READY_REPORT_SIG);
+    QActive_subscribe(&me->super, DEVICE_LEVEL_ERROR_REPORT_SIG);
+
+    return Q_TRAN(&sim_replay_active);
+}
+
+/**
+*   @brief      Feed the capture to device_level and collect the answers
+*/
+static QState sim_replay_active(sim_replay_t * const me, QEvt const * const e)
+{
+    QState status = Q_SUPER(&QHsm_top);
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        {
+            me->start = sim_now();
+
+            static QEvt const enable_evt = {DEVICE_LEVEL_ENABLE_SIG, 0u, 0u};
+            QACTIVE_POST(g_ao_device_level, &enable_evt, me);
+
+            sim_replay_schedule_next(me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_SIM_REPLAY_DUE_SIG:
+        {
+            me->items[me->next_due].due = sim_now();
+            me->next_due++;
+
+            sim_replay_schedule_next(me);
+            sim_replay_issue(me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_READY_REPORT_SIG:
+        {
+            me->ready = true;
+            sim_replay_issue(me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_RESPONSE_SIG:
+        {
+            device_level_response_event_t * p_evt = (device_level_response_event_t *)e;
+
+            if (me->in_flight && Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->request_id))
+            {
+                sim_replay_answered(me, true);
+                sim_replay_issue(me);
+            }
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_ERROR_RESPONSE_SIG:
+        {
+            device_level_error_response_event_t * p_evt = (device_level_error_response_event_t *)e;
+
+            if (me->in_flight && Q_DOES_REPLYABLE_RESPONSE_REQUEST_ID_MATCH(p_evt, me->request_id))
+            {
+                sim_replay_answered(me, false);
+
+                // An error report may be queued behind this one, check for it first
+                static QEvt const resume_evt = {LOCAL_SIM_REPLAY_RESUME_SIG, 0u, 0u};
+                QACTIVE_POST(&me->super, &resume_evt, me);
+            }
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        case LOCAL_SIM_REPLAY_RESUME_SIG:
+        {
+            sim_replay_issue(me);
+            status = Q_HANDLED();
+            break;
+        }
+
+        case DEVICE_LEVEL_ERROR_REPORT_SIG:
+        {
+            // Act as the supervisor and restart the driver
+            me->ready = false;
+            me->recoveries++;
+
+            if (me->in_flight)
+            {
+                sim_replay_answered(me, false);
+            }
+
+            static QEvt const enable_evt = {DEVICE_LEVEL_ENABLE_SIG, 0u, 0u};
+            QACTIVE_POST(g_ao_device_level, &enable_evt, me);
+
+            status = Q_HANDLED();
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+/************************************************************************************/
+/***    END OF HSM                                                                ***/
+/************************************************************************************/
+
+/**
+*   @brief      Arm the scheduler for the next item to fall due
+*/
+static void sim_replay_schedule_next(sim_replay_t * const me)
+{
+    if (me->next_due >= me->n_items)
+    {
+        return;
+    }
+
+    sim_time_t at = me->start;
+
+    if (me->speed_percent != SIM_REPLAY_SPEED_BACK_TO_BACK)
+    {
+        at += (me->items[me->next_due].offset * SIM_REPLAY_SPEED_ORIGINAL) / me->speed_percent;
+    }
+
+    Q_ALLEGE(sim_schedule_at(at, &sim_replay_due, me));
+}
+
+/**
+*   @brief      Scheduler callback: hand the due item to the AO
+*/
+static void sim_replay_due(void * arg)
+{
+    sim_replay_t * const me = (sim_replay_t *)arg;
+
+    static QEvt const due_evt = {LOCAL_SIM_REPLAY_DUE_SIG, 0u, 0u};
+    QACTIVE_POST(&me->super, &due_evt, (void *)0);
+}
+
+/**
+*   @brief      Send the oldest due item to device_level, if it can take it
+*/
+static void sim_replay_issue(sim_replay_t * const me)
+{
+    if (!me->ready || me->in_flight || (me->next_issue >= me->next_due))
+    {
+        return;
+    }
+
+    sim_replay_item_t const * const item = &me->items[me->next_issue];
+    uint16_t length = (item->length <= SIM_REPLAY_BUFFER_SIZE) ? item->length : SIM_REPLAY_BUFFER_SIZE;
+
+    me->request_id++;
+    me->in_flight = true;
+
+    if ((i2c_ops_t)item->operation == I2C_READ)
+    {
+        device_level_read_request_event_t * req = Q_NEW(device_level_read_request_event_t, DEVICE_LEVEL_READ_SIG);
+        req->buffer.address = item->reg;
+        req->buffer.p_data  = me->buffer;
+        req->buffer.length  = length;
+        QACTIVE_POST_REPLYABLE_REQUEST(g_ao_device_level, me->request_id, req, me);
+    }
+    else
+    {
+        device_level_write_request_event_t * req = Q_NEW(device_level_write_request_event_t, DEVICE_LEVEL_WRITE_SIG);
+        req->buffer.address = item->reg;
+        req->buffer.p_data  = me->buffer;
+        req->buffer.length  = length;
+        QACTIVE_POST_REPLYABLE_REQUEST(g_ao_device_level, me->request_id, req, me);
+    }
+}
+
+/**
+*   @brief      Close the outstanding request
+*/
+static void sim_replay_answered(sim_replay_t * const me, bool ok)
+{
+    sim_replay_item_t const * const item = &me->items[me->next_issue];
+
+    if (ok)
+    {
+        me->latencies[me->completed++] = sim_now() - item->due;
+    }
+    else
+    {
+        me->failed++;
+    }
+
+    me->in_flight = false;
+    me->end       = sim_now();
+    me->next_issue++;
+}
+
+/**
+*   @brief      Read a capture file into memory
+*   @param[in]  path        - capture file written through an i2c_capture sink
+*   @param[out] capture     - decoded capture, release with sim_replay_free()
+*   @return     bool        - false if the file is missing or not a capture
+*/
+bool sim_replay_load(char const * const path, sim_replay_capture_t * const capture)
+{
+    uint8_t header[I2C_CAPTURE_HEADER_SIZE];
+    uint8_t raw[I2C_CAPTURE_RECORD_SIZE];
+    uint32_t capacity = 1024u;
+
+    memset(capture, 0, sizeof(*capture));
+
+    FILE * const in = fopen(path, "rb");
+    if (in == NULL)
+    {
+        return false;
+    }
+
+    if ((fread(header, 1u, sizeof(header), in) != sizeof(header)) ||
+        !i2c_capture_decode_header(header, &capture->counts_per_ms))
+    {
+        fclose(in);
+        return false;
+    }
+
+    capture->records = malloc(capacity * sizeof(i2c_capture_record_t));
+
+    while ((capture->records != NULL) && (fread(raw, 1u, sizeof(raw), in) == sizeof(raw)))
+    {
+        if (capture->n_records == capacity)
+        {
+            capacity *= 2u;
+            capture->records = realloc(capture->records, capacity * sizeof(i2c_capture_record_t));
+            if (capture->records == NULL)
+            {
+                break;
+            }
+        }
+        i2c_capture_decode(raw, &capture->records[capture->n_records++]);
+    }
+
+    fclose(in);
+
+    return (capture->records != NULL);
+}
+
+/**
+*   @brief      Release a loaded capture
+*/
+void sim_replay_free(sim_replay_capture_t * const capture)
+{
+    free(capture->records);
+    memset(capture, 0, sizeof(*capture));
+}
+
+/**
+*   @brief      Extract the workload and start the replay AO
+*   @details    Call after device_level and the bus model are started.
+*   @param[in]  priority        - unique QP priority, below device_level
+*   @param[in]  capture         - loaded capture, may be freed once this returns
+*   @param[in]  speed_percent   - 100 for original timing, 1000 for ten times faster,
+*                                 SIM_REPLAY_SPEED_BACK_TO_BACK for no gaps
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_replay_start(uint8_t priority, sim_replay_capture_t const * const capture, uint32_t speed_percent)
+{
+    sim_replay_t * const me = &l_sim_replay;
+    sim_time_t           offset  = 0u;
+    uint32_t             prev_ts = 0u;
+
+    free(me->items);
+    free(me->latencies);
+    memset(me, 0, sizeof(*me));
+
+    me->speed_percent = speed_percent;
+    me->items         = calloc((capture->n_records > 0u) ? capture->n_records : 1u, sizeof(sim_replay_item_t));
+    Q_ASSERT(me->items != NULL);
+
+    // device_level serves one transaction at a time, so every answer belongs
+    // to the latest request. Retries repeat the seq of the request.
+    for (uint32_t i = 0u; i < capture->n_records; i++)
+    {
+        i2c_capture_record_t const * const rec = &capture->records[i];
+        sim_replay_item_t * const last = (me->n_items > 0u) ? &me->items[me->n_items - 1u] : NULL;
+
+        if (i > 0u)
+        {
+            offset += ((sim_time_t)(uint32_t)(rec->timestamp - prev_ts) * SIM_US_PER_MS) / capture->counts_per_ms;
+        }
+        prev_ts = rec->timestamp;
+
+        switch (rec->type)
+        {
+            case I2C_CAPTURE_REQUEST:
+            {
+                if ((last == NULL) || (last->seq != rec->seq))
+                {
+                    sim_replay_item_t * const item = &me->items[me->n_items++];
+
+                    item->offset    = offset;
+                    item->seq       = rec->seq;
+                    item->operation = rec->operation;
+                    item->reg       = rec->reg;
+                    item->length    = rec->length;
+                }
+                break;
+            }
+
+            case I2C_CAPTURE_COMPLETE:
+            case I2C_CAPTURE_ERROR:
+            {
+                if ((last != NULL) && (last->seq == rec->seq))
+                {
+                    last->recorded_latency  = offset - last->offset;
+                    last->recorded_answered = true;
+                    me->recorded_span       = offset;
+                }
+                break;
+            }
+
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    me->latencies = calloc((me->n_items > 0u) ? me->n_items : 1u, sizeof(sim_time_t));
+    Q_ASSERT(me->latencies != NULL);
+
+    QActive_ctor(&me->super, (QStateHandler)&sim_replay_initial);
+
+    QACTIVE_START(&me->super,
+                  priority,
+                  sim_replay_que_sto,
+                  Q_DIM(sim_replay_que_sto),
+                  (void *)0,
+                  0U,
+                  (QEvt *)0);
+}
+
+/**
+*   @brief      True once every request in the capture has been answered
+*/
+bool sim_replay_is_done(void)
+{
+    return (l_sim_replay.next_issue >= l_sim_replay.n_items) && !l_sim_replay.in_flight;
+}
+
+/**
+*   @brief      Compare the replay with the capture
+*   @param[out] report      - recorded and replayed latency and throughput
+*/
+void sim_replay_get_report(sim_replay_report_t * const report)
+{
+    sim_replay_t * const me = &l_sim_replay;
+    sim_time_t * recorded = calloc((me->n_items > 0u) ? me->n_items : 1u, sizeof(sim_time_t));
+    uint32_t n_recorded = 0u;
+
+    Q_ASSERT(recorded != NULL);
+
+    memset(report, 0, sizeof(*report));
+    report->requests   = me->n_items;
+    report->completed  = me->completed;
+    report->failed     = me->failed;
+    report->recoveries = me->recoveries;
+
+    for (uint32_t i = 0u; i < me->n_items; i++)
+    {
+        if (me->items[i].recorded_answered)
+        {
+            recorded[n_recorded++] = me->items[i].recorded_latency;
+        }
+    }
+
+    sim_latency_summarize(recorded, n_recorded, &report->recorded);
+    sim_latency_summarize(me->latencies, me->completed, &report->replayed);
+
+    if (me->recorded_span > 0u)
+    {
+        report->recorded_tps = ((double)n_recorded * SIM_US_PER_SEC) / (double)me->recorded_span;
+    }
+    if (me->end > me->start)
+    {
+        report->replayed_tps = ((double)me->completed * SIM_US_PER_SEC) / (double)(me->end - me->start);
+    }
+
+    free(recorded);
+}
+
+/**
+*   @brief      Print a report with the replayed change against the capture
+*/
+void sim_replay_print_report(sim_replay_report_t const * const report, FILE * const out)
+{
+    sim_latency_t const * const rec = &report->recorded;
+    sim_latency_t const * const rep = &report->replayed;
+
+    fprintf(out, "requests %u, completed %u, failed %u, recoveries %u\n",
+            report->requests, report->completed, report->failed, report->recoveries);
+    fprintf(out, "%-10s %10s %10s %10s\n", "", "recorded", "replayed", "delta");
+    fprintf(out, "%-10s %10u %10u %+10lld\n", "answered", rec->n, rep->n,
+            (long long)rep->n - (long long)rec->n);
+    fprintf(out, "%-10s %10llu %10llu %+10lld\n", "mean us", (unsigned long long)rec->mean,
+            (unsigned long long)rep->mean, (long long)rep->mean - (long long)rec->mean);
+    fprintf(out, "%-10s %10llu %10llu %+10lld\n", "p50 us", (unsigned long long)rec->p50,
+            (unsigned long long)rep->p50, (long long)rep->p50 - (long long)rec->p50);
+    fprintf(out, "%-10s %10llu %10llu %+10lld\n", "p99 us", (unsigned long long)rec->p99,
+            (unsigned long long)rep->p99, (long long)rep->p99 - (long long)rec->p99);
+    fprintf(out, "%-10s %10llu %10llu %+10lld\n", "max us", (unsigned long long)rec->max,
+            (unsigned long long)rep->max, (long long)rep->max - (long long)rec->max);
+    fprintf(out, "%-10s %10.1f %10.1f %+10.1f\n", "txn/s", report->recorded_tps,
+            report->replayed_tps, report->replayed_tps - report->recorded_tps);
+}
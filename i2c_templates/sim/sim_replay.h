@@ -0,0 +1,75 @@
+/**
+ * @file        sim_replay.h
+ * @brief       Replay an I2C capture against device_level on the simulated bus
+ * @details     The replay AO plays the part of the upper layer driver: it turns
+ *              every captured request into a DEVICE_LEVEL_READ_SIG or
+ *              DEVICE_LEVEL_WRITE_SIG at its original time, divided by the speed
+ *              factor. Requests that fall due while device_level is busy wait in
+ *              arrival order, the same way api_level would defer them. It also acts
+ *              as the supervisor, re-enabling device_level after an error report.
+ *
+ *              Latency is measured from the time a request falls due to its
+ *              response. It is compared with the latency recorded in the capture
+ *              (first REQUEST to last COMPLETE/ERROR of the same seq).
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_REPLAY_H
+#define SIM_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "i2c_capture.h"
+#include "sim.h"
+
+// Replay with the original timing
+#define SIM_REPLAY_SPEED_ORIGINAL       100u
+
+// Issue each request as soon as the previous one is answered
+#define SIM_REPLAY_SPEED_BACK_TO_BACK   0u
+
+/*! @struct sim_replay_capture_t
+*   @brief  A capture loaded into memory
+*/
+typedef struct
+{
+    uint32_t                counts_per_ms;                      /**< Timestamp resolution >*/
+    uint32_t                n_records;                          /**< Number of records >*/
+    i2c_capture_record_t *  records;                            /**< Decoded records >*/
+} sim_replay_capture_t;
+
+/*! @struct sim_replay_report_t
+*   @brief  Recorded versus replayed behaviour
+*/
+typedef struct
+{
+    uint32_t                requests;                           /**< Requests in the capture >*/
+    uint32_t                completed;                          /**< Requests answered during replay >*/
+    uint32_t                failed;                             /**< Requests that ended in an error >*/
+    uint32_t                recoveries;                         /**< Times device_level was re-enabled >*/
+    sim_latency_t           recorded;                           /**< Latency in the capture >*/
+    sim_latency_t           replayed;                           /**< Latency during replay >*/
+    double                  recorded_tps;                       /**< Transactions per second in the capture >*/
+    double                  replayed_tps;                       /**< Transactions per second during replay >*/
+} sim_replay_report_t;
+
+bool sim_replay_load(char const * const path, sim_replay_capture_t * const capture);
+
+void sim_replay_free(sim_replay_capture_t * const capture);
+
+void sim_replay_start(uint8_t priority, sim_replay_capture_t const * const capture, uint32_t speed_percent);
+
+bool sim_replay_is_done(void);
+
+void sim_replay_get_report(sim_replay_report_t * const report);
+
+void sim_replay_print_report(sim_replay_report_t const * const report, FILE * const out);
+
+#endif
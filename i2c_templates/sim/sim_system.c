@@ -0,0 +1,81 @@
+/**
+ * @file        sim_system.c
+ * @brief       Host bring-up of QF, the bus model and device_level
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "qpc.h"
+#include "common.h"
+#include "events.h"
+#include "signals.h"
+#include "whoop_i2c.h"
+#include "device_level.h"
+#ifdef DEVICE_LEVEL_COMPONENT
+#include "api_level.h"
+#endif
+
+#include "sim.h"
+#include "sim_i2c_bus.h"
+#include "sim_system.h"
+
+/**
+    @brief Any dynamic event used on the host
+    Sizes the single event pool.
+*/
+typedef union
+{
+    i2c_comm_req_event_t                i2c_req;
+    i2c_comm_cmpt_event_t               i2c_cmpt;
+    i2c_comm_error_event_t              i2c_error;
+    i2c_comm_status_event_t             i2c_status;
+    device_level_read_request_event_t   read_req;
+    device_level_write_request_event_t  write_req;
+    device_level_response_event_t       response;
+    device_level_error_response_event_t error_response;
+    ao_error_agg_event_t                error;
+#ifdef DEVICE_LEVEL_SCHEDULE
+    device_level_sample_event_t         sample;
+    device_level_jitter_report_event_t  jitter;
+#endif
+} sim_system_evt_t;
+
+static QSubscrList l_sim_system_subscr_sto[MAX_SIG];
+
+static QF_MPOOL_EL(sim_system_evt_t) l_sim_system_pool_sto[SIM_SYSTEM_POOL_EVENTS];
+
+/**
+*   @brief      Set up a fresh system and start the bus model and device_level
+*   @details    device_level is left disabled; the client enables it. With
+*               DEVICE_LEVEL_COMPONENT, api_level is started to host it. With
+*               DRIVER_TIMER_WHEEL, the AO ticking the wheel starts first.
+*   @param[in]  seed        - random seed for the run
+*   @param[in]  bus_config  - bus model parameters, NULL for the defaults
+*   @param[out] nothing
+*   @return     nothing
+*/
+void sim_system_start(uint64_t seed, sim_i2c_bus_config_t const * const bus_config)
+{
+    sim_init(seed);
+
+    QF_init();
+    QF_psInit(l_sim_system_subscr_sto, Q_DIM(l_sim_system_subscr_sto));
+    QF_poolInit(l_sim_system_pool_sto, sizeof(l_sim_system_pool_sto), sizeof(l_sim_system_pool_sto[0]));
+
+#ifdef DRIVER_TIMER_WHEEL
+    // The drivers arm their timers from their initial transitions on
+    ao_timer_wheel_start(SIM_TIMER_WHEEL_PRIORITY);
+#endif
+
+    // device_level subscribes to the bus status first, so it sees the bus come up
+#ifndef DEVICE_LEVEL_COMPONENT
+    device_level_start();
+#else
+    api_level_start();
+#endif
+    sim_i2c_bus_start(SIM_I2C_BUS_PRIORITY, bus_config);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file        sim_system.h
+ * @brief       Host bring-up of QF, the bus model and device_level
+ * @details     One call sets up a fresh simulated system: the virtual clock, QF
+ *              with its event pool and publish-subscribe table, the bus model and
+ *              device_level, and with DRIVER_TIMER_WHEEL the AO that ticks the
+ *              timing wheel. The client AO driving device_level (replay, load
+ *              generator, ...) is started by the caller afterwards, at
+ *              SIM_CLIENT_PRIORITY.
+ *
+ *              QF cannot be torn down, so a process runs one system. Programs that
+ *              run several scenarios fork a child per scenario.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_SYSTEM_H
+#define SIM_SYSTEM_H
+
+#include <stdint.h>
+
+#include "sim.h"
+#include "sim_i2c_bus.h"
+
+// The bus model must run above the drivers
+#ifndef SIM_I2C_BUS_PRIORITY
+#ifdef DEVICE_LEVEL_COMPONENT
+#define SIM_I2C_BUS_PRIORITY            (API_LEVEL_PRIORITY + 1u)
+#else
+#define SIM_I2C_BUS_PRIORITY            (DEVICE_LEVEL_PRIORITY + 1u)
+#endif
+#endif
+
+// The timing wheel ticks above everything it times
+#ifndef SIM_TIMER_WHEEL_PRIORITY
+#define SIM_TIMER_WHEEL_PRIORITY        (SIM_I2C_BUS_PRIORITY + 1u)
+#endif
+
+// The client AO must run below the drivers
+#ifndef SIM_CLIENT_PRIORITY
+#define SIM_CLIENT_PRIORITY             1u
+#endif
+
+// Dynamic events available to the system
+#ifndef SIM_SYSTEM_POOL_EVENTS
+#define SIM_SYSTEM_POOL_EVENTS          64u
+#endif
+
+void sim_system_start(uint64_t seed, sim_i2c_bus_config_t const * const bus_config);
+
+#endif
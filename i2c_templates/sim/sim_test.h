@@ -0,0 +1,52 @@
+/**
+ * @file        sim_test.h
+ * @brief       Checks for the host tests of the driver modules
+ * @details     Each sim/test_*.c is a program that links one module of the
+ *              templates, with the same include paths as the sim. A failed check
+ *              prints where it failed and what it saw, the test keeps going, and
+ *              SIM_TEST_RESULT() makes the exit status 1.
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#ifndef SIM_TEST_H
+#define SIM_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Failed checks of the test program
+static uint32_t sim_test_failures;
+
+#define SIM_TEST_CHECK(cond_)                                                               \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(cond_))                                                                       \
+        {                                                                                   \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond_);                              \
+            sim_test_failures++;                                                            \
+        }                                                                                   \
+    } while (0)
+
+#define SIM_TEST_EQUAL(actual_, expected_)                                                  \
+    do                                                                                      \
+    {                                                                                       \
+        long long const actual__   = (long long)(actual_);                                  \
+        long long const expected__ = (long long)(expected_);                                \
+                                                                                            \
+        if (actual__ != expected__)                                                         \
+        {                                                                                   \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual_,      \
+                   actual__, expected__);                                                   \
+            sim_test_failures++;                                                            \
+        }                                                                                   \
+    } while (0)
+
+// Exit status of the test program
+#define SIM_TEST_RESULT()       ((sim_test_failures == 0u) ? 0 : 1)
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file        test_ao_adaptive_timeout.c
+ * @brief       Host test of ao_adaptive_timeout
+ * @details     Feeds overhead distributions with a known 99th percentile bin and
+ *              checks the timeout that follows, the decay of old samples, and the
+ *              order of the clamps: max_ms, then the wire time, then min_ms.
+ *
+ *              Build: cc -I. -Isim sim/test_ao_adaptive_timeout.c ao_adaptive_timeout.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "sim_test.h"
+#include "ao_adaptive_timeout.h"
+
+#define TEST_BUS_HZ             400000u
+#define TEST_MIN_MS             1u
+#define TEST_MAX_MS             50u
+
+// Private functions
+static void test_observe(ao_adaptive_timeout_t * const me, uint32_t wire_us, uint32_t overhead_us, uint32_t n);
+
+static void test_wire_time(void);
+
+static void test_p99_bins(void);
+
+static void test_decay(void);
+
+static void test_clamps(void);
+
+/**
+*   @brief      Add n completions that spent overhead_us on top of the wire time
+*/
+static void test_observe(ao_adaptive_timeout_t * const me, uint32_t wire_us, uint32_t overhead_us, uint32_t n)
+{
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        ao_adaptive_timeout_observe(me, wire_us, wire_us + overhead_us);
+    }
+}
+
+/**
+*   @brief      Bits on the wire, rounded up to whole microseconds
+*/
+static void test_wire_time(void)
+{
+    ao_adaptive_timeout_t me;
+
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+
+    // Address, register, repeated start and address, one data byte, framing: 39 bits
+    SIM_TEST_EQUAL(ao_adaptive_timeout_wire_us(&me, true, 0u, 1u), 98u);
+
+    // Address, register, two data bytes, framing: 38 bits
+    SIM_TEST_EQUAL(ao_adaptive_timeout_wire_us(&me, true, 2u, 0u), 95u);
+
+    // Address and framing only: 11 bits, 27.5 us
+    SIM_TEST_EQUAL(ao_adaptive_timeout_wire_us(&me, false, 0u, 0u), 28u);
+}
+
+/**
+*   @brief      The percentile is the upper bound of its bin, 1% may lie above it
+*/
+static void test_p99_bins(void)
+{
+    ao_adaptive_timeout_t me;
+    uint32_t const wire_us = 95u;
+
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+
+    // Too few samples, the longest timeout
+    test_observe(&me, wire_us, 100u, AO_ADAPTIVE_TIMEOUT_MIN_SAMPLES - 1u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), TEST_MAX_MS);
+
+    // 99 at 100 us, bin [64, 128), and 1 at 5000 us: 2 * (95 + 127) us, rounded up, plus a tick
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+    test_observe(&me, wire_us, 100u, 99u);
+    test_observe(&me, wire_us, 5000u, 1u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), 2u);
+
+    // 2 in 100 at 5000 us, bin [4096, 8192): 2 * (95 + 8191) us
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+    test_observe(&me, wire_us, 100u, 98u);
+    test_observe(&me, wire_us, 5000u, 2u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), 18u);
+
+    // Overheads of 0 and 1 us share bin 0, bound 1 us
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+    test_observe(&me, 400u, 0u, 50u);
+    test_observe(&me, 400u, 1u, 50u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, 400u), 2u);
+
+    // A completion faster than the wire time counts as no overhead
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+    for (uint32_t i = 0u; i < 100u; i++)
+    {
+        ao_adaptive_timeout_observe(&me, 400u, 10u);
+    }
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, 400u), 2u);
+}
+
+/**
+*   @brief      Old slow samples are halved away once the bus is fast again
+*/
+static void test_decay(void)
+{
+    ao_adaptive_timeout_t me;
+    uint32_t const wire_us = 95u;
+
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+
+    test_observe(&me, wire_us, 5000u, AO_ADAPTIVE_TIMEOUT_MIN_SAMPLES);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), 18u);
+
+    // The window never holds more than AO_ADAPTIVE_TIMEOUT_WINDOW samples
+    test_observe(&me, wire_us, 100u, 10u * AO_ADAPTIVE_TIMEOUT_WINDOW);
+    SIM_TEST_CHECK(me.n_samples <= AO_ADAPTIVE_TIMEOUT_WINDOW);
+    SIM_TEST_EQUAL(me.histogram[12], 0u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), 2u);
+}
+
+/**
+*   @brief      max_ms caps the adaptive value, the wire time overrides it, min_ms wins last
+*/
+static void test_clamps(void)
+{
+    ao_adaptive_timeout_t me;
+    uint32_t const wire_us = 95u;
+
+    // Adaptive value of 2 * (95 + 65535) us, capped at max_ms
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, TEST_MAX_MS);
+    test_observe(&me, wire_us, 100000u, 100u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), TEST_MAX_MS);
+
+    // A transfer longer than max_ms on the wire gets its wire time, adapted or not
+    ao_adaptive_timeout_init(&me, 100000u, TEST_MIN_MS, TEST_MAX_MS);
+    uint32_t const long_us = ao_adaptive_timeout_wire_us(&me, true, 0u, 4096u);
+
+    SIM_TEST_EQUAL(long_us, 368940u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, long_us), 739u);
+    test_observe(&me, long_us, 100u, 100u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, long_us), 739u);
+
+    // Within the limits the adaptive value stands: 2 * (20000 + 1) us plus a tick
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, TEST_MIN_MS, 100u);
+    test_observe(&me, 20000u, 0u, 100u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, 20000u), 42u);
+
+    // min_ms applies after the wire time
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, 10u, TEST_MAX_MS);
+    test_observe(&me, wire_us, 100u, 100u);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), 10u);
+
+    // min_ms above max_ms: min_ms, checked last, wins
+    ao_adaptive_timeout_init(&me, TEST_BUS_HZ, 80u, TEST_MAX_MS);
+    SIM_TEST_EQUAL(ao_adaptive_timeout_ms(&me, wire_us), 80u);
+}
+
+int main(void)
+{
+    test_wire_time();
+    test_p99_bins();
+    test_decay();
+    test_clamps();
+
+    return SIM_TEST_RESULT();
+}
@@ -0,0 +1,315 @@
+/**
+ * @file        test_ao_error_agg.c
+ * @brief       Host test of ao_error_agg
+ * @details     Reports error codes on a hand-driven millisecond clock and checks
+ *              what is published: the burst of each window as it happens, the
+ *              rest as one summary once the window has closed, escalated when the
+ *              code storms. Also checks which slots are taken and reused when
+ *              more codes are reported than the aggregator tracks.
+ *
+ *              Build: cc -I. -Isim <QP/C and platform includes>
+ *                     sim/test_ao_error_agg.c ao_error_agg.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "sim_test.h"
+#include "ao_error_agg.h"
+
+#define TEST_CODE               (-20)
+
+// Clock of the test, milliseconds
+static timer_count_t test_now;
+
+// Private functions
+static ao_error_agg_result_t test_add(ao_error_agg_t * const agg, int32_t code, whoop_error_severity_t severity);
+
+static void test_burst_and_held(void);
+
+static void test_window_close(void);
+
+static void test_escalation(void);
+
+static void test_slot_reuse(void);
+
+static void test_fill(void);
+
+timer_count_t timer_get_count(void)
+{
+    return test_now;
+}
+
+/**
+*   @brief      Report a code at the current time, the published report is checked
+*/
+static ao_error_agg_result_t test_add(ao_error_agg_t * const agg, int32_t code, whoop_error_severity_t severity)
+{
+    ao_error_agg_report_t report;
+    ao_error_agg_result_t const result = ao_error_agg_add(agg, code, severity, &report);
+
+    if (result == AO_ERROR_AGG_PUBLISH)
+    {
+        SIM_TEST_EQUAL(report.error_code, code);
+        SIM_TEST_EQUAL(report.count, 1u);
+        SIM_TEST_EQUAL(report.first, test_now);
+        SIM_TEST_EQUAL(report.last, test_now);
+    }
+
+    return result;
+}
+
+/**
+*   @brief      The first reports of a window are published, the rest are held for one summary
+*/
+static void test_burst_and_held(void)
+{
+    ao_error_agg_t agg;
+    ao_error_agg_report_t report;
+
+    ao_error_agg_init(&agg);
+    test_now = 5000u;
+
+    for (uint32_t i = 0u; i < AO_ERROR_AGG_BURST; i++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+        test_now += 10u;
+    }
+    SIM_TEST_CHECK(!ao_error_agg_is_pending(&agg));
+
+    // The first held report starts the owner's timer, the next ones do not
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD_FIRST);
+    timer_count_t const first_merged = test_now;
+    test_now += 10u;
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD);
+    test_now += 10u;
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD);
+    timer_count_t const last = test_now;
+    SIM_TEST_CHECK(ao_error_agg_is_pending(&agg));
+
+    // Another code held while the first is pending does not start the timer again
+    for (uint32_t i = 0u; i < AO_ERROR_AGG_BURST; i++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, TEST_CODE - 1, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE - 1, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD);
+
+    SIM_TEST_EQUAL(agg.published, 2u * AO_ERROR_AGG_BURST);
+    SIM_TEST_EQUAL(agg.merged, 4u);
+
+    // Nothing to collect while the windows are open, the last millisecond included
+    test_now = 5000u + AO_ERROR_AGG_WINDOW_MS - 1u;
+    SIM_TEST_CHECK(!ao_error_agg_next_report(&agg, &report));
+
+    test_now = 5000u + AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_code, TEST_CODE);
+    SIM_TEST_EQUAL(report.error_severity, E_S_WHOOP_WARNING);
+    SIM_TEST_EQUAL(report.count, 3u);
+    SIM_TEST_EQUAL(report.first, first_merged);
+    SIM_TEST_EQUAL(report.last, last);
+
+    // The second code's window opened 60 ms later
+    SIM_TEST_CHECK(!ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_CHECK(ao_error_agg_is_pending(&agg));
+
+    test_now += 60u;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_code, TEST_CODE - 1);
+    SIM_TEST_EQUAL(report.count, 1u);
+    SIM_TEST_CHECK(!ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_CHECK(!ao_error_agg_is_pending(&agg));
+
+    SIM_TEST_EQUAL(agg.published, (2u * AO_ERROR_AGG_BURST) + 2u);
+}
+
+/**
+*   @brief      A closed window starts over, also across a wrap of the clock
+*/
+static void test_window_close(void)
+{
+    ao_error_agg_t agg;
+    ao_error_agg_report_t report;
+
+    ao_error_agg_init(&agg);
+    test_now = (timer_count_t)(0u - 300u);
+
+    for (uint32_t i = 0u; i <= AO_ERROR_AGG_BURST; i++)
+    {
+        (void)test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING);
+    }
+
+    // Still the same window on the far side of the wrap
+    test_now = 200u;
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD);
+    SIM_TEST_CHECK(!ao_error_agg_next_report(&agg, &report));
+
+    // Closed but not collected: a new report opens a window of its own
+    test_now = AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.count, 2u);
+    SIM_TEST_EQUAL(report.last, 200u);
+    SIM_TEST_CHECK(!ao_error_agg_next_report(&agg, &report));
+
+    // The new window counts its own burst
+    for (uint32_t i = 1u; i < AO_ERROR_AGG_BURST; i++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD_FIRST);
+
+    // Collected after it closed, the next report is published again
+    test_now += AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.count, 1u);
+    SIM_TEST_EQUAL(test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+}
+
+/**
+*   @brief      A warning storming within one window is summarised as an error
+*/
+static void test_escalation(void)
+{
+    ao_error_agg_t agg;
+    ao_error_agg_report_t report;
+
+    // One report short of escalating
+    ao_error_agg_init(&agg);
+    test_now = 0u;
+    for (uint32_t i = 0u; i < (AO_ERROR_AGG_ESCALATE - 1u); i++)
+    {
+        (void)test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING);
+    }
+    test_now = AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_severity, E_S_WHOOP_WARNING);
+    SIM_TEST_EQUAL(report.count, AO_ERROR_AGG_ESCALATE - 1u - AO_ERROR_AGG_BURST);
+
+    // Escalated, the burst was published as the warning it was
+    ao_error_agg_init(&agg);
+    test_now = 0u;
+    for (uint32_t i = 0u; i < AO_ERROR_AGG_ESCALATE; i++)
+    {
+        ao_error_agg_result_t const result = ao_error_agg_add(&agg, TEST_CODE, E_S_WHOOP_WARNING, &report);
+
+        if (result == AO_ERROR_AGG_PUBLISH)
+        {
+            SIM_TEST_EQUAL(report.error_severity, E_S_WHOOP_WARNING);
+        }
+    }
+    test_now = AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_severity, E_S_WHOOP_ERROR);
+    SIM_TEST_EQUAL(report.count, AO_ERROR_AGG_ESCALATE - AO_ERROR_AGG_BURST);
+
+    // The next window starts as a warning again
+    for (uint32_t i = 0u; i <= AO_ERROR_AGG_BURST; i++)
+    {
+        (void)test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING);
+    }
+    test_now += AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_severity, E_S_WHOOP_WARNING);
+
+    // An error stays an error
+    ao_error_agg_init(&agg);
+    test_now = 0u;
+    for (uint32_t i = 0u; i <= AO_ERROR_AGG_BURST; i++)
+    {
+        (void)test_add(&agg, TEST_CODE, E_S_WHOOP_ERROR);
+    }
+    test_now = AO_ERROR_AGG_WINDOW_MS;
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_severity, E_S_WHOOP_ERROR);
+}
+
+/**
+*   @brief      Codes beyond the slots are published, a slot is free once closed and collected
+*/
+static void test_slot_reuse(void)
+{
+    ao_error_agg_t agg;
+    ao_error_agg_report_t report;
+    int32_t const extra = TEST_CODE - (int32_t)AO_ERROR_AGG_MAX_CODES;
+
+    ao_error_agg_init(&agg);
+    test_now = 100u;
+
+    // The first code holds a summary, the others only their bursts
+    for (uint32_t i = 0u; i <= AO_ERROR_AGG_BURST; i++)
+    {
+        (void)test_add(&agg, TEST_CODE, E_S_WHOOP_WARNING);
+    }
+    for (int32_t code = 1; code < (int32_t)AO_ERROR_AGG_MAX_CODES; code++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, TEST_CODE - code, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+
+    // Every slot open: one more code is never held
+    for (uint32_t i = 0u; i < (2u * AO_ERROR_AGG_BURST); i++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, extra, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+
+    // Closed: the codes without a summary free their slots, the first keeps its one
+    test_now += AO_ERROR_AGG_WINDOW_MS;
+    for (int32_t code = 1; code < (int32_t)AO_ERROR_AGG_MAX_CODES; code++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, extra - code, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+    for (uint32_t i = 0u; i < (2u * AO_ERROR_AGG_BURST); i++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, extra, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+
+    // Collected, the first code's slot takes the extra code
+    SIM_TEST_CHECK(ao_error_agg_next_report(&agg, &report));
+    SIM_TEST_EQUAL(report.error_code, TEST_CODE);
+    SIM_TEST_EQUAL(report.count, 1u);
+    SIM_TEST_CHECK(!ao_error_agg_next_report(&agg, &report));
+
+    for (uint32_t i = 0u; i < AO_ERROR_AGG_BURST; i++)
+    {
+        SIM_TEST_EQUAL(test_add(&agg, extra, E_S_WHOOP_WARNING), AO_ERROR_AGG_PUBLISH);
+    }
+    SIM_TEST_EQUAL(test_add(&agg, extra, E_S_WHOOP_WARNING), AO_ERROR_AGG_HELD_FIRST);
+}
+
+/**
+*   @brief      The event carries the report
+*/
+static void test_fill(void)
+{
+    ao_error_agg_event_t evt;
+    ao_error_agg_report_t const report =
+    {
+        .error_code     = TEST_CODE,
+        .error_severity = E_S_WHOOP_ERROR,
+        .count          = 17u,
+        .first          = 1234u,
+        .last           = 2345u,
+    };
+
+    ao_error_agg_fill(&evt, &report);
+    SIM_TEST_EQUAL(evt.super.error_code, TEST_CODE);
+    SIM_TEST_EQUAL(evt.super.error_severity, E_S_WHOOP_ERROR);
+    SIM_TEST_EQUAL(evt.count, 17u);
+    SIM_TEST_EQUAL(evt.first, 1234u);
+    SIM_TEST_EQUAL(evt.last, 2345u);
+}
+
+int main(void)
+{
+    test_burst_and_held();
+    test_window_close();
+    test_escalation();
+    test_slot_reuse();
+    test_fill();
+
+    return SIM_TEST_RESULT();
+}
@@ -0,0 +1,397 @@
+/**
+ * @file        test_ao_fast_path.c
+ * @brief       Host test of ao_fast_path
+ * @details     Installs tables on a small state hierarchy and dispatches through
+ *              the patched virtual table, recording every entry and exit action
+ *              the step runs. Checks the exit and entry path of transitions to a
+ *              sibling, a cousin, a state in another branch and the source itself,
+ *              the tables that cannot be installed, and that declined events,
+ *              events not in the table and a disabled fast path reach the normal
+ *              dispatch.
+ *
+ *              The state hierarchy, with s21 taking an initial transition:
+ *
+ *                  top
+ *                  +-- s1
+ *                  |   +-- s11
+ *                  |   |   +-- s111
+ *                  |   +-- s12
+ *                  +-- s2
+ *                      +-- s21 -> s211
+ *
+ *              The test stands in for QEP: the normal dispatch only records the
+ *              event, and QHsm_top is defined here.
+ *
+ *              Build: cc -I. -Isim <QP/C includes> sim/test_ao_fast_path.c ao_fast_path.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "sim_test.h"
+#include "ao_fast_path.h"
+
+#define TEST_GO_SIG             (Q_USER_SIG + 0)
+#define TEST_OTHER_SIG          (Q_USER_SIG + 1)
+
+// Room for the actions of one step
+#define TEST_TRACE_SIZE         64u
+
+/*! @struct test_ao_t
+*   @brief  AO under test, with the trace of its last step
+*/
+typedef struct
+{
+    QActive                 super;
+    char                    trace[TEST_TRACE_SIZE];             /**< Actions of the step, in order >*/
+    bool                    accept;                             /**< Whether the table actions take the event >*/
+    uint32_t                normal;                             /**< Events that reached the normal dispatch >*/
+} test_ao_t;
+
+static test_ao_t test_ao;
+
+static ao_fast_path_t test_fast_path;
+
+// Private functions
+static void test_log(char const * const what);
+
+static QState test_state(void * const me, QEvt const * const e, char const * const name, QStateHandler parent);
+
+static QState test_s1(void * const me, QEvt const * const e);
+
+static QState test_s11(void * const me, QEvt const * const e);
+
+static QState test_s111(void * const me, QEvt const * const e);
+
+static QState test_s12(void * const me, QEvt const * const e);
+
+static QState test_s2(void * const me, QEvt const * const e);
+
+static QState test_s21(void * const me, QEvt const * const e);
+
+static QState test_s211(void * const me, QEvt const * const e);
+
+static bool test_action(void * const me, QEvt const * const e);
+
+static void test_normal_dispatch(QHsm * const me, QEvt const * const e, uint_fast8_t const qs_id);
+
+static void test_ctor(QStateHandler state);
+
+static void test_step(QStateHandler from, QSignal sig, char const * const trace, QStateHandler to);
+
+static bool test_install_one(QStateHandler state, QStateHandler target);
+
+static void test_routes(void);
+
+static void test_not_installed(void);
+
+static void test_normal(void);
+
+static void test_reinstall(void);
+
+static QActiveVtable const test_vtable =
+{
+    .super.dispatch = &test_normal_dispatch,
+};
+
+static QEvt const test_go_evt    = {TEST_GO_SIG, 0u, 0u};
+static QEvt const test_other_evt = {TEST_OTHER_SIG, 0u, 0u};
+
+QState QHsm_top(void const * const me, QEvt const * const e)
+{
+    (void)me;
+    (void)e;
+
+    return (QState)Q_RET_IGNORED;
+}
+
+void Q_onAssert(char const * const module, int_t const location)
+{
+    printf("%s:%d: assertion\n", module, (int)location);
+    sim_test_failures++;
+}
+
+/**
+*   @brief      Append to the trace of the step
+*/
+static void test_log(char const * const what)
+{
+    size_t const len = strlen(test_ao.trace);
+
+    snprintf(&test_ao.trace[len], sizeof(test_ao.trace) - len, "%s%s", (len > 0u) ? " " : "", what);
+}
+
+/**
+*   @brief      Common part of the states: log entry and exit, report the superstate
+*/
+static QState test_state(void * const me, QEvt const * const e, char const * const name, QStateHandler parent)
+{
+    char what[16];
+
+    switch (e->sig)
+    {
+        case Q_ENTRY_SIG:
+        case Q_EXIT_SIG:
+        {
+            snprintf(what, sizeof(what), "%s-%s", (e->sig == Q_ENTRY_SIG) ? "in" : "out", name);
+            test_log(what);
+            return Q_HANDLED();
+        }
+        default:
+        {
+            return Q_SUPER(parent);
+        }
+    }
+}
+
+static QState test_s1(void * const me, QEvt const * const e)
+{
+    return test_state(me, e, "s1", Q_STATE_CAST(&QHsm_top));
+}
+
+static QState test_s11(void * const me, QEvt const * const e)
+{
+    return test_state(me, e, "s11", &test_s1);
+}
+
+static QState test_s111(void * const me, QEvt const * const e)
+{
+    return test_state(me, e, "s111", &test_s11);
+}
+
+static QState test_s12(void * const me, QEvt const * const e)
+{
+    return test_state(me, e, "s12", &test_s1);
+}
+
+static QState test_s2(void * const me, QEvt const * const e)
+{
+    return test_state(me, e, "s2", Q_STATE_CAST(&QHsm_top));
+}
+
+static QState test_s21(void * const me, QEvt const * const e)
+{
+    if (e->sig == Q_INIT_SIG)
+    {
+        return Q_TRAN(&test_s211);
+    }
+
+    return test_state(me, e, "s21", &test_s2);
+}
+
+static QState test_s211(void * const me, QEvt const * const e)
+{
+    return test_state(me, e, "s211", &test_s21);
+}
+
+/**
+*   @brief      Action of every table entry, logged before the exits as QEP does
+*/
+static bool test_action(void * const me, QEvt const * const e)
+{
+    (void)me;
+    (void)e;
+
+    if (!test_ao.accept)
+    {
+        return false;
+    }
+
+    test_log("act");
+
+    return true;
+}
+
+/**
+*   @brief      Normal dispatch of the AO, only counts
+*/
+static void test_normal_dispatch(QHsm * const me, QEvt const * const e, uint_fast8_t const qs_id)
+{
+    (void)me;
+    (void)e;
+    (void)qs_id;
+
+    test_ao.normal++;
+}
+
+/**
+*   @brief      Construct the AO afresh in a given state
+*/
+static void test_ctor(QStateHandler state)
+{
+    memset(&test_ao, 0, sizeof(test_ao));
+
+    test_ao.super.super.vptr      = &test_vtable.super;
+    test_ao.super.super.state.fun = state;
+    test_ao.accept                = true;
+}
+
+/**
+*   @brief      Dispatch from a state, then check the actions run and the state reached
+*/
+static void test_step(QStateHandler from, QSignal sig, char const * const trace, QStateHandler to)
+{
+    QEvt const * const e = (sig == TEST_GO_SIG) ? &test_go_evt : &test_other_evt;
+
+    test_ao.super.super.state.fun = from;
+    test_ao.trace[0] = '\0';
+
+    (*test_ao.super.super.vptr->dispatch)(&test_ao.super.super, e, 0u);
+
+    if (strcmp(test_ao.trace, trace) != 0)
+    {
+        printf("%s:%d: trace \"%s\", expected \"%s\"\n", __FILE__, __LINE__, test_ao.trace, trace);
+        sim_test_failures++;
+    }
+    SIM_TEST_CHECK(test_ao.super.super.state.fun == to);
+}
+
+/**
+*   @brief      Install a one entry table on a fresh AO
+*/
+static bool test_install_one(QStateHandler state, QStateHandler target)
+{
+    static ao_fast_path_entry_t table[1];
+
+    table[0] = (ao_fast_path_entry_t){ .state = state, .sig = TEST_GO_SIG, .action = &test_action, .target = target };
+
+    test_ctor(state);
+
+    return ao_fast_path_install(&test_ao.super, &test_fast_path, table, 1u);
+}
+
+/**
+*   @brief      Exits up to the least common ancestor, innermost first, then entries outermost first
+*/
+static void test_routes(void)
+{
+    static ao_fast_path_entry_t const table[] =
+    {
+        { .state = &test_s111, .sig = TEST_GO_SIG,    .action = &test_action, .target = &test_s12   },
+        { .state = &test_s12,  .sig = TEST_GO_SIG,    .action = &test_action, .target = &test_s111  },
+        { .state = &test_s111, .sig = TEST_OTHER_SIG, .action = &test_action, .target = &test_s211  },
+        { .state = &test_s211, .sig = TEST_GO_SIG,    .action = &test_action, .target = NULL        },
+        { .state = &test_s211, .sig = TEST_OTHER_SIG, .action = &test_action, .target = &test_s211  },
+        { .state = &test_s11,  .sig = TEST_GO_SIG,    .action = &test_action, .target = &test_s111  },
+    };
+
+    test_ctor(&test_s111);
+    SIM_TEST_CHECK(ao_fast_path_install(&test_ao.super, &test_fast_path, table, (uint8_t)Q_DIM(table)));
+
+    // Sibling of the source's parent
+    test_step(&test_s111, TEST_GO_SIG, "act out-s111 out-s11 in-s12", &test_s12);
+
+    // Down into the cousin
+    test_step(&test_s12, TEST_GO_SIG, "act out-s12 in-s11 in-s111", &test_s111);
+
+    // Across the top state
+    test_step(&test_s111, TEST_OTHER_SIG, "act out-s111 out-s11 out-s1 in-s2 in-s21 in-s211", &test_s211);
+
+    // Internal transition, then a self transition
+    test_step(&test_s211, TEST_GO_SIG, "act", &test_s211);
+    test_step(&test_s211, TEST_OTHER_SIG, "act out-s211 in-s211", &test_s211);
+
+    // From a state down to its own substate, the source is not left
+    test_step(&test_s11, TEST_GO_SIG, "act in-s111", &test_s111);
+
+    SIM_TEST_EQUAL(test_fast_path.hits, 6u);
+    SIM_TEST_EQUAL(test_ao.normal, 0u);
+
+    // The route leaves temp as QEP does, on the state reached
+    SIM_TEST_CHECK(test_ao.super.super.temp.fun == &test_s111);
+}
+
+/**
+*   @brief      Tables whose transitions cannot be taken directly are refused
+*/
+static void test_not_installed(void)
+{
+    // Target with an initial transition
+    SIM_TEST_CHECK(!test_install_one(&test_s111, &test_s21));
+
+    // Target an ancestor of the source, which QEP would exit and re-enter
+    SIM_TEST_CHECK(!test_install_one(&test_s111, &test_s1));
+    SIM_TEST_CHECK(!test_install_one(&test_s111, &test_s11));
+
+    // A refused table leaves the AO's dispatch alone
+    SIM_TEST_CHECK(test_ao.super.super.vptr == &test_vtable.super);
+
+    // Too many entries
+    ao_fast_path_entry_t table[AO_FAST_PATH_MAX_ENTRIES + 1u];
+
+    for (uint32_t i = 0u; i < (uint32_t)Q_DIM(table); i++)
+    {
+        table[i] = (ao_fast_path_entry_t){ .state = &test_s12, .sig = TEST_GO_SIG, .action = &test_action, .target = NULL };
+    }
+
+    test_ctor(&test_s12);
+    SIM_TEST_CHECK(!ao_fast_path_install(&test_ao.super, &test_fast_path, table, (uint8_t)Q_DIM(table)));
+    SIM_TEST_CHECK(ao_fast_path_install(&test_ao.super, &test_fast_path, table, AO_FAST_PATH_MAX_ENTRIES));
+}
+
+/**
+*   @brief      Declined, unlisted and disabled steps go to the normal dispatch
+*/
+static void test_normal(void)
+{
+    SIM_TEST_CHECK(test_install_one(&test_s111, &test_s12));
+
+    // Not in the table: another signal, or another state
+    test_step(&test_s111, TEST_OTHER_SIG, "", &test_s111);
+    test_step(&test_s11, TEST_GO_SIG, "", &test_s11);
+    SIM_TEST_EQUAL(test_ao.normal, 2u);
+
+    // Declined by the action, before it did anything
+    test_ao.accept = false;
+    test_step(&test_s111, TEST_GO_SIG, "", &test_s111);
+    SIM_TEST_EQUAL(test_ao.normal, 3u);
+    SIM_TEST_EQUAL(test_fast_path.declined, 1u);
+
+    // Turned off
+    test_ao.accept = true;
+    ao_fast_path_enable(&test_fast_path, false);
+    test_step(&test_s111, TEST_GO_SIG, "", &test_s111);
+    SIM_TEST_EQUAL(test_ao.normal, 4u);
+
+    ao_fast_path_enable(&test_fast_path, true);
+    test_step(&test_s111, TEST_GO_SIG, "act out-s111 out-s11 in-s12", &test_s12);
+    SIM_TEST_EQUAL(test_fast_path.hits, 1u);
+    SIM_TEST_EQUAL(test_ao.normal, 4u);
+}
+
+/**
+*   @brief      An AO constructed and installed again keeps its hook, however often
+*/
+static void test_reinstall(void)
+{
+    for (uint32_t i = 0u; i < 10u; i++)
+    {
+        SIM_TEST_CHECK(test_install_one(&test_s111, &test_s12));
+    }
+
+    // Installed again without a new ctor: the dispatch is not wrapped twice
+    static ao_fast_path_entry_t const table[] =
+    {
+        { .state = &test_s111, .sig = TEST_GO_SIG, .action = &test_action, .target = &test_s12 },
+    };
+
+    SIM_TEST_CHECK(ao_fast_path_install(&test_ao.super, &test_fast_path, table, 1u));
+    test_step(&test_s111, TEST_OTHER_SIG, "", &test_s111);
+    SIM_TEST_EQUAL(test_ao.normal, 1u);
+    test_step(&test_s111, TEST_GO_SIG, "act out-s111 out-s11 in-s12", &test_s12);
+}
+
+int main(void)
+{
+    test_routes();
+    test_not_installed();
+    test_normal();
+    test_reinstall();
+
+    return SIM_TEST_RESULT();
+}
@@ -0,0 +1,198 @@
+/**
+ * @file        test_ao_jitter.c
+ * @brief       Host test of ao_jitter
+ * @details     Feeds deviation distributions with a known 99th percentile bin and
+ *              checks the reported bound, then the signed deviation across a wrap
+ *              of the clock and the other statistics of the report. The clock is
+ *              a 32 kHz one, so that counts and microseconds differ.
+ *
+ *              Build: cc -I. -Isim <QP/C and platform includes> -DAO_CLOCK_COUNTS_PER_MS=32
+ *                     sim/test_ao_jitter.c ao_jitter.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "sim_test.h"
+#include "ao_jitter.h"
+
+// Private functions
+static void test_observe(ao_jitter_t * const me, int32_t deviation_us, uint32_t n);
+
+static uint32_t test_p99(ao_jitter_t const * const me);
+
+static void test_p99_bins(void);
+
+static void test_deviation(void);
+
+static void test_report(void);
+
+timer_count_t timer_get_count(void)
+{
+    return 0u;
+}
+
+/**
+*   @brief      Add n samples of one deviation
+*/
+static void test_observe(ao_jitter_t * const me, int32_t deviation_us, uint32_t n)
+{
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        ao_jitter_observe(me, deviation_us);
+    }
+}
+
+/**
+*   @brief      99th percentile bound of a tracker
+*/
+static uint32_t test_p99(ao_jitter_t const * const me)
+{
+    ao_jitter_report_t report;
+
+    ao_jitter_get_report(me, &report);
+
+    return report.p99_us;
+}
+
+/**
+*   @brief      The percentile is the upper bound of its bin, 1% may lie above it
+*/
+static void test_p99_bins(void)
+{
+    ao_jitter_t me;
+
+    // No samples, nothing to bound
+    ao_jitter_init(&me);
+    SIM_TEST_EQUAL(test_p99(&me), 0u);
+
+    // All on time: bin 0
+    ao_jitter_init(&me);
+    test_observe(&me, 0, 100u);
+    SIM_TEST_EQUAL(test_p99(&me), 0u);
+
+    // Bin n holds [2^(n-1), 2^n): 1 us is bin 1, bound 1 us; 5 us is bin 3, bound 7 us
+    ao_jitter_init(&me);
+    test_observe(&me, 1, 100u);
+    SIM_TEST_EQUAL(test_p99(&me), 1u);
+
+    ao_jitter_init(&me);
+    test_observe(&me, 5, 100u);
+    SIM_TEST_EQUAL(test_p99(&me), 7u);
+
+    // The edges of a bin share its bound: 64 and 127 us, bin 7
+    ao_jitter_init(&me);
+    test_observe(&me, 64, 50u);
+    test_observe(&me, 127, 50u);
+    SIM_TEST_EQUAL(test_p99(&me), 127u);
+
+    // 99 at 40 us, bin [32, 64), and 1 at 3000 us: the outlier is the 1% above
+    ao_jitter_init(&me);
+    test_observe(&me, 40, 99u);
+    test_observe(&me, 3000, 1u);
+    SIM_TEST_EQUAL(test_p99(&me), 63u);
+
+    // 2 in 100 at 3000 us, bin [2048, 4096)
+    ao_jitter_init(&me);
+    test_observe(&me, 40, 98u);
+    test_observe(&me, 3000, 2u);
+    SIM_TEST_EQUAL(test_p99(&me), 4095u);
+
+    // Early counts as much as late
+    ao_jitter_init(&me);
+    test_observe(&me, 10, 98u);
+    test_observe(&me, -300, 2u);
+    SIM_TEST_EQUAL(test_p99(&me), 511u);
+
+    // Below 100 samples no sample may lie above the percentile
+    ao_jitter_init(&me);
+    test_observe(&me, 10, 98u);
+    test_observe(&me, 300, 1u);
+    SIM_TEST_EQUAL(test_p99(&me), 511u);
+
+    // Past the last bin the bound is the largest deviation, early or late
+    ao_jitter_init(&me);
+    test_observe(&me, 1000000, 100u);
+    SIM_TEST_EQUAL(test_p99(&me), 1000000u);
+
+    ao_jitter_init(&me);
+    test_observe(&me, 40, 97u);
+    test_observe(&me, 70000, 1u);
+    test_observe(&me, -90000, 2u);
+    SIM_TEST_EQUAL(test_p99(&me), 90000u);
+
+    // The last bin starts at 2^(AO_JITTER_HIST_BINS - 2)
+    ao_jitter_init(&me);
+    test_observe(&me, 1 << (AO_JITTER_HIST_BINS - 2u), 100u);
+    SIM_TEST_EQUAL(test_p99(&me), 1u << (AO_JITTER_HIST_BINS - 2u));
+}
+
+/**
+*   @brief      Signed deviation, late when positive, the short way round the clock
+*/
+static void test_deviation(void)
+{
+    timer_count_t const top = (timer_count_t)(0u - 1u);
+
+    // 8 counts of 31.25 us
+    SIM_TEST_EQUAL(ao_jitter_deviation_us(10008u, 10000u), 250);
+    SIM_TEST_EQUAL(ao_jitter_deviation_us(10000u, 10008u), -250);
+    SIM_TEST_EQUAL(ao_jitter_deviation_us(10000u, 10000u), 0);
+
+    // Ideal before the wrap, actual after it, and the other way round
+    SIM_TEST_EQUAL(ao_jitter_deviation_us(4u, (timer_count_t)(top - 3u)), 250);
+    SIM_TEST_EQUAL(ao_jitter_deviation_us((timer_count_t)(top - 3u), 4u), -250);
+    SIM_TEST_EQUAL(ao_jitter_deviation_us(0u, top), 31);
+}
+
+/**
+*   @brief      Extremes, last, mean of the absolute values and missed periods
+*/
+static void test_report(void)
+{
+    ao_jitter_t me;
+    ao_jitter_report_t report;
+
+    ao_jitter_init(&me);
+    ao_jitter_observe(&me, 30);
+    ao_jitter_observe(&me, -50);
+    ao_jitter_observe(&me, 10);
+    ao_jitter_miss(&me);
+    ao_jitter_miss(&me);
+
+    ao_jitter_get_report(&me, &report);
+    SIM_TEST_EQUAL(report.n_samples, 3u);
+    SIM_TEST_EQUAL(report.n_missed, 2u);
+    SIM_TEST_EQUAL(report.min_us, -50);
+    SIM_TEST_EQUAL(report.max_us, 30);
+    SIM_TEST_EQUAL(report.last_us, 10);
+    SIM_TEST_EQUAL(report.mean_abs_us, 30u);
+
+    // Only late samples: the minimum is the least late, not 0
+    ao_jitter_init(&me);
+    ao_jitter_observe(&me, 20);
+    ao_jitter_observe(&me, 70);
+    ao_jitter_get_report(&me, &report);
+    SIM_TEST_EQUAL(report.min_us, 20);
+    SIM_TEST_EQUAL(report.max_us, 70);
+
+    // A missed period is not a sample
+    ao_jitter_init(&me);
+    ao_jitter_miss(&me);
+    ao_jitter_get_report(&me, &report);
+    SIM_TEST_EQUAL(report.n_samples, 0u);
+    SIM_TEST_EQUAL(report.mean_abs_us, 0u);
+    SIM_TEST_EQUAL(report.p99_us, 0u);
+}
+
+int main(void)
+{
+    test_p99_bins();
+    test_deviation();
+    test_report();
+
+    return SIM_TEST_RESULT();
+}
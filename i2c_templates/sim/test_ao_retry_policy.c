@@ -0,0 +1,214 @@
+/**
+ * @file        test_ao_retry_policy.c
+ * @brief       Host test of ao_retry_policy
+ * @details     Decides on the errors of one request after another and checks the
+ *              action and delay of each retry: backoff doubling up to its cap, the
+ *              fixed delay of a recovery, giving up once an entry is out of
+ *              retries without touching the retries of the other entries, and the
+ *              budget a request can take with every retry used.
+ *
+ *              Build: cc -I. -Isim <QP/C includes> sim/test_ao_retry_policy.c ao_retry_policy.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "qpc.h"
+#include "sim_test.h"
+#include "ao_retry_policy.h"
+
+#define TEST_E_ARB_LOST         (-1)
+#define TEST_E_BUSY             (-2)
+#define TEST_E_STUCK            (-3)
+#define TEST_E_NO_DEVICE        (-4)
+#define TEST_E_UNLISTED         (-5)
+
+static ao_retry_policy_entry_t const test_table[] =
+{
+    { .hal_error = TEST_E_ARB_LOST,  .action = AO_RETRY_NOW,      .max_retries = 2u, .delay_ms = 0u  },
+    { .hal_error = TEST_E_BUSY,      .action = AO_RETRY_BACKOFF,  .max_retries = 6u, .delay_ms = 5u  },
+    { .hal_error = TEST_E_STUCK,     .action = AO_RETRY_RECOVER,  .max_retries = 2u, .delay_ms = 10u },
+    { .hal_error = TEST_E_NO_DEVICE, .action = AO_RETRY_FAIL,     .max_retries = 3u, .delay_ms = 7u  },
+};
+
+// Private functions
+static ao_retry_action_t test_decide(ao_retry_policy_t * const me, int32_t hal_error, uint32_t expected_delay_ms);
+
+static void test_lookup(void);
+
+static void test_backoff(void);
+
+static void test_give_up(void);
+
+static void test_budget(void);
+
+static void test_table_size(void);
+
+/**
+*   @brief      Decide on an error, checking the delay that comes with it
+*/
+static ao_retry_action_t test_decide(ao_retry_policy_t * const me, int32_t hal_error, uint32_t expected_delay_ms)
+{
+    uint32_t delay_ms = 12345u;
+    ao_retry_action_t const action = ao_retry_policy_decide(me, hal_error, &delay_ms);
+
+    SIM_TEST_EQUAL(delay_ms, expected_delay_ms);
+
+    return action;
+}
+
+/**
+*   @brief      The class of an error, unlisted errors fail, lookups spend no retry
+*/
+static void test_lookup(void)
+{
+    ao_retry_policy_t me;
+
+    ao_retry_policy_init(&me, test_table, (uint8_t)Q_DIM(test_table));
+
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, TEST_E_ARB_LOST), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, TEST_E_BUSY), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, TEST_E_STUCK), AO_RETRY_RECOVER);
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, TEST_E_NO_DEVICE), AO_RETRY_FAIL);
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, TEST_E_UNLISTED), AO_RETRY_FAIL);
+
+    for (uint32_t i = 0u; i < 10u; i++)
+    {
+        (void)ao_retry_policy_lookup(&me, TEST_E_ARB_LOST);
+    }
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_ARB_LOST, 0u), AO_RETRY_NOW);
+
+    // A failing entry has no delay, whatever its table says
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_NO_DEVICE, 0u), AO_RETRY_FAIL);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_UNLISTED, 0u), AO_RETRY_FAIL);
+    SIM_TEST_EQUAL(me.decisions[AO_RETRY_FAIL], 2u);
+}
+
+/**
+*   @brief      Each backoff doubles the delay, up to AO_RETRY_POLICY_MAX_SHIFT doublings
+*/
+static void test_backoff(void)
+{
+    ao_retry_policy_t me;
+
+    ao_retry_policy_init(&me, test_table, (uint8_t)Q_DIM(test_table));
+
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 5u), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 10u), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 20u), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 40u), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 5u << AO_RETRY_POLICY_MAX_SHIFT), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 5u << AO_RETRY_POLICY_MAX_SHIFT), AO_RETRY_BACKOFF);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 0u), AO_RETRY_GIVE_UP);
+
+    // A recovery waits the same every time
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_STUCK, 10u), AO_RETRY_RECOVER);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_STUCK, 10u), AO_RETRY_RECOVER);
+
+    // The next request starts from the first delay again
+    ao_retry_policy_reset(&me);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 5u), AO_RETRY_BACKOFF);
+
+    SIM_TEST_EQUAL(me.decisions[AO_RETRY_BACKOFF], 7u);
+    SIM_TEST_EQUAL(me.decisions[AO_RETRY_RECOVER], 2u);
+    SIM_TEST_EQUAL(me.decisions[AO_RETRY_GIVE_UP], 1u);
+}
+
+/**
+*   @brief      An entry gives up after its retries, the others keep theirs
+*/
+static void test_give_up(void)
+{
+    ao_retry_policy_t me;
+
+    ao_retry_policy_init(&me, test_table, (uint8_t)Q_DIM(test_table));
+
+    // Arbitration lost twice, then out of retries, and it stays so
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_ARB_LOST, 0u), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_ARB_LOST, 0u), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_ARB_LOST, 0u), AO_RETRY_GIVE_UP);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_ARB_LOST, 0u), AO_RETRY_GIVE_UP);
+
+    // The same request then hits a stuck bus: its retries are untouched
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_STUCK, 10u), AO_RETRY_RECOVER);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_STUCK, 10u), AO_RETRY_RECOVER);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_STUCK, 0u), AO_RETRY_GIVE_UP);
+
+    // Reset for the next request clears every entry
+    ao_retry_policy_reset(&me);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_ARB_LOST, 0u), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_STUCK, 10u), AO_RETRY_RECOVER);
+
+    SIM_TEST_EQUAL(me.decisions[AO_RETRY_NOW], 3u);
+    SIM_TEST_EQUAL(me.decisions[AO_RETRY_GIVE_UP], 3u);
+
+    // No retries at all gives up at once
+    static ao_retry_policy_entry_t const none[] =
+    {
+        { .hal_error = TEST_E_BUSY, .action = AO_RETRY_BACKOFF, .max_retries = 0u, .delay_ms = 5u },
+    };
+
+    ao_retry_policy_init(&me, none, (uint8_t)Q_DIM(none));
+    SIM_TEST_EQUAL(test_decide(&me, TEST_E_BUSY, 0u), AO_RETRY_GIVE_UP);
+}
+
+/**
+*   @brief      Every attempt and every delay of every retrying entry, failing entries excluded
+*/
+static void test_budget(void)
+{
+    ao_retry_policy_t me;
+    uint32_t const attempt_ms = 3u;
+
+    ao_retry_policy_init(&me, test_table, (uint8_t)Q_DIM(test_table));
+
+    // First attempt 3, arbitration 2 x 3, busy 6 x 3 + 5 + 10 + 20 + 40 + 80 + 80,
+    // stuck 2 x (3 + 10)
+    SIM_TEST_EQUAL(ao_retry_policy_budget_ms(&me, attempt_ms), 3u + 6u + (18u + 235u) + 26u);
+
+    // Retries spent so far do not change it
+    (void)test_decide(&me, TEST_E_BUSY, 5u);
+    SIM_TEST_EQUAL(ao_retry_policy_budget_ms(&me, attempt_ms), 288u);
+
+    // A table with nothing to retry is the first attempt alone
+    ao_retry_policy_init(&me, &test_table[3], 1u);
+    SIM_TEST_EQUAL(ao_retry_policy_budget_ms(&me, attempt_ms), attempt_ms);
+}
+
+/**
+*   @brief      Entries past AO_RETRY_POLICY_MAX_ENTRIES are never looked up
+*/
+static void test_table_size(void)
+{
+    ao_retry_policy_entry_t table[AO_RETRY_POLICY_MAX_ENTRIES + 1u];
+    ao_retry_policy_t me;
+
+    for (uint32_t i = 0u; i < (uint32_t)Q_DIM(table); i++)
+    {
+        table[i] = (ao_retry_policy_entry_t){ .hal_error = -100 - (int32_t)i, .action = AO_RETRY_NOW, .max_retries = 1u };
+    }
+
+    ao_retry_policy_init(&me, table, (uint8_t)Q_DIM(table));
+    SIM_TEST_EQUAL(me.n_entries, AO_RETRY_POLICY_MAX_ENTRIES);
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, table[AO_RETRY_POLICY_MAX_ENTRIES - 1u].hal_error), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(ao_retry_policy_lookup(&me, table[AO_RETRY_POLICY_MAX_ENTRIES].hal_error), AO_RETRY_FAIL);
+
+    // The last entry has a counter of its own
+    SIM_TEST_EQUAL(test_decide(&me, table[AO_RETRY_POLICY_MAX_ENTRIES - 1u].hal_error, 0u), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(test_decide(&me, table[0].hal_error, 0u), AO_RETRY_NOW);
+    SIM_TEST_EQUAL(test_decide(&me, table[AO_RETRY_POLICY_MAX_ENTRIES - 1u].hal_error, 0u), AO_RETRY_GIVE_UP);
+}
+
+int main(void)
+{
+    test_lookup();
+    test_backoff();
+    test_give_up();
+    test_budget();
+    test_table_size();
+
+    return SIM_TEST_RESULT();
+}
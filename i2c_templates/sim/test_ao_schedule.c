@@ -0,0 +1,233 @@
+/**
+ * @file        test_ao_schedule.c
+ * @brief       Host test of ao_schedule
+ * @details     Releases frames on a hand-driven clock and checks the release and
+ *              dispatch deviations against the ideal times: none for a timer
+ *              armed at any phase of its tick, none across a clock wrap, and a
+ *              late frame that does not shift the frames after it. Also checks the
+ *              walk through the table and the overruns.
+ *
+ *              Build: cc -I. -Isim <QP/C and platform includes> -DAO_CLOCK_COUNTS_PER_MS=1000
+ *                     sim/test_ao_schedule.c ao_schedule.c ao_jitter.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "qpc.h"
+#include "sim_test.h"
+#include "ao_schedule.h"
+
+#define TEST_FRAME_MS           10u
+#define TEST_FRAME_US           (TEST_FRAME_MS * 1000u)
+
+// Clock of the test, microseconds
+static timer_count_t test_now;
+
+static ao_schedule_t test_schedule;
+
+static ao_schedule_batch_t const test_batches[] =
+{
+    { .reads = { { .reg = 0x10u, .length = 6u } }, .n_reads = 1u },
+    { .reads = { { .reg = 0x20u, .length = 2u }, { .reg = 0x30u, .length = 4u } }, .n_reads = 2u },
+};
+
+static uint8_t const test_slots[] = {0u, AO_SCHEDULE_NO_BATCH, 1u};
+
+// Private functions
+static void test_setup(void);
+
+static uint8_t test_release_at(timer_count_t at, bool overrun);
+
+static void test_start_phase(void);
+
+static void test_clock_wrap(void);
+
+static void test_late_frame(void);
+
+static void test_table(void);
+
+timer_count_t timer_get_count(void)
+{
+    return test_now;
+}
+
+/**
+*   @brief      Schedule of the test tables, stopped
+*/
+static void test_setup(void)
+{
+    SIM_TEST_CHECK(ao_schedule_init(&test_schedule, test_slots, (uint8_t)Q_DIM(test_slots),
+                                    test_batches, (uint8_t)Q_DIM(test_batches), TEST_FRAME_MS));
+}
+
+/**
+*   @brief      Release a frame with the clock at a given time
+*/
+static uint8_t test_release_at(timer_count_t at, bool overrun)
+{
+    test_now = at;
+
+    return ao_schedule_release(&test_schedule, overrun);
+}
+
+/**
+*   @brief      Started part way through a tick, the frames that follow are on time
+*/
+static void test_start_phase(void)
+{
+    static timer_count_t const phases_us[] = {0u, 1u, 370u, 999u};
+    ao_schedule_report_t report;
+
+    for (uint32_t p = 0u; p < Q_DIM(phases_us); p++)
+    {
+        test_setup();
+
+        // Armed phases_us into a 1 ms tick, the first expiry is on the tick boundary
+        test_now = 5000000u + phases_us[p];
+        ao_schedule_start(&test_schedule);
+
+        timer_count_t const first = 5000000u + TEST_FRAME_US;
+
+        for (uint32_t frame = 0u; frame < 10u; frame++)
+        {
+            (void)test_release_at(first + (frame * TEST_FRAME_US), false);
+        }
+
+        ao_schedule_get_report(&test_schedule, &report);
+        SIM_TEST_EQUAL(report.n_frames, 10u);
+        SIM_TEST_EQUAL(report.min_us, 0);
+        SIM_TEST_EQUAL(report.max_us, 0);
+        SIM_TEST_EQUAL(report.mean_abs_us, 0u);
+        SIM_TEST_EQUAL(report.p99_us, 0u);
+    }
+
+    // A restart takes a new time base
+    timer_count_t const restart = test_now + 4321u;
+
+    test_now = restart;
+    ao_schedule_start(&test_schedule);
+    (void)test_release_at(restart + TEST_FRAME_US - 321u, false);
+    (void)test_release_at(restart + (2u * TEST_FRAME_US) - 321u, false);
+    ao_schedule_get_report(&test_schedule, &report);
+    SIM_TEST_EQUAL(report.n_frames, 2u);
+    SIM_TEST_EQUAL(report.max_us, 0);
+}
+
+/**
+*   @brief      Frames across the wrap of the clock keep their deviations
+*/
+static void test_clock_wrap(void)
+{
+    ao_schedule_report_t report;
+
+    test_setup();
+
+    test_now = (timer_count_t)(0u - (3u * TEST_FRAME_US) - 123u);
+    ao_schedule_start(&test_schedule);
+
+    timer_count_t at = (timer_count_t)(test_now + TEST_FRAME_US);
+
+    for (uint32_t frame = 0u; frame < 6u; frame++)
+    {
+        (void)test_release_at(at, false);
+        at = (timer_count_t)(at + TEST_FRAME_US);
+    }
+
+    // 20 us early, then 30 us late, on the far side of the wrap
+    (void)test_release_at((timer_count_t)(at - 20u), false);
+    at = (timer_count_t)(at + TEST_FRAME_US);
+    (void)test_release_at((timer_count_t)(at + 30u), false);
+
+    ao_schedule_get_report(&test_schedule, &report);
+    SIM_TEST_CHECK(test_now < TEST_FRAME_US * 10u);
+    SIM_TEST_EQUAL(report.n_frames, 8u);
+    SIM_TEST_EQUAL(report.min_us, -20);
+    SIM_TEST_EQUAL(report.max_us, 30);
+    SIM_TEST_EQUAL(report.last_us, 30);
+}
+
+/**
+*   @brief      A late frame and its dispatch, the next frame is measured from the table
+*/
+static void test_late_frame(void)
+{
+    ao_schedule_report_t report;
+    ao_jitter_report_t jitter;
+
+    test_setup();
+
+    test_now = 1000u;
+    ao_schedule_start(&test_schedule);
+
+    timer_count_t const first = 11000u;
+
+    // Slot 0, batch 0, on time and posted 40 us later
+    SIM_TEST_EQUAL(test_release_at(first, false), 0u);
+    SIM_TEST_EQUAL(ao_schedule_dispatched(&test_schedule, 0u, first + 40u), 40);
+
+    // Slot 1, no batch, 700 us late
+    SIM_TEST_EQUAL(test_release_at(first + TEST_FRAME_US + 700u, false), AO_SCHEDULE_NO_BATCH);
+
+    // Slot 2, batch 1, on time again: the late frame did not move the ideal times
+    SIM_TEST_EQUAL(test_release_at(first + (2u * TEST_FRAME_US), false), 1u);
+    SIM_TEST_EQUAL(ao_schedule_dispatched(&test_schedule, 1u, first + (2u * TEST_FRAME_US) + 5u), 5);
+
+    ao_schedule_get_report(&test_schedule, &report);
+    SIM_TEST_EQUAL(report.last_us, 0);
+    SIM_TEST_EQUAL(report.max_us, 700);
+    SIM_TEST_EQUAL(report.mean_abs_us, 233u);
+
+    SIM_TEST_CHECK(ao_schedule_get_jitter(&test_schedule, 0u, &jitter));
+    SIM_TEST_EQUAL(jitter.n_samples, 1u);
+    SIM_TEST_EQUAL(jitter.max_us, 40);
+    SIM_TEST_CHECK(ao_schedule_get_jitter(&test_schedule, 1u, &jitter));
+    SIM_TEST_EQUAL(jitter.max_us, 5);
+    SIM_TEST_CHECK(!ao_schedule_get_jitter(&test_schedule, 2u, &jitter));
+}
+
+/**
+*   @brief      Slots in order, cycles counted, an overrun skips only its batch
+*/
+static void test_table(void)
+{
+    ao_schedule_report_t report;
+    ao_jitter_report_t jitter;
+    timer_count_t at = 0u;
+
+    test_setup();
+
+    test_now = 0u;
+    ao_schedule_start(&test_schedule);
+
+    for (uint32_t cycle = 0u; cycle < 2u; cycle++)
+    {
+        at += TEST_FRAME_US;
+        SIM_TEST_EQUAL(test_release_at(at, false), 0u);
+        at += TEST_FRAME_US;
+        SIM_TEST_EQUAL(test_release_at(at, true), AO_SCHEDULE_NO_BATCH);
+        at += TEST_FRAME_US;
+        SIM_TEST_EQUAL(test_release_at(at, cycle == 1u), (cycle == 1u) ? AO_SCHEDULE_NO_BATCH : 1u);
+    }
+
+    ao_schedule_get_report(&test_schedule, &report);
+    SIM_TEST_EQUAL(report.n_frames, 6u);
+    SIM_TEST_EQUAL(report.n_cycles, 2u);
+    SIM_TEST_EQUAL(report.n_overruns, 1u);
+
+    SIM_TEST_CHECK(ao_schedule_get_jitter(&test_schedule, 1u, &jitter));
+    SIM_TEST_EQUAL(jitter.n_missed, 1u);
+}
+
+int main(void)
+{
+    test_start_phase();
+    test_clock_wrap();
+    test_late_frame();
+    test_table();
+
+    return SIM_TEST_RESULT();
+}
@@ -0,0 +1,329 @@
+/**
+ * @file        test_ao_timer_wheel.c
+ * @brief       Host test of ao_timer_wheel
+ * @details     Ticks the wheel by hand and checks that every timer expires on
+ *              exactly the tick it was armed for: across the level boundaries, at
+ *              the longest timeout, re-armed before or while it expires, and after
+ *              the wheel has stopped ticking with no timer armed.
+ *
+ *              The test stands in for QF: the timeouts are posted to an AO whose
+ *              post records them, the tick QTimeEvt only counts how often it is
+ *              armed, and the critical section does nothing.
+ *
+ *              Build: cc -I. -Isim <QP/C includes> sim/test_ao_timer_wheel.c ao_timer_wheel.c
+ *
+ * @version     0.1
+ * @date        2026-10-17
+ *
+ * @copyright   Copyright (c) 2026
+ *
+ */
+
+#include "sim_test.h"
+#include "ao_timer_wheel.h"
+
+#define TEST_TIMEOUT_SIG        (Q_USER_SIG + 1)
+#define TEST_TICK_SIG           (Q_USER_SIG + 2)
+
+// Most posts one test records
+#define TEST_MAX_POSTS          8u
+
+// Timeouts posted so far, and the wheel tick of each
+static uint32_t test_n_posts;
+static uint32_t test_post_now[TEST_MAX_POSTS];
+
+// Times the tick QTimeEvt was armed
+static uint32_t test_n_tick_arms;
+
+// Ticks to re-arm test_timer with from its own timeout, 0 for none
+static uint32_t test_rearm_ticks;
+
+static ao_timer_wheel_t test_wheel;
+static ao_timer_wheel_timer_t test_timer;
+
+// Private functions
+static bool test_post(QActive * const me, QEvt const * const e, uint_fast16_t const margin, void const * const sender);
+
+static void test_setup(uint32_t phase);
+
+static uint32_t test_run(uint32_t max_ticks);
+
+static void test_deltas(void);
+
+static void test_clamp(void);
+
+static void test_rearm(void);
+
+static void test_disarm_after_expiry(void);
+
+static void test_stall(void);
+
+static void test_rearm_in_tick(void);
+
+static QActiveVtable const test_vtable =
+{
+    .post = &test_post,
+};
+
+static QActive test_act =
+{
+    .super.vptr = &test_vtable.super,
+};
+
+void QF_enterCriticalSection_(void)
+{
+}
+
+void QF_leaveCriticalSection_(void)
+{
+}
+
+void QTimeEvt_ctorX(QTimeEvt * const me, QActive * const act, enum_t const sig, uint_fast8_t tickRate)
+{
+    (void)tickRate;
+
+    me->super.sig = (QSignal)sig;
+    me->act = act;
+}
+
+void QTimeEvt_armX(QTimeEvt * const me, QTimeEvtCtr const nTicks, QTimeEvtCtr const interval)
+{
+    (void)me;
+    (void)nTicks;
+    (void)interval;
+
+    test_n_tick_arms++;
+}
+
+/**
+*   @brief      Record a timeout, re-arming its timer if asked to
+*/
+static bool test_post(QActive * const me, QEvt const * const e, uint_fast16_t const margin, void const * const sender)
+{
+    (void)me;
+    (void)margin;
+    (void)sender;
+
+    SIM_TEST_EQUAL(e->sig, TEST_TIMEOUT_SIG);
+
+    if (test_n_posts < TEST_MAX_POSTS)
+    {
+        test_post_now[test_n_posts] = test_wheel.now;
+    }
+    test_n_posts++;
+
+    if (test_rearm_ticks != 0u)
+    {
+        ao_timer_wheel_arm(&test_wheel, &test_timer, test_rearm_ticks);
+    }
+
+    return true;
+}
+
+/**
+*   @brief      Fresh wheel, ticked phase times with nothing armed
+*/
+static void test_setup(uint32_t phase)
+{
+    ao_timer_wheel_init(&test_wheel, &test_act, TEST_TICK_SIG);
+    ao_timer_wheel_timer_ctor(&test_timer, &test_act, TEST_TIMEOUT_SIG);
+
+    for (uint32_t i = 0u; i < phase; i++)
+    {
+        ao_timer_wheel_tick(&test_wheel);
+    }
+
+    test_n_posts = 0u;
+    test_n_tick_arms = 0u;
+    test_rearm_ticks = 0u;
+}
+
+/**
+*   @brief      Tick while the wheel asks for ticks, at most max_ticks times
+*   @return     uint32_t    - ticks run
+*/
+static uint32_t test_run(uint32_t max_ticks)
+{
+    uint32_t ticks = 0u;
+
+    while (test_wheel.ticking && (ticks < max_ticks))
+    {
+        ao_timer_wheel_tick(&test_wheel);
+        ticks++;
+    }
+
+    return ticks;
+}
+
+/**
+*   @brief      Timeouts on either side of each level boundary, from several phases
+*/
+static void test_deltas(void)
+{
+    static uint32_t const deltas[] = {1u, 31u, 32u, 33u, 1023u, 1024u, 1025u, AO_TIMER_WHEEL_MAX_TICKS};
+    static uint32_t const phases[] = {0u, 1u, 31u, 1000u, 1057u, 40000u};
+
+    for (uint32_t p = 0u; p < Q_DIM(phases); p++)
+    {
+        for (uint32_t d = 0u; d < Q_DIM(deltas); d++)
+        {
+            test_setup(phases[p]);
+
+            ao_timer_wheel_arm(&test_wheel, &test_timer, deltas[d]);
+            SIM_TEST_EQUAL(test_wheel.n_armed, 1u);
+            SIM_TEST_EQUAL(test_n_tick_arms, 1u);
+
+            SIM_TEST_EQUAL(test_run(2u * AO_TIMER_WHEEL_MAX_TICKS), deltas[d]);
+            SIM_TEST_EQUAL(test_n_posts, 1u);
+            SIM_TEST_EQUAL(test_post_now[0], phases[p] + deltas[d]);
+            SIM_TEST_EQUAL(test_wheel.n_armed, 0u);
+            SIM_TEST_CHECK(!test_timer.armed);
+        }
+    }
+}
+
+/**
+*   @brief      0 ticks is the next tick, longer than the wheel is its longest timeout
+*/
+static void test_clamp(void)
+{
+    test_setup(7u);
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 0u);
+    SIM_TEST_EQUAL(test_run(10u), 1u);
+    SIM_TEST_EQUAL(test_post_now[0], 8u);
+
+    test_setup(7u);
+    ao_timer_wheel_arm(&test_wheel, &test_timer, AO_TIMER_WHEEL_MAX_TICKS + 100u);
+    SIM_TEST_EQUAL(test_run(2u * AO_TIMER_WHEEL_MAX_TICKS), AO_TIMER_WHEEL_MAX_TICKS);
+    SIM_TEST_EQUAL(test_n_posts, 1u);
+}
+
+/**
+*   @brief      Re-arming an armed timer replaces its expiry, sooner or later
+*/
+static void test_rearm(void)
+{
+    // From an upper level down to a nearer slot
+    test_setup(3u);
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 2000u);
+    for (uint32_t i = 0u; i < 50u; i++)
+    {
+        ao_timer_wheel_tick(&test_wheel);
+    }
+    // Still ticking, the tick is not armed again
+    uint32_t const tick_arms = test_n_tick_arms;
+
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 10u);
+    SIM_TEST_EQUAL(test_wheel.n_armed, 1u);
+    SIM_TEST_EQUAL(test_n_tick_arms, tick_arms);
+    (void)test_run(4000u);
+    SIM_TEST_EQUAL(test_n_posts, 1u);
+    SIM_TEST_EQUAL(test_post_now[0], 63u);
+
+    // Pushed back past a cascade, as a lockup timeout restarted on every attempt
+    test_setup(3u);
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 20u);
+    for (uint32_t i = 0u; i < 15u; i++)
+    {
+        ao_timer_wheel_tick(&test_wheel);
+    }
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 1100u);
+    (void)test_run(4000u);
+    SIM_TEST_EQUAL(test_n_posts, 1u);
+    SIM_TEST_EQUAL(test_post_now[0], 1118u);
+    SIM_TEST_EQUAL(test_wheel.n_armed, 0u);
+}
+
+/**
+*   @brief      A timeout already posted cannot be disarmed, and leaves the count alone
+*/
+static void test_disarm_after_expiry(void)
+{
+    test_setup(0u);
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 5u);
+    SIM_TEST_CHECK(ao_timer_wheel_disarm(&test_wheel, &test_timer));
+    SIM_TEST_CHECK(!ao_timer_wheel_disarm(&test_wheel, &test_timer));
+    SIM_TEST_EQUAL(test_wheel.n_armed, 0u);
+
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 5u);
+    (void)test_run(10u);
+    SIM_TEST_EQUAL(test_n_posts, 1u);
+    SIM_TEST_CHECK(!ao_timer_wheel_disarm(&test_wheel, &test_timer));
+    SIM_TEST_EQUAL(test_wheel.n_armed, 0u);
+}
+
+/**
+*   @brief      The wheel stops once empty, its time stands still, and an arm restarts it
+*/
+static void test_stall(void)
+{
+    ao_timer_wheel_timer_t other;
+
+    test_setup(30u);
+    ao_timer_wheel_timer_ctor(&other, &test_act, TEST_TIMEOUT_SIG);
+
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 4u);
+    ao_timer_wheel_arm(&test_wheel, &other, 6u);
+    SIM_TEST_EQUAL(test_n_tick_arms, 1u);
+    SIM_TEST_CHECK(ao_timer_wheel_disarm(&test_wheel, &other));
+
+    // The tick after the last expiry asks for no more ticks
+    SIM_TEST_EQUAL(test_run(100u), 4u);
+    SIM_TEST_CHECK(!test_wheel.ticking);
+    SIM_TEST_EQUAL(test_wheel.now, 34u);
+    SIM_TEST_EQUAL(test_n_tick_arms, 4u);
+
+    // Stopped: however long, the wheel is still at 34, across the slot boundary at 64
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 40u);
+    SIM_TEST_CHECK(test_wheel.ticking);
+    SIM_TEST_EQUAL(test_n_tick_arms, 5u);
+    SIM_TEST_EQUAL(test_run(100u), 40u);
+    SIM_TEST_EQUAL(test_n_posts, 2u);
+    SIM_TEST_EQUAL(test_post_now[1], 74u);
+
+    // A second arm while ticking does not arm the tick again
+    ao_timer_wheel_arm(&test_wheel, &test_timer, 3u);
+    ao_timer_wheel_arm(&test_wheel, &other, 3u);
+    SIM_TEST_EQUAL(test_n_tick_arms, 45u);
+    SIM_TEST_EQUAL(test_run(100u), 3u);
+    SIM_TEST_EQUAL(test_n_posts, 4u);
+    SIM_TEST_EQUAL(test_post_now[3], 77u);
+}
+
+/**
+*   @brief      A timer re-armed by its own timeout, as a periodic poll does
+*/
+static void test_rearm_in_tick(void)
+{
+    static uint32_t const periods[] = {1u, 31u, 32u, 1024u};
+
+    for (uint32_t p = 0u; p < Q_DIM(periods); p++)
+    {
+        test_setup(5u);
+        test_rearm_ticks = periods[p];
+
+        ao_timer_wheel_arm(&test_wheel, &test_timer, periods[p]);
+
+        // Not again in the tick that posted it, then once a period
+        (void)test_run(3u * periods[p]);
+        SIM_TEST_EQUAL(test_n_posts, 3u);
+        for (uint32_t i = 0u; i < 3u; i++)
+        {
+            SIM_TEST_EQUAL(test_post_now[i], 5u + ((i + 1u) * periods[p]));
+        }
+        SIM_TEST_CHECK(test_wheel.ticking);
+        SIM_TEST_EQUAL(test_wheel.n_armed, 1u);
+    }
+}
+
+int main(void)
+{
+    test_deltas();
+    test_clamp();
+    test_rearm();
+    test_disarm_after_expiry();
+    test_stall();
+    test_rearm_in_tick();
+
+    return SIM_TEST_RESULT();
+}
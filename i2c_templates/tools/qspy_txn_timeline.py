@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""
+@file       qspy_txn_timeline.py
+@brief      Rebuild per-transaction timelines from a QSpy text capture
+
+Reads the human readable output of QSpy (e.g. `qspy -c COM3 > capture.txt`)
+and extracts the DRIVER_QS_TXN_* user records emitted by the driver templates
+(see driver_qs_records.h). Records are grouped by (QS id, transaction number)
+into timelines. The script prints latency statistics for each phase and the
+overall throughput. `--csv` additionally writes one row per transaction.
+
+Records appear in the capture either by name, when QS_USR_DICTIONARY() was
+sent, or as USER+NNN otherwise. The USER+NNN offsets are mapped through the
+enum in driver_qs_records.h, read from the header (`--records`, by default
+the one above tools/). DRIVER_QS_RECORDS below is only used when the header
+cannot be read, and must follow the enum.
+"""
+
+import argparse
+import csv
+import os
+import re
+import sys
+from collections import OrderedDict
+
+DEFAULT_RECORDS_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                      os.pardir, "driver_qs_records.h")
+
+# Fallback when driver_qs_records.h cannot be read. Must match its enum,
+# starting at QS_USER
+DRIVER_QS_RECORDS = [
+    "DRIVER_QS_DUTY_CYCLE",
+    "DRIVER_QS_DUTY_CYCLE_HIST",
+    "DRIVER_QS_RTC_PROFILE",
+    "DRIVER_QS_RTC_PROFILE_HIST",
+    "DRIVER_QS_RTC_OVERRUN",
+    "DRIVER_QS_STATE_STATS",
+    "DRIVER_QS_TXN_ACCEPTED",
+    "DRIVER_QS_TXN_QUEUED",
+    "DRIVER_QS_TXN_DISPATCHED",
+    "DRIVER_QS_TXN_COMPLETED",
+    "DRIVER_QS_TXN_FAILED",
+    "DRIVER_QS_TXN_RETRIED",
+    "DRIVER_QS_TXN_TIMED_OUT",
+    "DRIVER_QS_TXN_RESPONDED",
+    "DRIVER_QS_STARTUP_STEP",
+    "DRIVER_QS_SCHEDULE",
+    "DRIVER_QS_JITTER",
+    "DRIVER_QS_JITTER_HIST",
+    "DRIVER_QS_UNHANDLED",
+    "DRIVER_QS_UNHANDLED_TOTAL",
+]
+
+TXN_PREFIX = "DRIVER_QS_TXN_"
+
+# Phases reported as latencies: (name, from event, to event)
+PHASES = [
+    ("queue",    "ACCEPTED",   "DISPATCHED"),
+    ("bus",      "DISPATCHED", "COMPLETED"),
+    ("respond",  "COMPLETED",  "RESPONDED"),
+    ("total",    "ACCEPTED",   "RESPONDED"),
+]
+
+LINE_RE = re.compile(r"^\s*(\d+)\s+(\S+)\s*(.*)$")
+ENUM_RE = re.compile(r"enum\s*\{(.*?)\}", re.S)
+ENUMERATOR_RE = re.compile(r"^\s*(DRIVER_QS_\w+)\s*(=\s*QS_USER\s*)?,", re.M)
+QS_ID_RE = re.compile(r"^(\S+?)(?:\[(\d+)\])?$")
+
+
+class Transaction(object):
+    """Events of one driver transaction, keyed by event name"""
+
+    def __init__(self, qs_id, seq):
+        self.qs_id = qs_id
+        self.seq = seq
+        self.op = None
+        self.reg = None
+        self.length = None
+        self.events = OrderedDict()
+        self.retries = 0
+        self.timeouts = 0
+        self.failed = False
+
+    def add(self, event, op, reg, length, timestamp):
+        self.op, self.reg, self.length = op, reg, length
+        if event == "RETRIED":
+            self.retries += 1
+        elif event == "TIMED_OUT":
+            self.timeouts += 1
+        elif event == "FAILED":
+            self.failed = True
+        # Keep the first occurrence, except for the attempt dependent events
+        if event not in self.events or event in ("DISPATCHED", "COMPLETED"):
+            self.events[event] = timestamp
+
+    def phase(self, start, end):
+        if start in self.events and end in self.events:
+            return (self.events[end] - self.events[start]) & 0xFFFFFFFF
+        return None
+
+
+def load_records(path):
+    """Record names in enum order from driver_qs_records.h, or None if unreadable"""
+    try:
+        with open(path) as f:
+            text = re.sub(r"/\*.*?\*/|//[^\n]*", "", f.read(), flags=re.S)
+    except (IOError, OSError):
+        return None
+    for body in ENUM_RE.findall(text):
+        names = ENUMERATOR_RE.findall(body + ",")
+        if names and names[0][1]:
+            return [name for name, _ in names]
+    return None
+
+
+def record_name(token, user_base, records):
+    """Map a QSpy record token to a driver record name, or None"""
+    if token.startswith("USER+"):
+        offset = int(token[5:]) - user_base
+        if 0 <= offset < len(records):
+            return records[offset]
+        return None
+    return token
+
+
+def parse(stream, user_base, records):
+    txns = OrderedDict()
+    for line in stream:
+        m = LINE_RE.match(line)
+        if not m:
+            continue
+        name = record_name(m.group(2), user_base, records)
+        if name is None or not name.startswith(TXN_PREFIX):
+            continue
+        fields = m.group(3).split()
+        # Optional leading QS id (object name or priority) before the data
+        qs_id = "0"
+        if len(fields) == 7:
+            qs_id = QS_ID_RE.match(fields.pop(0)).group(1)
+        if len(fields) != 6:
+            continue
+        try:
+            seq, _i2c_id, op, reg, length, timestamp = [int(f, 0) for f in fields]
+        except ValueError:
+            continue
+        key = (qs_id, seq)
+        if key not in txns:
+            txns[key] = Transaction(qs_id, seq)
+        txns[key].add(name[len(TXN_PREFIX):], op, reg, length, timestamp)
+    return txns
+
+
+def percentile(values, pct):
+    if not values:
+        return 0
+    values = sorted(values)
+    idx = min(len(values) - 1, int(round((pct / 100.0) * (len(values) - 1))))
+    return values[idx]
+
+
+def report(txns, out, counts_per_ms):
+    out.write("transactions: %d\n" % len(txns))
+    if not txns:
+        return
+
+    completed = [t for t in txns.values() if "RESPONDED" in t.events]
+    out.write("completed:    %d\n" % len(completed))
+    out.write("failed:       %d\n" % sum(1 for t in txns.values() if t.failed))
+    out.write("retries:      %d\n" % sum(t.retries for t in txns.values()))
+    out.write("timeouts:     %d\n" % sum(t.timeouts for t in txns.values()))
+
+    out.write("\n%-8s %8s %10s %10s %10s %10s %10s  (ms)\n" %
+              ("phase", "n", "min", "mean", "p50", "p99", "max"))
+    for name, start, end in PHASES:
+        values = [v for v in (t.phase(start, end) for t in txns.values()) if v is not None]
+        if not values:
+            continue
+        scale = float(counts_per_ms)
+        out.write("%-8s %8d %10.3f %10.3f %10.3f %10.3f %10.3f\n" % (
+            name, len(values),
+            min(values) / scale,
+            sum(values) / scale / len(values),
+            percentile(values, 50) / scale,
+            percentile(values, 99) / scale,
+            max(values) / scale))
+
+    first = min(min(t.events.values()) for t in txns.values())
+    last = max(max(t.events.values()) for t in txns.values())
+    span_s = ((last - first) & 0xFFFFFFFF) / float(counts_per_ms) / 1000.0
+    if span_s > 0:
+        nbytes = sum(t.length or 0 for t in completed)
+        out.write("\nthroughput:   %.1f txn/s, %.1f bytes/s over %.3f s\n" %
+                  (len(completed) / span_s, nbytes / span_s, span_s))
+
+
+def write_csv(txns, path):
+    events = ["ACCEPTED", "QUEUED", "DISPATCHED", "COMPLETED", "FAILED",
+              "TIMED_OUT", "RETRIED", "RESPONDED"]
+    with open(path, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(["qs_id", "seq", "op", "reg", "length", "retries", "timeouts"] +
+                        [e.lower() for e in events])
+        for t in txns.values():
+            writer.writerow([t.qs_id, t.seq, t.op, t.reg, t.length, t.retries, t.timeouts] +
+                            [t.events.get(e, "") for e in events])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[2])
+    parser.add_argument("capture", nargs="?", help="QSpy text output (default: stdin)")
+    parser.add_argument("--csv", help="write per-transaction timelines to this file")
+    parser.add_argument("--counts-per-ms", type=float, default=1.0,
+                        help="AO_CLOCK_COUNTS_PER_MS of the target build (default: 1)")
+    parser.add_argument("--user-base", type=int, default=0,
+                        help="USER+NNN offset of DRIVER_QS_DUTY_CYCLE (default: 0)")
+    parser.add_argument("--records", default=DEFAULT_RECORDS_HEADER,
+                        help="driver_qs_records.h of the target build (default: %(default)s)")
+    args = parser.parse_args()
+
+    records = load_records(args.records)
+    if records is None:
+        sys.stderr.write("cannot read the records from %s, using the built-in list\n" % args.records)
+        records = DRIVER_QS_RECORDS
+
+    stream = open(args.capture) if args.capture else sys.stdin
+    with stream:
+        txns = parse(stream, args.user_base, records)
+
+    report(txns, sys.stdout, args.counts_per_ms)
+    if args.csv:
+        write_csv(txns, args.csv)
+
+
+if __name__ == "__main__":
+    main()